@@ -36,6 +36,7 @@ run_test() {
     local charset="$4"
     local workers="$5"
     local expected_password="$6"
+    local options="$7"      # Opções extras do coordinator (ex.: --threads)
     
     echo -e "\n${YELLOW}[Teste] $test_name${NC}"
     echo "Hash: $hash"
@@ -46,7 +47,7 @@ run_test() {
     rm -f password_found.txt
     
     # Executar com timeout de 30 segundos
-    timeout 30s ./coordinator "$hash" "$length" "$charset" "$workers" > test_output.tmp 2>&1
+    timeout 30s ./coordinator $options "$hash" "$length" "$charset" "$workers" > test_output.tmp 2>&1
     local exit_code=$?
     
     if [ $exit_code -eq 124 ]; then
@@ -192,6 +193,65 @@ run_test "Charset Maior" \
     "4" \
     "hello"
 
+# Teste 6: Charset fora da ordem ASCII (o worker enumera por índices)
+run_test "Charset Fora de Ordem (cba)" \
+    "900150983cd24fb0d6963f7d28e17f72" \
+    "3" \
+    "cba" \
+    "2" \
+    "abc"
+
+# Teste 7: Charset misto fora de ordem, senha no fim do intervalo de um worker
+run_test "Charset Misto (0a9Z)" \
+    "$(./test_hash "Z9a0" | grep "MD5:" | awk '{print $2}')" \
+    "4" \
+    "0a9Z" \
+    "3" \
+    "Z9a0"
+
+# Teste 8: Workers como threads no próprio coordinator
+run_test "Modo Threads (--threads)" \
+    "$(./test_hash "dcba" | grep "MD5:" | awk '{print $2}')" \
+    "4" \
+    "abcd" \
+    "3" \
+    "dcba" \
+    "--threads"
+
+# Teste 9: Faixa de comprimentos (1 a 4) num único espaço combinado
+run_test "Faixa de Comprimentos (--min-len)" \
+    "$(./test_hash "cb" | grep "MD5:" | awk '{print $2}')" \
+    "4" \
+    "abcd" \
+    "3" \
+    "cb" \
+    "--min-len 1"
+
+# Teste 10: Máscara (charset por posição) no lugar de <tamanho> e <charset>
+echo -n "Máscara (--mask): "
+rm -f password_found.txt
+timeout 10s ./coordinator -q -1 "xy" --mask "?u?1-?d" "$(./test_hash "By-7" | grep "MD5:" | awk '{print $2}')" 3 >/dev/null 2>&1
+if grep -q "^[0-9]*:By-7$" password_found.txt 2>/dev/null; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Senha longa num espaço maior que 2^63 (índices de 128 bits), com 0 workers = CPUs online
+echo -n "Espaço de 128 bits (12 caracteres, 62^12): "
+rm -f password_found.txt
+timeout 10s ./coordinator -q "$(./test_hash "aaaaaaaaaa9Z" | grep "MD5:" | awk '{print $2}')" 12 \
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789" 0 >/dev/null 2>&1
+if grep -q "^[0-9]*:aaaaaaaaaa9Z$" password_found.txt 2>/dev/null; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
 # Teste de Performance
 echo -e "\n${YELLOW}[Teste de Performance] Speedup com Múltiplos Workers${NC}"
 echo "Testando se paralelização realmente acelera a busca:"
@@ -224,6 +284,255 @@ else
     TESTS_FAILED=$((TESTS_FAILED + 1))
 fi
 
+echo -n "Vários alvos (--hash-file): "
+rm -f password_found.txt
+printf '%s\n%s\n%s\n' "900150983cd24fb0d6963f7d28e17f72" \
+    "$(./test_hash "cab" | grep "MD5:" | awk '{print $2}')" \
+    "0123456789abcdef0123456789abcdef" > hash_file.tmp
+timeout 10s ./coordinator --hash-file hash_file.tmp "3" "abc" "2" >/dev/null 2>&1
+if [ "$(cut -d':' -f2 password_found.txt 2>/dev/null | sort | tr '\n' ' ')" = "abc cab " ]; then
+    echo -e "${GREEN}✓ As duas senhas encontradas numa passada${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ Esperadas as senhas abc e cab${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+echo -n "Wordlist com regras (--wordlist/--rules): "
+rm -f password_found.txt
+printf 'admin\nsenha\r\ndragao\n' > wordlist.tmp
+printf ':\nc $1 $2 $3\nsa@ so0\n' > rules.tmp
+timeout 10s ./coordinator --wordlist wordlist.tmp --rules rules.tmp \
+    "$(./test_hash "Senha123" | grep "MD5:" | awk '{print $2}')" "2" >/dev/null 2>&1
+if grep -q "^[0-9]*:Senha123$" password_found.txt 2>/dev/null; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Checkpoint: SIGINT grava o progresso; --resume continua de onde parou
+# (o "done" é adiantado para perto da senha, no fim do espaço, para o teste ser rápido)
+echo -n "Checkpoint e retomada (--checkpoint/--resume): "
+rm -f password_found.txt ck.tmp
+CK_HASH="$(./test_hash "zzzzzy" | grep "MD5:" | awk '{print $2}')"
+timeout -s INT --preserve-status 1s ./coordinator --checkpoint ck.tmp \
+    "$CK_HASH" "6" "abcdefghijklmnopqrstuvwxyz" "2" >/dev/null 2>&1
+CK_STATUS=$?
+if [ $CK_STATUS -eq 130 ] && grep -q "^done [0-9]*$" ck.tmp 2>/dev/null; then
+    sed -i 's/^done [0-9]*$/done 308000000/' ck.tmp
+    timeout 10s ./coordinator --resume ck.tmp "$CK_HASH" "6" "abcdefghijklmnopqrstuvwxyz" "2" >/dev/null 2>&1
+fi
+if grep -q "^[0-9]*:zzzzzy$" password_found.txt 2>/dev/null && [ ! -f ck.tmp ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Tabela pré-computada: construída uma vez, consultada sem percorrer o espaço
+echo -n "Tabela pré-computada (--build-table/--table): "
+rm -f password_found.txt table.tmp
+./coordinator --build-table table.tmp "4" "abcdefghij0123456789" "2" >/dev/null 2>&1
+./coordinator --table table.tmp "$(./test_hash "j9a0" | grep "MD5:" | awk '{print $2}')" >/dev/null 2>&1
+if grep -q "^0:j9a0$" password_found.txt 2>/dev/null; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Modo distribuído: dois nós (worker --listen) no localhost
+echo -n "Nós distribuídos (--nodes): "
+rm -f password_found.txt
+NODE_PORT1=$((40000 + $$ % 10000))
+NODE_PORT2=$((NODE_PORT1 + 1))
+./worker --listen $NODE_PORT1 -q >/dev/null 2>&1 &
+NODE_PID1=$!
+./worker --listen $NODE_PORT2 -q >/dev/null 2>&1 &
+NODE_PID2=$!
+sleep 0.5
+timeout 20s ./coordinator --nodes "127.0.0.1:$NODE_PORT1,127.0.0.1:$NODE_PORT2" \
+    "$(./test_hash "hello" | grep "MD5:" | awk '{print $2}')" "5" "ehlo" "1" >/dev/null 2>&1
+kill $NODE_PID1 $NODE_PID2 2>/dev/null
+wait $NODE_PID1 $NODE_PID2 2>/dev/null
+if grep -q "^[0-9]*:hello$" password_found.txt 2>/dev/null; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Daemon com pool aquecido: dois jobs de prioridades diferentes no mesmo pool
+echo -n "Daemon (--daemon/--submit): "
+rm -f password_found.txt daemon.sock
+./coordinator -q --daemon daemon.sock 2 >/dev/null 2>&1 &
+DAEMON_PID=$!
+sleep 0.5
+timeout 20s ./coordinator -q --no-result-file --submit daemon.sock \
+    "$(./test_hash "zzzzz" | grep "MD5:" | awk '{print $2}')" "5" "xyz" "0" > test_output.tmp 2>&1 &
+timeout 20s ./coordinator --submit daemon.sock --priority 1 \
+    "$(./test_hash "hello" | grep "MD5:" | awk '{print $2}')" "5" "ehlo" "1" >/dev/null 2>&1
+wait $!
+if grep -q "^[0-9]*:hello$" password_found.txt 2>/dev/null && grep -q "Senha: zzzzz" test_output.tmp && \
+   ! ./coordinator --submit daemon.sock --cancel 99 >/dev/null 2>&1; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+kill $DAEMON_PID 2>/dev/null
+wait $DAEMON_PID 2>/dev/null
+rm -f daemon.sock
+
+# Benchmark curto: JSON com as três seções
+echo -n "Benchmark (--quick): "
+if make -s benchmark >/dev/null 2>&1 && \
+   timeout 60s ./benchmark --quick --max-workers 2 > bench.tmp 2>/dev/null && \
+   grep -q '"kernels"' bench.tmp && grep -q '"efficiency"' bench.tmp && grep -q '"fork_exec_worker_us"' bench.tmp; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f bench.tmp
+
+# Trace Chrome: fases do coordinator e chunks dos workers num único JSON
+echo -n "Trace de eventos (--trace): "
+rm -f trace.tmp trace.tmp.*.part
+./coordinator --trace trace.tmp "$(./test_hash "dcb" | grep "MD5:" | awk '{print $2}')" "3" "abcd" "2" >/dev/null 2>&1
+if grep -q '"traceEvents"' trace.tmp 2>/dev/null && grep -q '"name": "chunk"' trace.tmp && \
+   grep -q '"name": "fork"' trace.tmp && tail -n 1 trace.tmp | grep -q '^]}$' && \
+   ! ls trace.tmp.*.part >/dev/null 2>&1; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f trace.tmp
+
+# Ordem Markov: o modelo treinado numa wordlist põe "Zz9" bem no começo do
+# espaço, e a ordem continua cobrindo todos os candidatos (todos os 12 hashes
+# de "abc" com comprimento 1 e 2 encontrados)
+echo -n "Ordem Markov (--train-markov/--markov): "
+printf 'Zz9\nZy9\nYz8\n' > wordlist.tmp
+rm -f hash_file.tmp
+for p in a b c aa ab ac ba bb bc ca cb cc; do
+    ./test_hash "$p" | grep "MD5:" | awk '{print $2}' >> hash_file.tmp
+done
+./coordinator -q --train-markov markov.tmp wordlist.tmp >/dev/null 2>&1
+./coordinator -v --markov markov.tmp --mask '?u?l?d' "$(./test_hash "Zz9" | grep "MD5:" | awk '{print $2}')" "2" > test_output.tmp 2>&1
+CHECKED=$(grep "Verificado nesta execução" test_output.tmp | awk '{print $4}')
+if grep -q "Senha: Zz9" test_output.tmp && [ -n "$CHECKED" ] && [ "$CHECKED" -lt 1000 ] && \
+   [ "$(./coordinator -q --no-result-file --markov markov.tmp --min-len 1 --hash-file hash_file.tmp "2" "abc" "2" | grep -c ':')" -eq 12 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f markov.tmp
+
+# Kernels especializados: mesmo resultado com e sem (MD5_SPECIALIZED=0), em
+# charset de tamanho especializado (10), máscara (tamanhos mistos) e len > 16
+echo -n "Kernels especializados (MD5_SPECIALIZED): "
+SPEC_OK=1
+for spec in 1 0; do
+    MD5_SPECIALIZED=$spec ./coordinator "$(./test_hash "90210" | grep "MD5:" | awk '{print $2}')" "5" "0123456789" "2" > test_output.tmp 2>&1
+    grep -q "90210" test_output.tmp || SPEC_OK=0
+    MD5_SPECIALIZED=$spec ./coordinator --mask '?u?d?l' "$(./test_hash "K7q" | grep "MD5:" | awk '{print $2}')" "2" > test_output.tmp 2>&1
+    grep -q "K7q" test_output.tmp || SPEC_OK=0
+    MD5_SPECIALIZED=$spec ./coordinator "$(./test_hash "aaaaaaaaaaaaaaaaab" | grep "MD5:" | awk '{print $2}')" "18" "ab" "2" > test_output.tmp 2>&1
+    grep -q "aaaaaaaaaaaaaaaaab" test_output.tmp || SPEC_OK=0
+done
+if [ $SPEC_OK -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Formato com sal: salt.pass com sal curto e com sal de 70 bytes (estado
+# intermediário), pass.salt num hash file com dois alvos do mesmo sal
+echo -n "Formato com sal (--hash-spec): "
+LONG_SALT=$(printf 's%.0s' $(seq 70))
+SALT_OK=1
+./coordinator --hash-spec "md5(salt.pass)" "$(./test_hash "xyzcab" | grep "MD5:" | awk '{print $2}'):xyz" "3" "abc" "2" > test_output.tmp 2>&1
+grep -q "Senha: cab" test_output.tmp || SALT_OK=0
+./coordinator --hash-spec "md5(salt.pass)" "$(./test_hash "${LONG_SALT}bca" | grep "MD5:" | awk '{print $2}'):$LONG_SALT" "3" "abc" "2" > test_output.tmp 2>&1
+grep -q "Senha: bca" test_output.tmp || SALT_OK=0
+rm -f hash_file.tmp
+for p in ab ca; do
+    echo "$(./test_hash "${p}NaCl" | grep "MD5:" | awk '{print $2}'):NaCl" >> hash_file.tmp
+done
+echo "$(./test_hash "bbqq" | grep "MD5:" | awk '{print $2}'):qq" >> hash_file.tmp
+[ "$(./coordinator -q --no-result-file --hash-spec "md5(pass.salt)" --hash-file hash_file.tmp "2" "abc" "2" | grep -c ':')" -eq 3 ] || SALT_OK=0
+./coordinator --hash-spec "md5(pass.salt)" "$(./test_hash "a" | grep "MD5:" | awk '{print $2}'):$LONG_SALT" "3" "abc" "2" 2>&1 | grep -q "Deu erro" || SALT_OK=0
+if [ $SALT_OK -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Outros algoritmos: NTLM (processos), SHA-256 (threads), SHA-1 e MD4 num hash
+# file, e o limite de 27 caracteres do NTLM
+echo -n "Algoritmos (--algo): "
+ALGO_OK=1
+./coordinator --algo ntlm "$(./test_hash "cab" | grep "NTLM:" | awk '{print $2}')" "3" "abc" "2" > test_output.tmp 2>&1
+grep -q "Senha: cab" test_output.tmp || ALGO_OK=0
+./coordinator --threads --algo sha256 "$(./test_hash "bca" | grep "SHA-256:" | awk '{print $2}')" "3" "abc" "2" > test_output.tmp 2>&1
+grep -q "Hash verificado com sucesso" test_output.tmp || ALGO_OK=0
+for algo in sha1 md4; do
+    label=$([ $algo = sha1 ] && echo "SHA-1:" || echo "MD4:")
+    rm -f hash_file.tmp
+    for p in ab cca; do
+        ./test_hash "$p" | grep "$label" | awk '{print $2}' >> hash_file.tmp
+    done
+    [ "$(./coordinator -q --no-result-file --algo $algo --min-len 1 --hash-file hash_file.tmp "3" "abc" "2" | grep -c ':')" -eq 2 ] || ALGO_OK=0
+done
+./coordinator --algo ntlm "$(./test_hash "a" | grep "NTLM:" | awk '{print $2}')" "28" "abc" "2" 2>&1 | grep -q "Deu erro" || ALGO_OK=0
+if [ $ALGO_OK -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+echo -n "Potfile (--potfile): "
+POT_OK=1
+rm -f pot.tmp pot.tmp.idx hash_file.tmp
+for p in ab cca; do
+    ./test_hash "$p" | grep "MD5:" | awk '{print $2}' >> hash_file.tmp
+done
+./coordinator -q --no-result-file --potfile pot.tmp --min-len 1 --hash-file hash_file.tmp "3" "abc" "2" > /dev/null 2>&1
+[ "$(grep -c '^md5:' pot.tmp 2>/dev/null)" -eq 2 ] || POT_OK=0
+./test_hash "bcb" | grep "MD5:" | awk '{print $2}' >> hash_file.tmp
+./coordinator --no-result-file --potfile pot.tmp --min-len 1 --hash-file hash_file.tmp "3" "abc" "2" > test_output.tmp 2>&1
+grep -q "2 de 3 alvos já quebrados" test_output.tmp || POT_OK=0
+grep -q "3 de 3 SENHAS ENCONTRADAS" test_output.tmp || POT_OK=0
+./coordinator --potfile pot.tmp "$(./test_hash "cca" | grep "MD5:" | awk '{print $2}')" "3" "abc" "2" > test_output.tmp 2>&1
+grep -q "Origem: potfile" test_output.tmp || POT_OK=0
+grep -q "Iniciando workers" test_output.tmp && POT_OK=0
+[ "$(wc -l < pot.tmp)" -eq 3 ] || POT_OK=0
+if [ $POT_OK -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
 # Verificar processos zumbi
 echo -n "Verificando processos zumbi: "
 ./coordinator "900150983cd24fb0d6963f7d28e17f72" "3" "abc" "4" >/dev/null 2>&1
@@ -238,7 +547,7 @@ else
 fi
 
 # Limpeza
-rm -f test_output.tmp password_found.txt
+rm -f test_output.tmp hash_file.tmp wordlist.tmp rules.tmp ck.tmp table.tmp pot.tmp pot.tmp.idx password_found.txt
 
 # Resultado final
 echo -e "\n=== Resultado Final ==="
@@ -0,0 +1,314 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <time.h>
+#include "hash_utils.h"
+#include "hash_algo.h"
+#include "progress.h"
+
+/**
+ * BENCHMARK - Mini-Projeto 1: Quebra de Senhas Paralelo
+ *
+ * Mede, com o relógio monotônico, e grava em JSON na saída padrão (o
+ * andamento vai para stderr), para comparar versões:
+ * - kernels: MD5 bruto (64 passos, sem alvo revertido) em hashes/s, para
+ *   cada kernel suportado pela CPU e cada comprimento de candidato; até
+ *   MD5_SPECIALIZED_MAX, também com as variantes especializadas desligadas
+ *   (generic_hashes_per_sec); e os outros algoritmos de hash_algo.h
+ *   (algorithms: MD4, NTLM, SHA-1 e SHA-256) em alguns comprimentos
+ * - scaling: ./coordinator de ponta a ponta com 1..N workers, num espaço sem
+ *   a senha (verificado por inteiro): candidatos/s, speedup e eficiência
+ * - startup: custo de fork() sozinho e de fork() + exec do ./worker (um
+ *   intervalo de uma senha) até o waitpid
+ *
+ * Uso: ./benchmark [--quick] [--seconds S] [--max-workers N] [--threads]
+ *                  [--len L] [--charset C]
+ *
+ * make bench roda o benchmark e grava o resultado em bench.json.
+ */
+
+#define BENCH_DEFAULT_SECONDS 0.5       // Por combinação kernel x comprimento
+#define BENCH_QUICK_SECONDS 0.05
+#define BENCH_DEFAULT_LEN 5
+#define BENCH_DEFAULT_CHARSET "abcdefghijklmnopqrstuvwxyz0123456789"
+#define BENCH_QUICK_LEN 4
+#define BENCH_MAX_WORKERS 1024          // MAX_WORKERS do coordinator (SCHED_MAX_WORKERS)
+#define BENCH_STARTUP_RUNS 50
+#define BENCH_CHECK_EVERY 256           // Lotes entre consultas ao relógio
+
+static const char *const kernels[] = {"scalar", "sse2", "avx2", "avx512"};
+static const int lengths[] = {1, 4, 6, 8, 12, 16, 32, MD5_SINGLE_BLOCK_MAX};
+static const int algo_lengths[] = {8, 27};      // 27: o maior do NTLM
+
+/**
+ * Imprime uma string JSON (com aspas e escapes)
+ */
+static void json_string(const char *str) {
+    putchar('"');
+    for (const unsigned char *p = (const unsigned char*)str; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            printf("\\%c", *p);
+        } else if (*p < 0x20) {
+            printf("\\u%04x", *p);
+        } else {
+            putchar(*p);
+        }
+    }
+    putchar('"');
+}
+
+/**
+ * Hashes/s do kernel ativo para candidatos de comprimento len: lotes
+ * completos de hash_block_batch_find (md5_block_batch_find, no MD5) contra
+ * um alvo que nunca bate
+ */
+static double bench_kernel(int algo, int len, double seconds) {
+    static md5_block_batch_t batch;
+    char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+    md5_target_t target;
+    long long batches = 0;
+    int found = 0;
+
+    // Digest de uma entrada fora do lote; sem md5_target_reverse: os 64 passos
+    static const uint8_t zeros[HASH_DIGEST_MAX];
+    hash_target_from_digest(algo, zeros, &target);
+    md5_block_batch_init(&batch, len);
+    batch.count = MD5_BATCH_MAX;
+    memset(candidate, 'a', len);
+    candidate[len] = '\0';
+    for (int l = 0; l < MD5_BATCH_MAX; l++) {
+        candidate[0] = 'A' + l % 26;
+        md5_block_batch_set(&batch, l, candidate);
+    }
+
+    double start = progress_now(), elapsed;
+    do {
+        for (int i = 0; i < BENCH_CHECK_EVERY; i++) {
+            // Muda um candidato por lote, para que nenhum lote seja igual ao anterior
+            candidate[0] = (char)batches;
+            md5_block_batch_set(&batch, 0, candidate);
+            found += hash_block_batch_find(algo, &batch, &target) >= 0;
+            batches++;
+        }
+        elapsed = progress_now() - start;
+    } while (elapsed < seconds);
+
+    if (found > 0) {
+        fprintf(stderr, "Aviso: o alvo do benchmark bateu %d vez(es)\n", found);
+    }
+    return batches * (double)MD5_BATCH_MAX / elapsed;
+}
+
+/**
+ * Roda um programa (saída descartada) e espera o fim
+ *
+ * @return Status do waitpid, ou -1 se o fork falhou
+ */
+static int run_program(char *const argv[]) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Erro no fork");
+        return -1;
+    }
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+        }
+        execv(argv[0], argv);
+        _exit(127);
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+    }
+    return status;
+}
+
+/**
+ * Microssegundos médios de fork() + _exit no filho + waitpid
+ */
+static double bench_fork(int runs) {
+    double start = progress_now();
+    for (int i = 0; i < runs; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            _exit(0);
+        }
+        if (pid > 0) {
+            waitpid(pid, NULL, 0);
+        }
+    }
+    return (progress_now() - start) * 1e6 / runs;
+}
+
+int main(int argc, char *argv[]) {
+    double seconds = BENCH_DEFAULT_SECONDS;
+    int max_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int use_threads = 0;
+    int len = BENCH_DEFAULT_LEN;
+    const char *charset = BENCH_DEFAULT_CHARSET;
+    int startup_runs = BENCH_STARTUP_RUNS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            seconds = BENCH_QUICK_SECONDS;
+            len = BENCH_QUICK_LEN;
+            startup_runs = BENCH_STARTUP_RUNS / 5;
+            if (max_workers > 2) {
+                max_workers = 2;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            use_threads = 1;
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-workers") == 0 && i + 1 < argc) {
+            max_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--len") == 0 && i + 1 < argc) {
+            len = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--charset") == 0 && i + 1 < argc) {
+            charset = argv[++i];
+        } else {
+            fprintf(stderr, "Uso: %s [--quick] [--seconds S] [--max-workers N] [--threads] "
+                    "[--len L] [--charset C]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!use_threads && max_workers > BENCH_MAX_WORKERS) {
+        max_workers = BENCH_MAX_WORKERS;
+    }
+    if (seconds <= 0 || max_workers < 1 || len < 1 || len > MD5_SINGLE_BLOCK_MAX || charset[0] == '\0') {
+        fprintf(stderr, "Parâmetros inválidos\n");
+        return 1;
+    }
+    if (access("./coordinator", X_OK) != 0 || access("./worker", X_OK) != 0) {
+        fprintf(stderr, "Compile coordinator e worker antes (make all)\n");
+        return 1;
+    }
+
+    // Alvo que nenhum candidato do espaço produz ('!' não está no charset
+    // padrão): o coordinator verifica o espaço inteiro
+    char miss_hash[33];
+    md5_string("!benchmark!", miss_hash);
+    long long space = 1;
+    for (int i = 0; i < len; i++) {
+        space *= (long long)strlen(charset);
+    }
+
+    const char *default_kernel = md5_kernel_name();
+    printf("{\n");
+    printf("  \"timestamp\": %lld,\n", (long long)time(NULL));
+    printf("  \"online_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("  \"default_kernel\": ");
+    json_string(default_kernel);
+    printf(",\n  \"default_lanes\": %d,\n", md5_kernel_lanes());
+
+    // 1. Kernels x comprimentos
+    printf("  \"kernels\": [");
+    int first = 1;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (md5_select_kernel(kernels[k]) != 0) {
+            fprintf(stderr, "Kernel %s: não suportado nesta CPU\n", kernels[k]);
+            continue;
+        }
+        printf("%s\n    {\"name\": ", first ? "" : ",");
+        json_string(kernels[k]);
+        printf(", \"lanes\": %d, \"hashes_per_sec\": {", md5_kernel_lanes());
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            double rate = bench_kernel(HASH_MD5, lengths[l], seconds);
+            fprintf(stderr, "Kernel %-6s len %2d: %.0f hashes/s\n", kernels[k], lengths[l], rate);
+            printf("%s\"%d\": %.0f", l == 0 ? "" : ", ", lengths[l], rate);
+        }
+        printf("}, \"generic_hashes_per_sec\": {");
+        md5_select_specialized(0);
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            if (lengths[l] > MD5_SPECIALIZED_MAX) {
+                break;
+            }
+            double rate = bench_kernel(HASH_MD5, lengths[l], seconds);
+            fprintf(stderr, "Kernel %-6s len %2d (genérico): %.0f hashes/s\n", kernels[k], lengths[l], rate);
+            printf("%s\"%d\": %.0f", l == 0 ? "" : ", ", lengths[l], rate);
+        }
+        md5_select_specialized(1);
+        printf("}, \"algorithms\": {");
+        for (int algo = HASH_MD4; algo < HASH_ALGO_COUNT; algo++) {
+            printf("%s\"%s\": {", algo == HASH_MD4 ? "" : ", ", hash_algo_get(algo)->name);
+            for (size_t l = 0; l < sizeof(algo_lengths) / sizeof(algo_lengths[0]); l++) {
+                double rate = bench_kernel(algo, algo_lengths[l], seconds);
+                fprintf(stderr, "Kernel %-6s %-7s len %2d: %.0f hashes/s\n", kernels[k],
+                        hash_algo_get(algo)->label, algo_lengths[l], rate);
+                printf("%s\"%d\": %.0f", l == 0 ? "" : ", ", algo_lengths[l], rate);
+            }
+            printf("}");
+        }
+        printf("}}");
+        first = 0;
+        fflush(stdout);
+    }
+    printf("\n  ],\n");
+    md5_select_kernel(default_kernel);
+
+    // 2. Ponta a ponta com 1..N workers
+    printf("  \"scaling\": {\"mode\": \"%s\", \"len\": %d, \"charset\": ",
+           use_threads ? "threads" : "processes", len);
+    json_string(charset);
+    printf(", \"space\": %lld, \"runs\": [", space);
+    double base_rate = 0;
+    for (int n = 1; n <= max_workers; n++) {
+        char len_arg[16], workers_arg[16];
+        snprintf(len_arg, sizeof(len_arg), "%d", len);
+        snprintf(workers_arg, sizeof(workers_arg), "%d", n);
+        char *args[10];
+        int a = 0;
+        args[a++] = "./coordinator";
+        args[a++] = "-q";
+        args[a++] = "--no-result-file";
+        if (use_threads) {
+            args[a++] = "--threads";
+        }
+        args[a++] = miss_hash;
+        args[a++] = len_arg;
+        args[a++] = (char*)charset;
+        args[a++] = workers_arg;
+        args[a] = NULL;
+
+        double start = progress_now();
+        int status = run_program(args);
+        double elapsed = progress_now() - start;
+        if (status < 0 || !WIFEXITED(status) || WEXITSTATUS(status) == 127) {
+            fprintf(stderr, "Erro ao rodar o coordinator com %d workers\n", n);
+            printf("\n  ]}\n}\n");
+            return 1;
+        }
+
+        double rate = space / elapsed;
+        if (n == 1) {
+            base_rate = rate;
+        }
+        double speedup = rate / base_rate;
+        fprintf(stderr, "%2d workers: %.3f s, %.0f candidatos/s, speedup %.2fx\n", n, elapsed, rate, speedup);
+        printf("%s\n    {\"workers\": %d, \"seconds\": %.6f, \"candidates_per_sec\": %.0f, "
+               "\"speedup\": %.3f, \"efficiency\": %.3f}", n == 1 ? "" : ",", n, elapsed, rate,
+               speedup, speedup / n);
+        fflush(stdout);
+    }
+    printf("\n  ]},\n");
+
+    // 3. Custo de criação de processos
+    char *worker_args[] = {"./worker", miss_hash, "0", "1", (char*)charset, "1", "0", "-q", NULL};
+    double fork_us = bench_fork(startup_runs);
+    double start = progress_now();
+    for (int i = 0; i < startup_runs; i++) {
+        run_program(worker_args);
+    }
+    double exec_us = (progress_now() - start) * 1e6 / startup_runs;
+    fprintf(stderr, "fork: %.1f us, fork + exec do worker: %.1f us\n", fork_us, exec_us);
+    printf("  \"startup\": {\"runs\": %d, \"fork_us\": %.1f, \"fork_exec_worker_us\": %.1f}\n",
+           startup_runs, fork_us, exec_us);
+    printf("}\n");
+    return 0;
+}
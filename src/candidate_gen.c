@@ -0,0 +1,175 @@
+#include "candidate_gen.h"
+
+/**
+ * Avança o odômetro para o próximo candidato (última posição mais rápida)
+ * Só as posições que mudam são reescritas em current.
+ */
+static void candidate_gen_advance(candidate_gen_t *gen) {
+    for (int i = gen->len - 1; i >= 0; i--) {
+        if (++gen->idx[i] < gen->radix[i]) {
+            gen->current[i] = gen->charset[i][gen->idx[i]];
+            return;
+        }
+        gen->idx[i] = 0;
+        gen->current[i] = gen->charset[i][0];
+    }
+}
+
+/**
+ * Caminho genérico de candidate_gen_fill (comprimentos > MD5_SPECIALIZED_MAX
+ * e lotes com sal)
+ */
+static int candidate_gen_fill_generic(candidate_gen_t *gen, md5_block_batch_t *batch) {
+    int n = 0;
+
+    while (n < MD5_BATCH_MAX && gen->remaining > 0) {
+        md5_block_batch_set(batch, n++, gen->current);
+        if (--gen->remaining > 0) {
+            candidate_gen_advance(gen);
+        }
+    }
+    batch->count = n;
+    return n;
+}
+
+/**
+ * Corpo de candidate_gen_fill com o comprimento e o tamanho do charset
+ * constantes (radix = 0: tamanho de cada posição lido de gen->radix, como
+ * nas máscaras). O compilador desenrola o odômetro e a montagem das
+ * palavras; o padding e o comprimento ficam onde md5_block_batch_init os pôs.
+ */
+static inline __attribute__((always_inline))
+int candidate_gen_fill_body(candidate_gen_t *gen, md5_block_batch_t *batch,
+                            const int len, const int radix) {
+    int n = 0;
+
+    while (n < MD5_BATCH_MAX && gen->remaining > 0) {
+        const uint8_t *p = (const uint8_t*)gen->current;
+
+        // Palavras com bytes do candidato; a última leva o 0x80 se len % 4 != 0
+#pragma GCC unroll 4
+        for (int j = 0; j < (len + 3) / 4; j++) {
+            uint32_t word = j == len / 4 ? 0x80u << (8 * (len % 4)) : 0;
+            for (int i = 0; i < 4 && j * 4 + i < len; i++) {
+                word |= ((uint32_t)p[j * 4 + i]) << (8 * i);
+            }
+            batch->words[j][n] = word;
+        }
+        n++;
+
+        if (--gen->remaining > 0) {
+#pragma GCC unroll 16
+            for (int i = len - 1; i >= 0; i--) {
+                if (++gen->idx[i] < (radix != 0 ? radix : gen->radix[i])) {
+                    gen->current[i] = gen->charset[i][gen->idx[i]];
+                    break;
+                }
+                gen->idx[i] = 0;
+                gen->current[i] = gen->charset[i][0];
+            }
+        }
+    }
+    batch->count = n;
+    return n;
+}
+
+/* Tamanhos de charset especializados: 0 (qualquer), dígitos, hex, letras,
+   letras + dígitos, alfanumérico e ASCII imprimível */
+#define CANDIDATE_GEN_RADIXES(X, len) \
+    X(len, 0) X(len, 10) X(len, 16) X(len, 26) X(len, 36) X(len, 62) X(len, 95)
+#define CANDIDATE_GEN_NUM_RADIXES 7
+
+#define CANDIDATE_GEN_DEFINE(len, radix) \
+    static int candidate_gen_fill_##len##_##radix(candidate_gen_t *gen, md5_block_batch_t *batch) { \
+        return candidate_gen_fill_body(gen, batch, len, radix); \
+    }
+#define CANDIDATE_GEN_DEFINE_LEN(len) CANDIDATE_GEN_RADIXES(CANDIDATE_GEN_DEFINE, len)
+#define CANDIDATE_GEN_ENTRY(len, radix) candidate_gen_fill_##len##_##radix,
+#define CANDIDATE_GEN_ENTRY_LEN(len) {CANDIDATE_GEN_RADIXES(CANDIDATE_GEN_ENTRY, len)},
+
+MD5_SPECIALIZED_LENS(CANDIDATE_GEN_DEFINE_LEN)
+
+static const candidate_fill_fn fill_table[MD5_SPECIALIZED_MAX + 1][CANDIDATE_GEN_NUM_RADIXES] = {
+    {NULL}, MD5_SPECIALIZED_LENS(CANDIDATE_GEN_ENTRY_LEN)
+};
+static const int fill_radixes[CANDIDATE_GEN_NUM_RADIXES] = {0, 10, 16, 26, 36, 62, 95};
+
+/**
+ * Escolhe o preenchimento para o comprimento e os charsets do intervalo:
+ * o especializado no tamanho comum das posições, se for um dos de
+ * fill_radixes; senão o especializado só no comprimento; o genérico acima
+ * de MD5_SPECIALIZED_MAX (ou com a especialização desligada)
+ */
+static candidate_fill_fn candidate_gen_pick_fill(const int *radix, int len) {
+    if (!md5_kernel_specialized(len)) {
+        return candidate_gen_fill_generic;
+    }
+    int slot = 0;
+    for (int r = 1; r < CANDIDATE_GEN_NUM_RADIXES; r++) {
+        if (radix[0] == fill_radixes[r]) {
+            slot = r;
+        }
+    }
+    for (int i = 1; i < len && slot != 0; i++) {
+        if (radix[i] != radix[0]) {
+            slot = 0;
+        }
+    }
+    return fill_table[len][slot];
+}
+
+int candidate_gen_init(candidate_gen_t *gen, const char *const *charset, const int *radix,
+                       int len, keyspace_index_t start_index, long long count) {
+    if (len < 1 || len > MD5_SINGLE_BLOCK_MAX || start_index < 0 || count < 0) {
+        return -1;
+    }
+
+    gen->charset = charset;
+    gen->radix = radix;
+    gen->len = len;
+    gen->remaining = count;
+
+    // Mesma decomposição de keyspace_password: um dígito na base radix[i] por posição
+    for (int i = len - 1; i >= 0; i--) {
+        if (radix[i] < 1) {
+            return -1;
+        }
+        gen->idx[i] = (int)(start_index % radix[i]);
+        gen->current[i] = charset[i][gen->idx[i]];
+        start_index /= radix[i];
+    }
+    gen->current[len] = '\0';
+    gen->fill = candidate_gen_pick_fill(radix, len);
+    return 0;
+}
+
+int candidate_gen_fill(candidate_gen_t *gen, md5_block_batch_t *batch) {
+    // Lote com sal: o candidato não começa na palavra 0 (md5_block_batch_set)
+    if (batch->salted) {
+        return candidate_gen_fill_generic(gen, batch);
+    }
+    return gen->fill(gen, batch);
+}
+
+int candidate_gen_next_run(candidate_gen_t *gen, char *prefix, int *first, int *count) {
+    int last = gen->len - 1;
+
+    if (gen->remaining == 0) {
+        return 0;
+    }
+
+    *first = gen->idx[last];
+    *count = gen->radix[last] - *first;
+    if (*count > gen->remaining) {
+        *count = (int)gen->remaining;
+    }
+    memcpy(prefix, gen->current, gen->len + 1);
+
+    // Próximo prefixo: leva o último caractere ao fim e propaga o "vai um"
+    gen->remaining -= *count;
+    if (gen->remaining > 0) {
+        gen->idx[last] = gen->radix[last] - 1;
+        candidate_gen_advance(gen);
+    }
+    return 1;
+}
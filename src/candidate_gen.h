@@ -0,0 +1,76 @@
+#ifndef CANDIDATE_GEN_H
+#define CANDIDATE_GEN_H
+
+#include "hash_utils.h"
+#include "keyspace.h"
+
+/**
+ * Gerador de candidatos por índices - Mini-Projeto 1
+ *
+ * Enumera o intervalo [start_index, start_index + count) dos candidatos de
+ * comprimento len na mesma ordem de keyspace_password: cada posição guarda
+ * o índice do seu caractere no charset daquela posição (um odômetro de base
+ * mista), então avançar não exige procurar caracteres no charset nem
+ * comparar strings, e a ordem do charset ("cba", "0a9Z"...) não importa.
+ *
+ * Para comprimentos até MD5_SPECIALIZED_MAX, candidate_gen_init escolhe um
+ * preenchimento gerado em tempo de compilação para aquele comprimento e,
+ * se todas as posições têm o mesmo tamanho de charset (10, 16, 26, 36, 62
+ * ou 95), para aquele tamanho também.
+ *
+ * Exemplo de uso:
+ *   candidate_gen_t gen;
+ *   candidate_gen_init(&gen, ks.charset, ks.radix, 3, 0, ks.size[3]);
+ *   while (candidate_gen_fill(&gen, &batch) > 0) {
+ *       ... md5_block_batch_find(&batch, &target) ...
+ *   }
+ */
+
+typedef struct candidate_gen candidate_gen_t;
+typedef int (*candidate_fill_fn)(candidate_gen_t *gen, md5_block_batch_t *batch);
+
+struct candidate_gen {
+    const char *const *charset;             // Charset de cada posição (keyspace_t)
+    const int *radix;                       // Tamanho do charset de cada posição
+    int len;                                // Comprimento dos candidatos
+    int idx[MD5_SINGLE_BLOCK_MAX];          // Índice no charset de cada posição
+    char current[MD5_SINGLE_BLOCK_MAX + 1]; // Candidato atual como string
+    long long remaining;                    // Candidatos ainda não entregues
+    candidate_fill_fn fill;                 // Escolhido em candidate_gen_init
+};
+
+/**
+ * Posiciona o gerador no candidato de índice start_index
+ *
+ * @param charset Charset de cada posição (a posição no charset define a ordem)
+ * @param radix Tamanho do charset de cada posição
+ * @param len Comprimento dos candidatos (1..MD5_SINGLE_BLOCK_MAX)
+ * @param start_index Índice do primeiro candidato
+ * @param count Número de candidatos a enumerar
+ * @return 0 em caso de sucesso, -1 se os parâmetros forem inválidos
+ */
+int candidate_gen_init(candidate_gen_t *gen, const char *const *charset, const int *radix,
+                       int len, keyspace_index_t start_index, long long count);
+
+/**
+ * Grava os próximos candidatos (até MD5_BATCH_MAX) direto no lote de blocos
+ * MD5 e ajusta batch->count
+ *
+ * @param batch Lote já preparado com md5_block_batch_init(batch, gen->len)
+ *              (ou md5_block_batch_init_salted, para o mesmo comprimento)
+ * @return Número de candidatos gravados (0 = intervalo esgotado)
+ */
+int candidate_gen_fill(candidate_gen_t *gen, md5_block_batch_t *batch);
+
+/**
+ * Entrega a próxima "corrida" do modo incremental: um prefixo (os len - 1
+ * primeiros caracteres) e a faixa de índices do último caractere,
+ * charset[len - 1][*first .. *first + *count - 1], limitada ao fim do intervalo
+ *
+ * @param prefix Saída: candidato com o prefixo da corrida (len bytes + '\0';
+ *               o último caractere é o de índice *first)
+ * @return 1 se entregou uma corrida, 0 se o intervalo acabou
+ */
+int candidate_gen_next_run(candidate_gen_t *gen, char *prefix, int *first, int *count);
+
+#endif // CANDIDATE_GEN_H
@@ -0,0 +1,198 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "checkpoint.h"
+#include "progress.h"
+
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_FNV_PRIME 0x100000001b3ULL
+
+unsigned long long checkpoint_hash(unsigned long long hash, const void *data, size_t len) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= CHECKPOINT_FNV_PRIME;
+    }
+    return hash;
+}
+
+unsigned long long checkpoint_hash_str(unsigned long long hash, const char *str) {
+    if (str != NULL) {
+        hash = checkpoint_hash(hash, str, strlen(str));
+    }
+    return checkpoint_hash(hash, "", 1);
+}
+
+/**
+ * Decodifica uma senha em hexadecimal
+ *
+ * @return 0 em caso de sucesso, -1 se o texto é inválido ou longo demais
+ */
+static int decode_password(const char *hex, char password[MD5_SINGLE_BLOCK_MAX + 1]) {
+    size_t len = strlen(hex);
+    if (len % 2 != 0 || len / 2 > MD5_SINGLE_BLOCK_MAX) {
+        return -1;
+    }
+    for (size_t i = 0; i < len / 2; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return -1;
+        }
+        password[i] = (char)byte;
+    }
+    password[len / 2] = '\0';
+    return 0;
+}
+
+int checkpoint_load(const char *path, unsigned long long job_id, keyspace_index_t total,
+                    shared_state_t *shared, keyspace_index_t *done) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+
+    int version;
+    unsigned long long id;
+    char space_str[KEYSPACE_INDEX_DIGITS], done_str[KEYSPACE_INDEX_DIGITS];
+    keyspace_index_t space;
+    if (fscanf(f, "checkpoint %d job %llx space %40s done %40s", &version, &id, space_str, done_str) != 4 ||
+        version != CHECKPOINT_VERSION || id != job_id ||
+        keyspace_index_parse(space_str, &space) != 0 || keyspace_index_parse(done_str, done) != 0 ||
+        space != total || *done > total) {
+        fclose(f);
+        return -2;
+    }
+
+    int target, worker_id;
+    char hex[2 * MD5_SINGLE_BLOCK_MAX + 2];
+    char password[MD5_SINGLE_BLOCK_MAX + 1];
+    while (fscanf(f, " crack %d %d %111s", &target, &worker_id, hex) == 3) {
+        if (target < 0 || target >= shared->num_targets || decode_password(hex, password) != 0) {
+            fclose(f);
+            return -2;
+        }
+        shared_state_publish(shared, target, worker_id, password);
+    }
+    fclose(f);
+    return 0;
+}
+
+/**
+ * fsync do diretório do arquivo, para que o rename sobreviva a uma queda
+ */
+static void sync_parent_dir(const char *path) {
+    char dir[4096] = ".";
+    const char *slash = strrchr(path, '/');
+    if (slash != NULL) {
+        size_t len = slash == path ? 1 : (size_t)(slash - path);
+        if (len >= sizeof(dir)) {
+            return;
+        }
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd != -1) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+keyspace_index_t checkpoint_write(checkpoint_t *ck) {
+    // Watermark antes das senhas: uma senha publicada depois dele só faz o
+    // chunk ser refeito na retomada (e ser encontrada de novo)
+    keyspace_index_t done = ck->base + scheduler_watermark(&ck->shared->sched);
+
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", ck->path) >= (int)sizeof(tmp)) {
+        fprintf(stderr, "Erro ao gravar checkpoint: caminho longo demais\n");
+        return -1;
+    }
+    FILE *f = fopen(tmp, "w");
+    if (f == NULL) {
+        perror("Erro ao gravar checkpoint");
+        return -1;
+    }
+
+    char space_str[KEYSPACE_INDEX_DIGITS], done_str[KEYSPACE_INDEX_DIGITS];
+    fprintf(f, "checkpoint %d\njob %016llx\nspace %s\ndone %s\n", CHECKPOINT_VERSION, ck->job_id,
+            keyspace_index_format(ck->total, space_str), keyspace_index_format(done, done_str));
+    for (int i = 0; i < ck->shared->num_targets; i++) {
+        const shared_crack_t *crack = &ck->shared->cracks[i];
+        if (!atomic_load_explicit(&crack->ready, memory_order_acquire)) {
+            continue;
+        }
+        fprintf(f, "crack %d %d ", i, crack->worker_id);
+        for (const char *p = crack->password; *p != '\0'; p++) {
+            fprintf(f, "%02x", (unsigned char)*p);
+        }
+        fprintf(f, "\n");
+    }
+
+    // Conteúdo no disco antes do rename: nunca fica um checkpoint pela metade
+    int failed = fflush(f) != 0 || fsync(fileno(f)) != 0;
+    failed |= fclose(f) != 0;
+    if (failed || rename(tmp, ck->path) != 0) {
+        perror("Erro ao gravar checkpoint");
+        unlink(tmp);
+        return -1;
+    }
+    sync_parent_dir(ck->path);
+    return done;
+}
+
+static void *checkpoint_main(void *arg) {
+    checkpoint_t *ck = arg;
+
+    pthread_mutex_lock(&ck->lock);
+    while (!ck->stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += ck->interval;
+
+        int rc = 0;
+        while (!ck->stop && rc != ETIMEDOUT) {
+            rc = pthread_cond_timedwait(&ck->wake, &ck->lock, &deadline);
+        }
+        if (ck->stop) {
+            break;
+        }
+
+        // Gravação fora do lock: checkpoint_stop não espera pelo disco para acordar a thread
+        pthread_mutex_unlock(&ck->lock);
+        keyspace_index_t done = checkpoint_write(ck);
+        if (done >= 0) {
+            char done_str[KEYSPACE_INDEX_DIGITS], total_str[KEYSPACE_INDEX_DIGITS];
+            LOG(LOG_VERBOSE, "Checkpoint: %s de %s (%.1f%%) gravado em %s\n",
+                keyspace_index_format(done, done_str), keyspace_index_format(ck->total, total_str),
+                ck->total > 0 ? 100.0 * (double)done / (double)ck->total : 100.0, ck->path);
+        }
+        pthread_mutex_lock(&ck->lock);
+    }
+    pthread_mutex_unlock(&ck->lock);
+    return NULL;
+}
+
+int checkpoint_start(checkpoint_t *ck) {
+    pthread_mutex_init(&ck->lock, NULL);
+    pthread_cond_init(&ck->wake, NULL);
+    ck->stop = 0;
+    ck->running = pthread_create(&ck->tid, NULL, checkpoint_main, ck) == 0;
+    return ck->running ? 0 : -1;
+}
+
+keyspace_index_t checkpoint_stop(checkpoint_t *ck) {
+    if (ck->running) {
+        pthread_mutex_lock(&ck->lock);
+        ck->stop = 1;
+        pthread_cond_signal(&ck->wake);
+        pthread_mutex_unlock(&ck->lock);
+        pthread_join(ck->tid, NULL);
+        ck->running = 0;
+    }
+    return checkpoint_write(ck);
+}
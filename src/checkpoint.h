@@ -0,0 +1,100 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <pthread.h>
+#include "keyspace.h"
+#include "shared_state.h"
+
+/**
+ * Checkpoint e retomada de buscas longas (--checkpoint/--resume) - Mini-Projeto 1
+ *
+ * Uma thread do coordinator grava periodicamente o watermark do escalonador
+ * (scheduler_watermark: tudo abaixo dele já foi verificado) e as senhas já
+ * encontradas. Os workers não participam: o laço de busca só grava o
+ * pending do seu slot ao retirar e concluir cada chunk.
+ *
+ * Formato (texto, senhas em hexadecimal para aceitar qualquer caractere):
+ *
+ *   checkpoint 1
+ *   job <id>             FNV-1a dos parâmetros que definem o espaço e os alvos
+ *   space <total>        em decimal, até 128 bits (keyspace_index_t)
+ *   done <watermark>     base + scheduler_watermark
+ *   crack <alvo> <worker> <senha em hex>
+ *
+ * A gravação é atômica: arquivo temporário, fsync, rename e fsync do
+ * diretório. Na retomada, o watermark vira a base da execução (a posição 0
+ * do escalonador, ver keyspace_window). O watermark é o menor entre o
+ * cursor e o início do chunk pendente mais antigo (scheduler_watermark):
+ * esse chunk e tudo acima dele são refeitos, inclusive os chunks já
+ * concluídos depois dele (no máximo o que os workers fizeram enquanto o
+ * chunk mais antigo estava em andamento).
+ */
+
+#define CHECKPOINT_HASH_INIT 0xcbf29ce484222325ULL
+#define CHECKPOINT_DEFAULT_INTERVAL 60
+
+typedef struct {
+    // Entrada
+    const char *path;
+    unsigned long long job_id;
+    keyspace_index_t total;
+    keyspace_index_t base;      // Índice da posição 0 do escalonador
+    int interval;               // Segundos entre gravações
+    shared_state_t *shared;
+
+    // Thread de gravação
+    pthread_t tid;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int stop;
+    int running;
+} checkpoint_t;
+
+/**
+ * Acumula bytes no identificador do job (FNV-1a de 64 bits)
+ *
+ * @param hash Valor anterior (CHECKPOINT_HASH_INIT no primeiro campo)
+ * @return Novo valor
+ */
+unsigned long long checkpoint_hash(unsigned long long hash, const void *data, size_t len);
+
+/**
+ * Acumula uma string (NULL = vazia) seguida de um separador, para que
+ * campos vizinhos não se confundam
+ */
+unsigned long long checkpoint_hash_str(unsigned long long hash, const char *str);
+
+/**
+ * Lê um checkpoint, confere o job e restaura as senhas encontradas em shared
+ * (shared_state_publish, então a flag de parada liga se já eram todas)
+ *
+ * @param done Saída: índice até onde o espaço já foi verificado
+ * @return 0 em caso de sucesso, -1 se o arquivo não pôde ser lido (errno
+ *         preservado) ou -2 se é inválido ou de outro job
+ */
+int checkpoint_load(const char *path, unsigned long long job_id, keyspace_index_t total,
+                    shared_state_t *shared, keyspace_index_t *done);
+
+/**
+ * Grava o estado atual (watermark do escalonador + senhas) de forma atômica
+ *
+ * @return Watermark gravado (base + scheduler_watermark), ou -1 em caso de
+ *         erro (mensagem já impressa)
+ */
+keyspace_index_t checkpoint_write(checkpoint_t *ck);
+
+/**
+ * Inicia a thread que grava o checkpoint a cada ck->interval segundos
+ *
+ * @return 0 em caso de sucesso, -1 se a thread não pôde ser criada
+ */
+int checkpoint_start(checkpoint_t *ck);
+
+/**
+ * Para a thread de gravação e grava o checkpoint final
+ *
+ * @return Watermark gravado, ou -1 em caso de erro
+ */
+keyspace_index_t checkpoint_stop(checkpoint_t *ck);
+
+#endif // CHECKPOINT_H
@@ -5,8 +5,27 @@
 #include <sys/wait.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <errno.h>
 #include <time.h>
+#include <strings.h>
+#include <signal.h>
 #include "hash_utils.h"
+#include "hash_algo.h"
+#include "progress.h"
+#include "shared_state.h"
+#include "search.h"
+#include "thread_engine.h"
+#include "hash_file.h"
+#include "keyspace.h"
+#include "wordlist.h"
+#include "rules.h"
+#include "checkpoint.h"
+#include "dispatcher.h"
+#include "lookup_table.h"
+#include "instrument.h"
+#include "daemon.h"
+#include "markov.h"
+#include "potfile.h"
 
 /**
  * PROCESSO COORDENADOR - Mini-Projeto 1: Quebra de Senhas Paralelo
@@ -14,271 +33,1301 @@
  * Este programa coordena múltiplos workers para quebrar senhas MD5 em paralelo.
  * O MD5 JÁ ESTÁ IMPLEMENTADO - você deve focar na paralelização (fork/exec/wait).
  * 
- * Uso: ./coordinator <hash_md5> <tamanho> <charset> <num_workers>
+ * Uso: ./coordinator [opções] <hash_md5> <tamanho> <charset> <num_workers>
+ * 
+ * <tamanho> vai até MD5_SINGLE_BLOCK_MAX (55) e num_workers até MAX_WORKERS
+ * (1024; 0 = um por CPU online). O espaço de busca usa índices de 128 bits
+ * (keyspace.h).
+ * 
+ * Verbosidade: -q mostra só o resultado; -v mostra progresso a cada segundo;
+ * --trace-candidates lista cada senha testada (apenas no build "make debug").
+ * 
+ * --threads roda os workers como threads fixadas em CPUs dentro do próprio
+ * coordinator (thread_engine.c) em vez de processos.
+ * 
+ * --min-len N / --max-len M buscam todos os comprimentos de N a M num único
+ * espaço combinado (keyspace.c), dividido entre os workers pelo total de
+ * candidatos; o <tamanho> vale para o limite não informado. Ex.:
+ * --min-len 1 <hash> 8 cobre os comprimentos 1 a 8.
+ * 
+ * --mask <máscara> troca <tamanho> e <charset> por um charset por posição:
+ * ?l ?u ?d ?s ?a (minúsculas, maiúsculas, dígitos, especiais, todos), ?1..?4
+ * (definidos com -1..-4, podendo usar as classes: -1 "?l?d"), ?? ou um
+ * caractere literal. Ex.: --mask "?u?l?l?l?d?d" <hash> 4. Com --min-len e
+ * --max-len, busca os prefixos da máscara com esses comprimentos.
+ * 
+ * --wordlist <arquivo> troca <tamanho> e <charset> por um dicionário (uma
+ * palavra por linha), mapeado em memória e dividido em chunks de bytes
+ * alinhados em linhas; --rules <arquivo> aplica regras (rules.h) a cada
+ * palavra. --min-len/--max-len filtram os candidatos pelo comprimento.
+ * 
+ * --hash-file <arquivo> troca o <hash_md5> por uma lista de hashes (um por
+ * linha), todos procurados na mesma passada pelo espaço de busca; a busca
+ * para quando o último é encontrado.
+ * 
+ * --nodes host:porta,... distribui o espaço entre máquinas que rodam
+ * ./worker --listen <porta> (dispatcher.c): cada nó recebe intervalos do
+ * tamanho proporcional à sua taxa e os de um nó que cai são redistribuídos;
+ * nesse modo, num_workers é o número de threads por nó (0 = todas as CPUs).
+ * 
+ * --build-table <arquivo> enumera o espaço (<tamanho>/<charset>, --mask,
+ * --min-len/--max-len; sem <hash_md5>) uma única vez com num_workers threads
+ * e grava uma tabela ordenada de digests truncados (lookup_table.h);
+ * --table <arquivo> <hash_md5> (ou --hash-file) responde com uma busca por
+ * interpolação na tabela mapeada, sem percorrer o espaço.
+ * 
+ * --trace <arquivo> grava um trace no formato Chrome (chrome://tracing,
+ * Perfetto) com as fases do coordinator e cada chunk de cada worker; --perf
+ * mede ciclos e instruções por worker com perf_event_open. Os contadores por
+ * worker (lotes, pré-filtro, tempo ocioso) aparecem nas estatísticas
+ * (instrument.h).
+ * 
+ * --daemon <socket> <num_threads> fica no ar com um pool de threads aquecido
+ * (0 = uma por CPU) e atende jobs num socket Unix (daemon.h); --submit
+ * <socket> envia a busca descrita pelos demais argumentos ao daemon em vez
+ * de criar workers (num_workers limita as threads do pool usadas pelo job,
+ * 0 = todas), com --priority N (maior = antes, padrão 0). O id do job
+ * aparece ao ser aceito; --submit <socket> --cancel <id> cancela o job.
+ * 
+ * --hash-spec <formato> troca md5(senha) por "md5(salt.pass)" ou
+ * "md5(pass.salt)": cada alvo traz o seu sal ("hash:sal", no argumento ou
+ * em cada linha do --hash-file) e a busca percorre o espaço uma vez por sal
+ * distinto. O sal fica em posição fixa no bloco MD5 final, e os blocos
+ * inteiros de um sal de 64 bytes ou mais são comprimidos uma vez por sal
+ * (hash_utils.h): o comprimento máximo da senha diminui com o resto do sal.
+ * 
+ * --algo <algoritmo> troca o MD5 por md4, ntlm (MD4 da senha em UTF-16LE,
+ * até 27 caracteres), sha1 ou sha256 (hash_algo.h): os mesmos geradores e
+ * modos de execução, com os kernels multi-buffer do algoritmo. Não vale
+ * com --hash-spec com sal nem com as tabelas (--build-table/--table).
+ * 
+ * --markov <modelo> percorre o espaço (força bruta ou --mask) do mais para
+ * o menos provável segundo um modelo de frequência por posição (markov.h),
+ * treinado antes com --train-markov <modelo> <wordlist>: mesmo espaço e
+ * mesma divisão em chunks, só a ordem dos índices muda.
+ * 
+ * --potfile <arquivo> guarda as senhas quebradas entre execuções (potfile.h):
+ * os alvos que já estão nele são respondidos antes de criar os workers (com
+ * --hash-file, saem da busca) e as senhas novas são acrescentadas no fim.
+ * 
+ * --checkpoint <arquivo> grava o progresso a cada --checkpoint-interval
+ * segundos (padrão 60) e ao receber SIGINT/SIGTERM; --resume <arquivo>
+ * retoma a busca de onde o checkpoint parou (com os mesmos parâmetros) e
+ * segue gravando nele. O arquivo é removido quando a busca termina.
+ * 
+ * Os workers avisam o resultado por memória compartilhada; o arquivo
+ * password_found.txt é só uma exportação para scripts (--no-result-file
+ * desativa).
  * 
  * Exemplo: ./coordinator "900150983cd24fb0d6963f7d28e17f72" 3 "abc" 4
  * 
  * SEU TRABALHO: Implementar os TODOs marcados abaixo
  */
 
-#define MAX_WORKERS 16
+#define MAX_WORKERS SCHED_MAX_WORKERS   // Processos, threads ou threads por nó
 #define RESULT_FILE "password_found.txt"
 
 /**
- * Calcula o tamanho total do espaço de busca
- * 
- * @param charset_len Tamanho do conjunto de caracteres
- * @param password_len Comprimento da senha
- * @return Número total de combinações possíveis
+ * Monta uma opção "nome=valor" para a linha de comando do worker
  */
-long long calculate_search_space(int charset_len, int password_len) {
-    long long total = 1;
-    for (int i = 0; i < password_len; i++) {
-        total *= charset_len;
+static char *make_option(const char *name, const char *value) {
+    char *option = malloc(strlen(name) + strlen(value) + 2);
+    if (option == NULL) {
+        perror("Erro ao montar argumentos do worker");
+        exit(1);
     }
-    return total;
+    sprintf(option, "%s=%s", name, value);
+    return option;
+}
+
+// Interrupção com checkpoint ativo: os workers param e o checkpoint final é gravado
+static shared_state_t *interrupt_state;
+static volatile sig_atomic_t interrupted;
+
+static void handle_interrupt(int sig) {
+    (void)sig;
+    interrupted = 1;
+    atomic_store(&interrupt_state->done, 1);
 }
 
 /**
- * Converte um índice numérico para uma senha
- * Usado para definir os limites de cada worker
- * 
- * @param index Índice numérico da senha
- * @param charset Conjunto de caracteres
- * @param charset_len Tamanho do conjunto
- * @param password_len Comprimento da senha
- * @param output Buffer para armazenar a senha gerada
+ * Identificador do job para o checkpoint: tudo que define o espaço de
+ * busca (e a ordem dos índices) e os alvos
+ */
+static unsigned long long job_id(const char *charset, const char *mask,
+                                 const char *const *custom, int min_len, int max_len,
+                                 const char *wordlist_path, const char *rules_path,
+                                 unsigned long long markov_id, int algo, int spec,
+                                 const md5_target_t *targets, int num_targets, keyspace_index_t total) {
+    unsigned long long id = CHECKPOINT_HASH_INIT;
+    id = checkpoint_hash_str(id, wordlist_path != NULL ? "wordlist" : mask != NULL ? "mask" : "charset");
+    id = checkpoint_hash_str(id, charset);
+    id = checkpoint_hash_str(id, mask);
+    for (int k = 0; k < KEYSPACE_CUSTOM_CHARSETS; k++) {
+        id = checkpoint_hash_str(id, custom[k]);
+    }
+    id = checkpoint_hash_str(id, wordlist_path);
+    id = checkpoint_hash_str(id, rules_path);
+    id = checkpoint_hash(id, &markov_id, sizeof(markov_id));
+    id = checkpoint_hash(id, &min_len, sizeof(min_len));
+    id = checkpoint_hash(id, &max_len, sizeof(max_len));
+    id = checkpoint_hash(id, &total, sizeof(total));
+    id = checkpoint_hash(id, &spec, sizeof(spec));
+    id = checkpoint_hash(id, &algo, sizeof(algo));
+    for (int i = 0; i < num_targets; i++) {
+        id = checkpoint_hash(id, targets[i].digest, hash_algo_get(algo)->digest_len);
+        id = checkpoint_hash(id, targets[i].salt, targets[i].salt_len);
+    }
+    return id;
+}
+
+/**
+ * Hash hexadecimal da senha encontrada, para conferir com o alvo
  */
-void index_to_password(long long index, const char *charset, int charset_len, 
-                       int password_len, char *output) {
-    for (int i = password_len - 1; i >= 0; i--) {
-        output[i] = charset[index % charset_len];
-        index /= charset_len;
+static void result_hash(int algo, int spec, const md5_target_t *target, const char *password,
+                        char output[HASH_HEX_MAX]) {
+    if (algo == HASH_MD5) {
+        md5_spec_string(spec, target, password, output);
+    } else {
+        hash_string(algo, password, output);
     }
-    output[password_len] = '\0';
+}
+
+/**
+ * Modo --table: responde cada alvo pela tabela pré-computada
+ *
+ * @return Código de saída do coordinator
+ */
+static int run_table_lookup(const char *table_path, const char *target_hash, const char *hash_file,
+                            int export_result_file) {
+    static lookup_table_t table;
+    int rc = lookup_table_open(&table, table_path);
+    if (rc == -1) {
+        perror(table_path);
+        return 1;
+    }
+    if (rc == -2) {
+        printf("Deu erro,tabela invalida: %s\n", table_path);
+        return 1;
+    }
+
+    md5_target_t single_target;
+    md5_target_t *targets = &single_target;
+    int num_targets = 1;
+    if (hash_file != NULL) {
+        num_targets = hash_file_load(hash_file, &targets, HASH_MD5, 0);
+        if (num_targets < 0) {
+            perror(hash_file);
+            return 1;
+        }
+        if (num_targets == 0) {
+            printf("Deu erro,nenhum hash valido em %s\n", hash_file);
+            return 1;
+        }
+    } else if (md5_target_parse(target_hash, &single_target) != 0) {
+        printf("Deu erro,hash invalido: %s\n", target_hash);
+        return 1;
+    }
+    LOG(LOG_NORMAL, "Tabela %s: %lld entradas, comprimento %d a %d\n", table_path, table.count,
+        table.keyspace.min_len, table.keyspace.max_len);
+    if (export_result_file) {
+        unlink(RESULT_FILE);
+    }
+
+    printf("\n=== Resultado ===\n");
+    FILE *result_file = NULL;
+    int found = 0, total_probes = 0;
+    double start = progress_now();
+    for (int i = 0; i < num_targets; i++) {
+        char password[MD5_SINGLE_BLOCK_MAX + 1], target_hex[33];
+        int probes;
+        if (!lookup_table_find(&table, &targets[i], password, &probes)) {
+            continue;
+        }
+        found++;
+        total_probes += probes;
+        md5_digest_to_hex(targets[i].digest, target_hex);
+        if (hash_file != NULL) {
+            printf("%s:%s\n", target_hex, password);
+        } else {
+            printf("✓ SENHA ENCONTRADA!\n");
+            printf("Senha: %s\n", password);
+            printf("Hash alvo:      %s\n", target_hex);
+            printf("✓ Hash verificado com sucesso!\n");
+        }
+        // Mesmo formato da busca ("worker_id:password[:hash]"); o worker é a tabela (0)
+        if (export_result_file && result_file == NULL && (result_file = fopen(RESULT_FILE, "w")) == NULL) {
+            perror("Erro ao gravar " RESULT_FILE);
+            export_result_file = 0;
+        }
+        if (result_file != NULL) {
+            fprintf(result_file, hash_file != NULL ? "0:%s:%s\n" : "0:%s\n", password, target_hex);
+        }
+    }
+    double elapsed = progress_now() - start;
+    if (result_file != NULL) {
+        fclose(result_file);
+    }
+
+    if (hash_file != NULL && found > 0) {
+        printf("✓ %d de %d SENHAS ENCONTRADAS!\n", found, num_targets);
+    } else if (found == 0) {
+        printf("✗ Senha não encontrada na tabela.\n");
+    }
+    LOG(LOG_NORMAL, "\n=== Estatísticas da Consulta ===\n");
+    LOG(LOG_NORMAL, "Tempo total de consulta: %.1f microssegundos (%.2f por hash)\n",
+        elapsed * 1e6, elapsed * 1e6 / num_targets);
+    LOG(LOG_VERBOSE, "Entradas lidas por senha encontrada: %.1f\n",
+        found > 0 ? (double)total_probes / found : 0.0);
+    lookup_table_close(&table);
+    return 0;
+}
+
+/**
+ * Mostra (e exporta) os alvos que já estavam no potfile, conferindo cada senha
+ *
+ * @return Número de senhas que não conferem com o hash
+ */
+static int print_known(const potfile_hit_t *known, int num_known, int algo, int spec, int multi,
+                       FILE *result_file) {
+    int mismatches = 0;
+    for (int i = 0; i < num_known; i++) {
+        const md5_target_t *target = &known[i].target;
+        char target_hex[HASH_HEX_MAX], computed_hash[HASH_HEX_MAX];
+        hash_digest_to_hex(algo, target->digest, target_hex);
+        result_hash(algo, spec, target, known[i].password, computed_hash);
+        int verified = strcmp(computed_hash, target_hex) == 0;
+        mismatches += !verified;
+        
+        // Com sal, o alvo aparece como no --hash-file ("hash:sal")
+        const char *salt_sep = spec != MD5_SPEC_PLAIN ? ":" : "";
+        if (multi) {
+            printf("%s%s%.*s:%s (potfile)\n", target_hex, salt_sep, target->salt_len,
+                   (const char*)target->salt, known[i].password);
+        } else {
+            printf("✓ SENHA ENCONTRADA!\n");
+            printf("Origem: potfile (quebrada antes)\n");
+            printf("Senha: %s\n", known[i].password);
+            printf("Hash calculado: %s\n", computed_hash);
+            printf("Hash alvo:      %s%s%.*s\n", target_hex, salt_sep, target->salt_len,
+                   (const char*)target->salt);
+            printf(verified ? "✓ Hash verificado com sucesso!\n" : "✗ ERRO: Hash não confere!\n");
+        }
+        // Mesmo formato da busca ("worker_id:password[:hash]"); o worker é o potfile (0)
+        if (result_file != NULL && multi) {
+            fprintf(result_file, "0:%s:%s%s%.*s\n", known[i].password, target_hex, salt_sep,
+                    target->salt_len, (const char*)target->salt);
+        } else if (result_file != NULL) {
+            fprintf(result_file, "0:%s\n", known[i].password);
+        }
+    }
+    return mismatches;
+}
+
+/**
+ * Todos os alvos já estavam no potfile: resultado sem criar nenhum worker
+ *
+ * @return Código de saída do coordinator
+ */
+static int report_known(const potfile_hit_t *known, int num_known, int algo, int spec, int multi,
+                        int export_result_file) {
+    FILE *result_file = NULL;
+    if (export_result_file) {
+        unlink(RESULT_FILE);
+    }
+    if (export_result_file && (result_file = fopen(RESULT_FILE, "w")) == NULL) {
+        perror("Erro ao gravar " RESULT_FILE);
+    }
+    
+    printf("\n=== Resultado ===\n");
+    if (multi) {
+        printf("✓ %d de %d SENHAS ENCONTRADAS!\n", num_known, num_known);
+    }
+    int mismatches = print_known(known, num_known, algo, spec, multi, result_file);
+    if (multi && mismatches == 0) {
+        printf("✓ Hashes verificados com sucesso!\n");
+    } else if (multi) {
+        printf("✗ ERRO: %d hashes não conferem!\n", mismatches);
+    }
+    if (result_file != NULL) {
+        fclose(result_file);
+    }
+    return 0;
+}
+
+/**
+ * Modo --train-markov: conta os caracteres por posição da wordlist e grava o modelo
+ *
+ * @return Código de saída do coordinator
+ */
+static int run_train_markov(const char *model_path, const char *wordlist_path) {
+    static markov_model_t model;
+    double start = progress_now();
+
+    if (markov_train(&model, wordlist_path) != 0) {
+        perror(wordlist_path);
+        return 1;
+    }
+    if (model.words == 0) {
+        printf("Deu erro,wordlist vazia\n");
+        return 1;
+    }
+    if (markov_save(&model, model_path) != 0) {
+        perror(model_path);
+        return 1;
+    }
+    LOG(LOG_NORMAL, "Modelo Markov gravado em %s: %llu palavras de %s em %.2f segundos\n", model_path,
+        (unsigned long long)model.words, wordlist_path, progress_now() - start);
+    return 0;
 }
 
 /**
  * Função principal do coordenador
  */
 int main(int argc, char *argv[]) {
+    // Início do processo, para o trace (--trace)
+    double main_start = progress_now();
+    
     // TODO 1: Validar argumentos de entrada
     // Verificar se argc == 5 (programa + 4 argumentos)
     // Se não, imprimir mensagem de uso e sair com código 1
     
     // IMPLEMENTE AQUI: verificação de argc e mensagem de erro
-    if (argc != 5) {
-        printf("Deu erro,numero de args errado\n");
+    // Opções vêm antes dos argumentos posicionais
+    int argi = 1;
+    int export_result_file = 1;
+    int use_threads = 0;
+    const char *hash_file = NULL;
+    int min_len = 0, max_len = 0;       // 0 = igual ao <tamanho> (ou à máscara)
+    const char *mask = NULL;
+    const char *wordlist_path = NULL;
+    const char *rules_path = NULL;
+    const char *custom[KEYSPACE_CUSTOM_CHARSETS] = {NULL};
+    const char *checkpoint_path = NULL;
+    int checkpoint_interval = CHECKPOINT_DEFAULT_INTERVAL;
+    int resume = 0;
+    const char *nodes_list = NULL;
+    const char *build_table = NULL;
+    const char *table_path = NULL;
+    const char *trace_path = NULL;
+    int perf = 0;
+    const char *daemon_path = NULL;
+    const char *submit_path = NULL;
+    int priority = 0;
+    int cancel_id = 0;
+    const char *markov_path = NULL;
+    const char *train_markov = NULL;
+    const char *hash_spec = NULL;
+    const char *algo_name = NULL;
+    const char *potfile_path = NULL;
+    while (argi < argc) {
+        if (strcmp(argv[argi], "--no-result-file") == 0) {
+            export_result_file = 0;
+        } else if (strcmp(argv[argi], "--threads") == 0) {
+            use_threads = 1;
+        } else if (strcmp(argv[argi], "--hash-file") == 0 && argi + 1 < argc) {
+            hash_file = argv[++argi];
+        } else if (strcmp(argv[argi], "--min-len") == 0 && argi + 1 < argc) {
+            min_len = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--max-len") == 0 && argi + 1 < argc) {
+            max_len = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--wordlist") == 0 && argi + 1 < argc) {
+            wordlist_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--rules") == 0 && argi + 1 < argc) {
+            rules_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--nodes") == 0 && argi + 1 < argc) {
+            nodes_list = argv[++argi];
+        } else if (strcmp(argv[argi], "--build-table") == 0 && argi + 1 < argc) {
+            build_table = argv[++argi];
+        } else if (strcmp(argv[argi], "--table") == 0 && argi + 1 < argc) {
+            table_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--trace") == 0 && argi + 1 < argc) {
+            trace_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--perf") == 0) {
+            perf = 1;
+        } else if (strcmp(argv[argi], "--daemon") == 0 && argi + 1 < argc) {
+            daemon_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--submit") == 0 && argi + 1 < argc) {
+            submit_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--priority") == 0 && argi + 1 < argc) {
+            priority = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--cancel") == 0 && argi + 1 < argc) {
+            cancel_id = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--hash-spec") == 0 && argi + 1 < argc) {
+            hash_spec = argv[++argi];
+        } else if (strcmp(argv[argi], "--algo") == 0 && argi + 1 < argc) {
+            algo_name = argv[++argi];
+        } else if (strcmp(argv[argi], "--potfile") == 0 && argi + 1 < argc) {
+            potfile_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--markov") == 0 && argi + 1 < argc) {
+            markov_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--train-markov") == 0 && argi + 1 < argc) {
+            train_markov = argv[++argi];
+        } else if (strcmp(argv[argi], "--checkpoint") == 0 && argi + 1 < argc) {
+            checkpoint_path = argv[++argi];
+        } else if (strcmp(argv[argi], "--checkpoint-interval") == 0 && argi + 1 < argc) {
+            checkpoint_interval = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--resume") == 0 && argi + 1 < argc) {
+            checkpoint_path = argv[++argi];
+            resume = 1;
+        } else if (strcmp(argv[argi], "--mask") == 0 && argi + 1 < argc) {
+            mask = argv[++argi];
+        } else if (argv[argi][0] == '-' && argv[argi][1] >= '1' &&
+                   argv[argi][1] < '1' + KEYSPACE_CUSTOM_CHARSETS && argv[argi][2] == '\0' &&
+                   argi + 1 < argc) {
+            custom[argv[argi][1] - '1'] = argv[argi + 1];
+            argi++;
+        } else if (!log_parse_option(argv[argi])) {
+            break;
+        }
+        argi++;
+    }
+    
+    // Daemon: só o número de threads do pool; cancelamento: nenhum argumento posicional
+    if (daemon_path != NULL && argc - argi == 1 && submit_path == NULL) {
+        int threads = atoi(argv[argi]);
+        if (threads == 0) {
+            threads = thread_engine_online_cpus();
+        }
+        if (threads < 1 || threads > THREAD_ENGINE_MAX_THREADS) {
+            printf("Deu erro,numero de threads esta invalido\n");
+            return 1;
+        }
+        return daemon_serve(daemon_path, threads);
+    }
+    if (submit_path != NULL && cancel_id != 0 && argc == argi) {
+        return daemon_cancel(submit_path, cancel_id);
+    }
+    
+    // Treino do modelo Markov: só a wordlist
+    if (train_markov != NULL && argc - argi == 1) {
+        return run_train_markov(train_markov, argv[argi]);
+    }
+    
+    // Consulta a uma tabela: só o <hash_md5> (ou --hash-file)
+    if (table_path != NULL && argc - argi == (hash_file == NULL) && build_table == NULL &&
+        algo_name == NULL && potfile_path == NULL) {
+        return run_table_lookup(table_path, hash_file == NULL ? argv[argi] : NULL, hash_file,
+                                export_result_file);
+    }
+    
+    // Com --hash-file (ou --build-table), o <hash_md5> sai dos argumentos posicionais;
+    // com --mask ou --wordlist, <tamanho> e <charset>
+    int generated = mask == NULL && wordlist_path == NULL;
+    if (table_path != NULL || daemon_path != NULL || cancel_id != 0 || train_markov != NULL ||
+        ((hash_spec != NULL || algo_name != NULL || potfile_path != NULL) && build_table != NULL) ||
+        (markov_path != NULL && (wordlist_path != NULL || build_table != NULL)) ||
+        (submit_path != NULL && (use_threads || nodes_list != NULL || checkpoint_path != NULL ||
+                                 build_table != NULL)) ||
+        argc - argi != 4 - (hash_file != NULL || build_table != NULL) - (generated ? 0 : 2) ||
+        (mask != NULL && wordlist_path != NULL) || (rules_path != NULL && wordlist_path == NULL) ||
+        (build_table != NULL && (wordlist_path != NULL || hash_file != NULL))) {
+        printf("Uso: %s [-q|-v|--trace-candidates] [--no-result-file] [--threads] [--min-len N] [--max-len M] <hash_md5> <tamanho> <charset> <num_workers>\n", argv[0]);
+        printf("     %s [opções] --hash-file <arquivo> <tamanho> <charset> <num_workers>\n", argv[0]);
+        printf("     %s [opções] --mask <máscara> [-1 <charset>..-4 <charset>] <hash_md5> <num_workers>\n", argv[0]);
+        printf("     %s [opções] --wordlist <arquivo> [--rules <arquivo>] <hash_md5> <num_workers>\n", argv[0]);
+        printf("     %s [opções] --nodes <host:porta,...> ... <threads_por_no>\n", argv[0]);
+        printf("     %s [opções] --hash-spec \"md5(salt.pass)\"|\"md5(pass.salt)\" <hash:sal> ... (ou --hash-file com hash:sal)\n", argv[0]);
+        printf("     %s [opções] --algo md5|md4|ntlm|sha1|sha256 ...\n", argv[0]);
+        printf("     %s [opções] --markov <modelo> ... | --train-markov <modelo> <wordlist>\n", argv[0]);
+        printf("     %s [opções] --potfile <arquivo> ...\n", argv[0]);
+        printf("     %s [opções] --checkpoint <arquivo> [--checkpoint-interval S] | --resume <arquivo> ...\n", argv[0]);
+        printf("     %s [opções] --daemon <socket> <num_threads>\n", argv[0]);
+        printf("     %s [opções] --submit <socket> [--priority N] ... <max_threads> | --submit <socket> --cancel <id>\n", argv[0]);
+        printf("     %s [opções] --trace <arquivo.json> [--perf] ...\n", argv[0]);
+        printf("     %s [opções] --build-table <arquivo> <tamanho> <charset> <num_threads>   (ou --mask <máscara> <num_threads>)\n", argv[0]);
+        printf("     %s [opções] --table <arquivo> <hash_md5> | --table <arquivo> --hash-file <arquivo>\n", argv[0]);
+        printf("Exemplo: %s 900150983cd24fb0d6963f7d28e17f72 3 abc 4\n", argv[0]);
         return 1;
     }
     
-    // Parsing dos argumentos (após validação)
-    const char *target_hash = argv[1];
-    int password_len = atoi(argv[2]);
-    const char *charset = argv[3];
-    int num_workers = atoi(argv[4]);
+    // Parsing dos argumentos (após validação); "-" = alvos na região compartilhada
+    // (e, com --mask/--wordlist, charset "-": o worker recebe --mask/--charsetN ou --wordlist/--rules)
+    const char *target_hash = "-";
+    int password_len = 0;
+    const char *charset = "-";
+    if (hash_file == NULL && build_table == NULL) {
+        target_hash = argv[argi++];
+    }
+    if (generated) {
+        password_len = atoi(argv[argi++]);
+        charset = argv[argi++];
+    }
+    int num_workers = atoi(argv[argi]);
     int charset_len = strlen(charset);
+    int spec = MD5_SPEC_PLAIN;
+    if (hash_spec != NULL && (spec = md5_spec_parse(hash_spec)) < 0) {
+        printf("Deu erro,formato de hash invalido: %s (use md5, md5(salt.pass) ou md5(pass.salt))\n",
+               hash_spec);
+        return 1;
+    }
+    int algo = HASH_MD5;
+    if (algo_name != NULL && (algo = hash_algo_parse(algo_name)) < 0) {
+        printf("Deu erro,algoritmo invalido: %s (use md5, md4, ntlm, sha1 ou sha256)\n", algo_name);
+        return 1;
+    }
+    if (algo != HASH_MD5 && spec != MD5_SPEC_PLAIN) {
+        printf("Deu erro,formato com sal so existe para md5\n");
+        return 1;
+    }
+    const hash_algo_t *algo_info = hash_algo_get(algo);
+    int wordlist_max_default = wordlist_path != NULL && max_len == 0;
     
     // TODO: Adicionar validações dos parâmetros
-    // - password_len deve estar entre 1 e 10
-    if (password_len < 1 || password_len > 10) {
-        printf("Deu erro,tamanho de senha esta invalido\n");
-        return 1;
+    // - password_len deve estar entre 1 e MD5_SINGLE_BLOCK_MAX (assim como --min-len/--max-len,
+    //   com min <= max): todo candidato cabe num único bloco MD5
+    if (wordlist_path != NULL) {
+        // Wordlist: sem <tamanho>; por padrão, qualquer palavra que caiba num bloco MD5
+        if (min_len == 0) {
+            min_len = 1;
+        }
+        if (max_len == 0) {
+            max_len = MD5_SINGLE_BLOCK_MAX;
+        }
+        if (min_len < 1 || max_len > MD5_SINGLE_BLOCK_MAX || min_len > max_len) {
+            printf("Deu erro,tamanho de senha esta invalido\n");
+            return 1;
+        }
+        password_len = min_len;
+    } else if (mask == NULL) {
+        if (min_len == 0) {
+            min_len = password_len;
+        }
+        if (max_len == 0) {
+            max_len = password_len;
+        }
+        if (password_len < 1 || password_len > MD5_SINGLE_BLOCK_MAX ||
+            min_len < 1 || max_len > MD5_SINGLE_BLOCK_MAX || min_len > max_len) {
+            printf("Deu erro,tamanho de senha esta invalido\n");
+            return 1;
+        }
     }
 
-    // - num_workers deve estar entre 1 e MAX_WORKERS
-    if (num_workers < 1 || num_workers > MAX_WORKERS) {
+    // - num_workers deve estar entre 1 e MAX_WORKERS (0 = um por CPU online;
+    //   nós: threads por nó, 0 = todas as CPUs de cada nó; daemon: threads do pool
+    //   para o job, 0 = todas)
+    static dispatch_node_t nodes[DISPATCH_MAX_NODES];
+    int num_nodes = 0;
+    if (nodes_list == NULL && submit_path == NULL && num_workers == 0) {
+        num_workers = thread_engine_online_cpus();
+    }
+    if (num_workers < 0 || num_workers > MAX_WORKERS) {
         printf("Deu erro,numero de workers esta invalido\n");
         return 1;
     }
+    if (nodes_list != NULL &&
+        (num_nodes = dispatcher_parse_nodes(nodes_list, nodes, DISPATCH_MAX_NODES)) < 1) {
+        printf("Deu erro,lista de nos invalida (use host:porta,host:porta)\n");
+        return 1;
+    }
     // - charset not null/empty
     if (charset_len == 0) {
         printf("Deu erro,charset esta vazio\n");
         return 1;
     }
-
+    if (checkpoint_interval < 1) {
+        printf("Deu erro,intervalo de checkpoint invalido\n");
+        return 1;
+    }
     
-    printf("=== Mini-Projeto 1: Quebra de Senhas Paralelo ===\n");
-    printf("Hash MD5 alvo: %s\n", target_hash);
-    printf("Tamanho da senha: %d\n", password_len);
-    printf("Charset: %s (tamanho: %d)\n", charset, charset_len);
-    printf("Número de workers: %d\n", num_workers);
+    // Espaço de busca: todos os comprimentos em sequência, um charset por posição,
+    // ou os bytes da wordlist (mapeada aqui só para medir e validar)
+    static keyspace_t keyspace;
+    wordlist_t wordlist;
+    rule_set_t rules;
+    if (wordlist_path != NULL) {
+        if (wordlist_open(&wordlist, wordlist_path) != 0) {
+            perror(wordlist_path);
+            return 1;
+        }
+        if (wordlist.size == 0) {
+            printf("Deu erro,wordlist vazia\n");
+            return 1;
+        }
+        int num_rules = rule_set_load(&rules, rules_path, 1);
+        if (num_rules < 0) {
+            perror(rules_path);
+            return 1;
+        }
+        if (num_rules == 0) {
+            printf("Deu erro,nenhuma regra valida em %s\n", rules_path);
+            return 1;
+        }
+    } else if (mask != NULL) {
+        if (keyspace_init_mask(&keyspace, mask, custom, min_len, max_len) != 0) {
+            printf("Deu erro,mascara invalida (ou espaco de busca grande demais)\n");
+            return 1;
+        }
+        min_len = keyspace.min_len;
+        max_len = keyspace.max_len;
+        password_len = min_len;
+    } else if (keyspace_init(&keyspace, charset, charset_len, min_len, max_len) != 0) {
+        printf("Deu erro,espaco de busca grande demais\n");
+        return 1;
+    }
     
-    // Calcular espaço de busca total
-    long long total_space = calculate_search_space(charset_len, password_len);
-    printf("Espaço de busca total: %lld combinações\n\n", total_space);
+    // Ordem por probabilidade: os charsets de cada posição são reordenados pelo modelo
+    static markov_model_t markov;
+    if (markov_path != NULL) {
+        int rc = markov_load(&markov, markov_path);
+        if (rc == -1) {
+            perror(markov_path);
+            return 1;
+        }
+        if (rc == -2) {
+            printf("Deu erro,modelo markov invalido: %s\n", markov_path);
+            return 1;
+        }
+        if (markov_apply(&markov, &keyspace) != 0) {
+            printf("Deu erro,charsets grandes demais para a ordem markov\n");
+            return 1;
+        }
+    }
     
-    // Remover arquivo de resultado anterior se existir
-    unlink(RESULT_FILE);
+    if (build_table != NULL) {
+        char total_str[KEYSPACE_INDEX_DIGITS];
+        LOG(LOG_NORMAL, "Construindo tabela %s: %s candidatos (%.0f bytes), %d threads\n", build_table,
+            keyspace_index_format(keyspace.total, total_str),
+            (double)keyspace.total * sizeof(lookup_entry_t), num_workers);
+        double build_start = progress_now();
+        if (lookup_table_build(build_table, &keyspace, mask == NULL ? charset : NULL, mask,
+                               custom, num_workers) != 0) {
+            if (errno == EFBIG) {
+                printf("Deu erro,espaco grande demais para uma tabela (maximo %lld candidatos)\n",
+                       LOOKUP_MAX_ENTRIES);
+            } else {
+                perror(build_table);
+            }
+            return 1;
+        }
+        LOG(LOG_NORMAL, "Tabela gravada em %s em %.2f segundos\n", build_table, progress_now() - build_start);
+        return 0;
+    }
     
-    // Registrar tempo de início
-    time_t start_time = time(NULL);
+    // Alvos: um só (argv) ou a lista do --hash-file, decodificados uma vez
+    md5_target_t single_target = {0};     // Zerado: um hash inválido não deixa sal indefinido
+    md5_target_t *targets = &single_target;
+    int num_targets = 1;
+    int valid_target = 1;
+    if (hash_file != NULL) {
+        num_targets = hash_file_load(hash_file, &targets, algo, spec != MD5_SPEC_PLAIN);
+        if (num_targets < 0) {
+            perror(hash_file);
+            return 1;
+        }
+        if (num_targets == 0) {
+            printf("Deu erro,nenhum hash valido em %s\n", hash_file);
+            return 1;
+        }
+    } else if ((spec != MD5_SPEC_PLAIN ? md5_target_parse_salted(target_hash, &single_target)
+                                       : hash_target_parse(algo, target_hash, &single_target)) != 0) {
+        valid_target = 0;
+    }
+    
+    // O bloco único de cada algoritmo tem o seu limite (NTLM: 2 bytes por caractere)
+    if (wordlist_max_default && max_len > algo_info->max_len) {
+        max_len = algo_info->max_len;
+    }
+    if (max_len > algo_info->max_len) {
+        printf("Deu erro,tamanho de senha esta invalido (maximo %d para %s)\n", algo_info->max_len,
+               algo_info->label);
+        return 1;
+    }
+    
+    // Com sal, o bloco final leva o resto do sal: o maior comprimento depende do maior sal
+    if (spec != MD5_SPEC_PLAIN && valid_target) {
+        int limit = MD5_SINGLE_BLOCK_MAX;
+        for (int i = 0; i < num_targets; i++) {
+            int target_limit = md5_spec_max_len(spec, targets[i].salt_len);
+            limit = target_limit < limit ? target_limit : limit;
+        }
+        if (wordlist_max_default && max_len > limit) {
+            max_len = limit;
+        }
+        if (max_len > limit || min_len > max_len) {
+            if (limit < 1) {
+                printf("Deu erro,sal longo demais para o formato %s\n", md5_spec_name(spec));
+            } else {
+                printf("Deu erro,sal longo demais para o tamanho de senha (maximo %d)\n", limit);
+            }
+            return 1;
+        }
+    }
+    
+    // Potfile: alvos já quebrados em outra execução saem da busca; se nenhum sobra,
+    // o resultado sai sem criar workers. Com --checkpoint/--resume os alvos ficam
+    // todos (o checkpoint guarda as senhas pela posição do alvo na lista)
+    static potfile_t potfile;
+    potfile_hit_t *known = NULL;
+    int num_known = 0, total_targets = num_targets;
+    if (potfile_path != NULL) {
+        if (potfile_open(&potfile, potfile_path) != 0) {
+            perror(potfile_path);
+            return 1;
+        }
+        if (valid_target && checkpoint_path == NULL &&
+            (num_known = potfile_filter(&potfile, algo, spec, targets, &num_targets, &known)) < 0) {
+            perror("Erro ao consultar o potfile");
+            return 1;
+        }
+        LOG(LOG_NORMAL, "Potfile %s: %lld entradas (%lld novas no índice), %d de %d alvos já quebrados\n",
+            potfile_path, potfile.count, potfile.indexed, num_known, total_targets);
+        if (num_targets == 0) {
+            int rc = report_known(known, num_known, algo, spec, hash_file != NULL, export_result_file);
+            potfile_close(&potfile);
+            free(known);
+            return rc;
+        }
+    }
+    
+    LOG(LOG_NORMAL, "=== Mini-Projeto 1: Quebra de Senhas Paralelo ===\n");
+    if (hash_file != NULL && num_known > 0) {
+        LOG(LOG_NORMAL, "Hashes %s alvo: %d de %d (de %s; os outros já estão no potfile)\n",
+            algo_info->label, num_targets, total_targets, hash_file);
+    } else if (hash_file != NULL) {
+        LOG(LOG_NORMAL, "Hashes %s alvo: %d (de %s)\n", algo_info->label, num_targets, hash_file);
+    } else {
+        LOG(LOG_NORMAL, "Hash %s alvo: %s\n", algo_info->label, target_hash);
+    }
+    if (spec != MD5_SPEC_PLAIN) {
+        LOG(LOG_NORMAL, "Formato: %s\n", md5_spec_name(spec));
+    }
+    if (min_len == max_len) {
+        LOG(LOG_NORMAL, "Tamanho da senha: %d\n", min_len);
+    } else {
+        LOG(LOG_NORMAL, "Tamanho da senha: %d a %d\n", min_len, max_len);
+    }
+    if (wordlist_path != NULL) {
+        LOG(LOG_NORMAL, "Wordlist: %s (%lld bytes)\n", wordlist_path, wordlist.size);
+        LOG(LOG_NORMAL, "Regras: %d%s%s\n", rules.count, rules_path != NULL ? " de " : "",
+            rules_path != NULL ? rules_path : "");
+    } else if (mask != NULL) {
+        LOG(LOG_NORMAL, "Máscara: %s (%d posições)\n", mask, keyspace.positions);
+        for (int i = 0; i < keyspace.positions; i++) {
+            LOG(LOG_VERBOSE, "  Posição %d: %s (tamanho: %d)\n", i + 1, keyspace.charset[i], keyspace.radix[i]);
+        }
+    } else {
+        LOG(LOG_NORMAL, "Charset: %s (tamanho: %d)\n", charset, charset_len);
+    }
+    if (markov_path != NULL) {
+        LOG(LOG_NORMAL, "Ordem: por probabilidade (modelo %s, %llu palavras)\n", markov_path,
+            (unsigned long long)markov.words);
+        for (int i = 0; i < keyspace.max_len; i++) {
+            LOG(LOG_VERBOSE, "  Posição %d: %s\n", i + 1, keyspace.charset[i]);
+        }
+    }
+    if (nodes_list != NULL) {
+        LOG(LOG_NORMAL, "Nós: %d (%s)\n", num_nodes, nodes_list);
+    } else if (submit_path != NULL) {
+        LOG(LOG_NORMAL, "Daemon: %s (prioridade %d, %d threads%s)\n", submit_path, priority, num_workers,
+            num_workers == 0 ? " = o pool inteiro" : "");
+    } else {
+        LOG(LOG_NORMAL, "Número de workers: %d%s\n", num_workers, use_threads ? " (threads)" : "");
+    }
+    LOG(LOG_VERBOSE, "Kernel MD5: %s (%d lanes)\n", md5_kernel_name(), md5_kernel_lanes());
+    
+    // Calcular espaço de busca total (na wordlist, em bytes: o número de palavras só
+    // seria conhecido lendo o arquivo inteiro)
+    // (índices de 128 bits: o total pode passar de 2^63)
+    keyspace_index_t total_space = wordlist_path != NULL ? wordlist.size : keyspace.total;
+    const char *space_unit = wordlist_path != NULL ? "bytes" : "combinações";
+    char total_str[KEYSPACE_INDEX_DIGITS];
+    keyspace_index_format(total_space, total_str);
+    LOG(LOG_NORMAL, "Espaço de busca total: %s %s\n\n", total_str, space_unit);
+    
+    // Remover arquivo de resultado anterior se existir (com --no-result-file, o
+    // arquivo é de outra execução e fica como está)
+    if (export_result_file) {
+        unlink(RESULT_FILE);
+    }
+    
+    // Região compartilhada (flag de parada + um slot de resultado por alvo), criada antes do fork()
+    int shm_fd;
+    shared_state_t *shared = shared_state_create(num_targets, &shm_fd);
+    if (shared == NULL) {
+        perror("Erro ao criar memória compartilhada");
+        return 1;
+    }
+    for (int i = 0; i < num_targets; i++) {
+        shared_state_set_target(shared, i, &targets[i]);
+    }
+    char shm_fd_opt[24];
+    snprintf(shm_fd_opt, sizeof(shm_fd_opt), "--shm-fd=%d", shm_fd);
     
     // TODO 2: Dividir o espaço de busca entre os workers
-    // Calcular quantas senhas cada worker deve verificar
-    // DICA: Use divisão inteira e distribua o resto entre os primeiros workers
-
+    // Os workers retiram chunks de tamanho adaptativo de um cursor compartilhado
+    // (scheduler.c): quem é mais rápido pega mais chunks
+    // Com --resume, a execução começa no watermark gravado (e as senhas já achadas
+    // voltam para os seus slots): ele vira a base, a posição 0 do escalonador
+    keyspace_index_t resume_from = 0;
+    checkpoint_t checkpoint = {0};
+    if (checkpoint_path != NULL) {
+        checkpoint.path = checkpoint_path;
+        checkpoint.job_id = job_id(charset, mask, custom, min_len, max_len, wordlist_path, rules_path,
+                                   markov_path != NULL ? markov.id : 0, algo, spec, targets, num_targets,
+                                   total_space);
+        checkpoint.total = total_space;
+        checkpoint.interval = checkpoint_interval;
+        checkpoint.shared = shared;
+    }
+    if (resume) {
+        int rc = checkpoint_load(checkpoint_path, checkpoint.job_id, total_space, shared, &resume_from);
+        if (rc == -1) {
+            perror(checkpoint_path);
+            return 1;
+        }
+        if (rc == -2) {
+            printf("Deu erro,checkpoint invalido ou de outra busca: %s\n", checkpoint_path);
+            return 1;
+        }
+        char resume_str[KEYSPACE_INDEX_DIGITS];
+        LOG(LOG_NORMAL, "Retomando de %s: %s de %s %s já verificados (%.1f%%)\n", checkpoint_path,
+            keyspace_index_format(resume_from, resume_str), total_str, space_unit,
+            100.0 * (double)resume_from / (double)total_space);
+    }
+    checkpoint.base = resume_from;
+    
+    // O cursor do escalonador é de 64 bits: acima de KEYSPACE_WINDOW_MAX candidatos,
+    // esta execução cobre só o começo do que falta (o resto, com --checkpoint/--resume)
+    // (no modo distribuído, cada nó é um worker do escalonador; com --submit, o daemon)
+    long long window = keyspace_window(total_space, resume_from);
+    scheduler_init(&shared->sched, 0, window,
+                   nodes_list != NULL ? num_nodes : submit_path != NULL ? 1 : num_workers);
+    if (window < total_space - resume_from) {
+        LOG(LOG_QUIET, "Espaço maior que 2^62: esta execução cobre os próximos %lld %s "
+            "(use --checkpoint para continuar depois)\n", window, space_unit);
+    }
     
-    // IMPLEMENTE AQUI:
-    long long passwords_per_worker = total_space / num_workers;
-    long long remaining = total_space % num_workers;
+    if (checkpoint_path != NULL) {
+        // Sem SA_RESTART: o waitpid do laço abaixo volta com EINTR e é refeito
+        interrupt_state = shared;
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = handle_interrupt;
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+        LOG(LOG_NORMAL, "Checkpoint em %s a cada %d segundos\n", checkpoint_path, checkpoint_interval);
+    }
     
+    if (wordlist_path != NULL) {
+        LOG(LOG_NORMAL, "Wordlist distribuída em chunks dinâmicos de bytes (alinhados em linhas)\n");
+    } else {
+        char first_password[MD5_SINGLE_BLOCK_MAX + 1], last_password[MD5_SINGLE_BLOCK_MAX + 1];
+        keyspace_password(&keyspace, 0, first_password);
+        keyspace_password(&keyspace, total_space - 1, last_password);
+        LOG(LOG_NORMAL, "Espaço %s até %s distribuído em chunks dinâmicos\n", first_password, last_password);
+    }
     
-    // Arrays para armazenar PIDs dos workers
-    pid_t workers[MAX_WORKERS];
+    // Contadores de hardware: testados aqui uma vez, para avisar só uma vez
+    if (perf && instr_perf_available() != 0) {
+        fprintf(stderr, "Aviso: contadores de hardware indisponíveis (perf_event_open: %s); "
+                "--perf ignorado\n", strerror(errno));
+        perf = 0;
+    }
+    if (trace_path != NULL && (nodes_list != NULL || submit_path != NULL)) {
+        LOG(LOG_NORMAL, "Trace: só os eventos do coordinator (%s não grava fragmentos)\n",
+            nodes_list != NULL ? "os nós" : "o daemon");
+    }
     
-    // TODO 3: Criar os processos workers usando fork()
-    printf("Iniciando workers...\n");
-
-
-    // IMPLEMENTE AQUI: Loop para criar workers
-    for (int i = 0; i < num_workers; i++) {
-        // Calcular intervalo de senhas para este worker
-        long long start_index = i * passwords_per_worker;
-        if (i < remaining) {
-            start_index += i;
+    // Registrar tempo de início (relógio monotônico, resolução abaixo de 1 s)
+    double start_time = progress_now();
+    instr_t coord_instr;
+    instr_begin(&coord_instr, NULL, trace_path, INSTR_COORDINATOR, 0, main_start);
+    instr_event(&coord_instr, "inicialização", main_start, start_time, NULL);
+    
+    int dispatch_failed = 0;
+    // O daemon e os nós montam o espaço de busca e os alvos a partir dos parâmetros do job
+    net_job_t net_job = {
+        .min_len = min_len, .max_len = max_len, .threads = num_workers, .priority = priority,
+        .multi = hash_file != NULL, .total = total_space, .base = resume_from,
+        .charset = generated ? charset : NULL, .mask = mask,
+        .wordlist = wordlist_path, .rules = rules_path,
+        .markov = markov_path, .markov_id = markov.id, .spec = spec, .algo = algo,
+        .num_targets = num_targets, .targets = targets
+    };
+    memcpy(net_job.custom, custom, sizeof(net_job.custom));
+    if (submit_path != NULL) {
+        if (!valid_target) {
+            fprintf(stderr, "Hash alvo inválido: %s (nenhuma senha pode corresponder)\n", target_hash);
         } else {
-            start_index += remaining;
+            fflush(stdout);
+            double submit_start = progress_now();
+            if (daemon_submit(submit_path, &net_job, shared) != 0) {
+                return 1;
+            }
+            instr_event(&coord_instr, "daemon", submit_start, progress_now(), NULL);
         }
-        
-        long long worker_passwords = passwords_per_worker;
-        if (i < remaining) {
-            worker_passwords++;
+        LOG(LOG_NORMAL, "O daemon terminou o job.\n");
+    } else if (nodes_list != NULL) {
+        if (!valid_target) {
+            fprintf(stderr, "Hash alvo inválido: %s (nenhuma senha pode corresponder)\n", target_hash);
+        } else {
+            if (checkpoint_path != NULL && checkpoint_start(&checkpoint) != 0) {
+                fprintf(stderr, "Erro ao iniciar thread de checkpoint (só o final será gravado)\n");
+            }
+            fflush(stdout);
+            double dispatch_start = progress_now();
+            dispatch_failed = dispatcher_run(&net_job, shared, nodes, num_nodes) != 0;
+            instr_event(&coord_instr, "nós", dispatch_start, progress_now(), NULL);
         }
+        LOG(LOG_NORMAL, "Todos os %d nós terminaram.\n", num_nodes);
+    } else if (use_threads) {
+        // Alvos decodificados (e revertidos por comprimento) uma única vez para todas as threads
+        static search_job_t job;
+        if (search_job_prepare(&job, min_len, max_len, targets, num_targets, hash_file != NULL, algo,
+                               spec, shared) != 0) {
+            perror("Erro ao montar conjunto de alvos");
+            return 1;
+        }
+        if (wordlist_path != NULL) {
+            job.wordlist = &wordlist;
+            job.rules = &rules;
+        } else {
+            job.keyspace = &keyspace;
+        }
+        job.trace_path = trace_path;
+        job.perf = perf;
+        job.base = resume_from;
         
-        long long end_index = start_index + worker_passwords - 1;
-        
-        // Converter indices para senhas de inicio e fim
-        char start_password[11], end_password[11];
-        index_to_password(start_index, charset, charset_len, password_len, start_password);
-        index_to_password(end_index, charset, charset_len, password_len, end_password);
-        
-        printf("Worker %d: %s até %s (%lld senhas)\n", i, start_password, end_password, worker_passwords);
+        if (!valid_target) {
+            fprintf(stderr, "Hash alvo inválido: %s (nenhuma senha pode corresponder)\n", target_hash);
+        } else {
+            fflush(stdout);
+            if (checkpoint_path != NULL && checkpoint_start(&checkpoint) != 0) {
+                fprintf(stderr, "Erro ao iniciar thread de checkpoint (só o final será gravado)\n");
+            }
+            double threads_start = progress_now();
+            if (thread_engine_run(&job, num_workers) != 0) {
+                return 1;
+            }
+            instr_event(&coord_instr, "threads", threads_start, progress_now(), NULL);
+        }
+        search_job_free(&job);
+        LOG(LOG_NORMAL, "Todas as %d threads terminaram.\n", num_workers);
+    } else {
+        // Arrays para armazenar PIDs dos workers
+        pid_t workers[MAX_WORKERS];
         
-        // TODO 4: Usar fork() para criar processo filho
-        pid_t pid = fork();
+        // Opções do worker que dependem do modo, montadas uma vez antes dos fork()
+        // (sem buracos: o primeiro NULL termina a lista do execl)
+        char max_len_str[12];
+        snprintf(max_len_str, sizeof(max_len_str), "%d", max_len);
+        const char *worker_opts[3 + KEYSPACE_CUSTOM_CHARSETS + 6] = {NULL};
+        int num_opts = 0;
+        worker_opts[num_opts++] = make_option("--max-len", max_len_str);
+        if (wordlist_path != NULL) {
+            worker_opts[num_opts++] = make_option("--wordlist", wordlist_path);
+            if (rules_path != NULL) {
+                worker_opts[num_opts++] = make_option("--rules", rules_path);
+            }
+        } else if (mask != NULL) {
+            worker_opts[num_opts++] = make_option("--mask", mask);
+            for (int k = 0; k < KEYSPACE_CUSTOM_CHARSETS; k++) {
+                if (custom[k] != NULL) {
+                    char name[16];
+                    snprintf(name, sizeof(name), "--charset%d", k + 1);
+                    worker_opts[num_opts++] = make_option(name, custom[k]);
+                }
+            }
+        }
+        if (markov_path != NULL) {
+            worker_opts[num_opts++] = make_option("--markov", markov_path);
+        }
+        if (spec != MD5_SPEC_PLAIN) {
+            worker_opts[num_opts++] = make_option("--hash-spec", hash_spec);
+        }
+        if (algo != HASH_MD5) {
+            worker_opts[num_opts++] = make_option("--algo", algo_info->name);
+        }
+        if (trace_path != NULL) {
+            worker_opts[num_opts++] = make_option("--trace", trace_path);
+        }
+        if (perf) {
+            worker_opts[num_opts++] = "--perf";
+        }
+        worker_opts[num_opts++] = log_level_option();
+    
+        // TODO 3: Criar os processos workers usando fork()
+        LOG(LOG_NORMAL, "Iniciando workers...\n");
+        fflush(stdout);  // Evita que os filhos herdem (e repitam) o buffer de saída
+
+
+        // IMPLEMENTE AQUI: Loop para criar workers
+        for (int i = 0; i < num_workers; i++) {
+            // TODO 4: Usar fork() para criar processo filho
+            double fork_start = progress_now();
+            pid_t pid = fork();
         
-        if (pid == -1) {
-            // TODO 7: Tratar erros de fork()
-            perror("Erro ao criar processo worker");
-            exit(1);
-        } else if (pid == 0) {
-            // TODO 6: No processo filho: usar execl() para executar worker
-            char worker_id_str[10], password_len_str[10];
-            snprintf(worker_id_str, sizeof(worker_id_str), "%d", i);
-            snprintf(password_len_str, sizeof(password_len_str), "%d", password_len);
+            if (pid == -1) {
+                // TODO 7: Tratar erros de fork()
+                perror("Erro ao criar processo worker");
+                exit(1);
+            } else if (pid == 0) {
+                // TODO 6: No processo filho: usar execl() para executar worker
+                // O worker recebe o intervalo da execução inteira (base + quantidade,
+                // ver keyspace_window); os chunks em si vêm do escalonador na região
+                // compartilhada (o <tamanho> do worker é o menor comprimento; --max-len o maior)
+                char worker_id_str[10], password_len_str[12], base_str[KEYSPACE_INDEX_DIGITS], count_str[24];
+                snprintf(worker_id_str, sizeof(worker_id_str), "%d", i);
+                snprintf(password_len_str, sizeof(password_len_str), "%d", min_len);
+                keyspace_index_format(resume_from, base_str);
+                snprintf(count_str, sizeof(count_str), "%lld", window);
             
-            execl("./worker", "worker", target_hash, start_password, end_password, 
-                  charset, password_len_str, worker_id_str, NULL);
+                // A opção de verbosidade é a última de worker_opts; no nível padrão ela
+                // é NULL e simplesmente termina a lista de argumentos mais cedo
+                execl("./worker", "worker", target_hash, base_str, count_str, 
+                      charset, password_len_str, worker_id_str, shm_fd_opt,
+                      worker_opts[0], worker_opts[1], worker_opts[2], worker_opts[3],
+                      worker_opts[4], worker_opts[5], worker_opts[6], worker_opts[7],
+                      worker_opts[8], worker_opts[9], worker_opts[10], worker_opts[11],
+                      worker_opts[12], NULL);
             
-            // TODO 7: Tratar erros de execl()
-            perror("Erro ao executar worker");
-            exit(1);
-        } else {
-            // TODO 5: No processo pai: armazenar PID
-            workers[i] = pid;
+                // TODO 7: Tratar erros de execl()
+                perror("Erro ao executar worker");
+                exit(1);
+            } else {
+                // TODO 5: No processo pai: armazenar PID
+                workers[i] = pid;
+                if (trace_path != NULL) {
+                    char args[48];
+                    snprintf(args, sizeof(args), "{\"worker\": %d, \"pid\": %d}", i, (int)pid);
+                    instr_event(&coord_instr, "fork", fork_start, progress_now(), args);
+                }
+            }
         }
-    }
     
-    printf("\nTodos os workers foram iniciados. Aguardando conclusão...\n");
+        LOG(LOG_NORMAL, "\nTodos os workers foram iniciados. Aguardando conclusão...\n");
+        fflush(stdout);
+        
+        // Thread de checkpoint só depois dos fork(): os filhos não herdam threads
+        if (checkpoint_path != NULL && checkpoint_start(&checkpoint) != 0) {
+            fprintf(stderr, "Erro ao iniciar thread de checkpoint (só o final será gravado)\n");
+        }
     
-    // TODO 8: Aguardar todos os workers terminarem usando wait()
-    // IMPORTANTE: O pai deve aguardar TODOS os filhos para evitar zumbis
+        // TODO 8: Aguardar todos os workers terminarem usando wait()
+        // IMPORTANTE: O pai deve aguardar TODOS os filhos para evitar zumbis
     
-    // IMPLEMENTE AQUI:
-    // - Loop para aguardar cada worker terminar
-    // - Usar wait() para capturar status de saída
-    // - Identificar qual worker terminou
-    // - Verificar se terminou normalmente ou com erro
-    // - Contar quantos workers terminaram
+        // IMPLEMENTE AQUI:
+        // - Loop para aguardar cada worker terminar
+        // - Usar wait() para capturar status de saída
+        // - Identificar qual worker terminou
+        // - Verificar se terminou normalmente ou com erro
+        // - Contar quantos workers terminaram
     
-    // Aguardar especificamente cada worker pelo PID
-    for (int i = 0; i < num_workers; i++) {
-        int status;
-        pid_t finished_pid = waitpid(workers[i], &status, 0);
+        // Aguardar especificamente cada worker pelo PID
+        double wait_start = progress_now();
+        for (int i = 0; i < num_workers; i++) {
+            int status;
+            pid_t finished_pid;
+            do {
+                finished_pid = waitpid(workers[i], &status, 0);
+            } while (finished_pid == -1 && errno == EINTR);
         
-        if (finished_pid == -1) {
-            perror("Erro ao aguardar worker específico");
-            continue;
-        }
+            if (finished_pid == -1) {
+                perror("Erro ao aguardar worker específico");
+                continue;
+            }
         
-        if (WIFEXITED(status)) {
-            printf("Worker %d (PID %d) terminou normalmente com código %d\n", 
-                   i, finished_pid, WEXITSTATUS(status));
-        } else if (WIFSIGNALED(status)) {
-            printf("Worker %d (PID %d) terminou por sinal %d\n", 
-                   i, finished_pid, WTERMSIG(status));
+            if (WIFEXITED(status)) {
+                LOG(LOG_NORMAL, "Worker %d (PID %d) terminou normalmente com código %d\n", 
+                    i, finished_pid, WEXITSTATUS(status));
+            } else if (WIFSIGNALED(status)) {
+                printf("Worker %d (PID %d) terminou por sinal %d\n", 
+                       i, finished_pid, WTERMSIG(status));
+            }
         }
-    }
     
-    printf("Todos os %d workers terminaram.\n", num_workers);
+        instr_event(&coord_instr, "espera", wait_start, progress_now(), NULL);
+        LOG(LOG_NORMAL, "Todos os %d workers terminaram.\n", num_workers);
+    
+    }
     
     // Registrar tempo de fim
-    time_t end_time = time(NULL);
-    double elapsed_time = difftime(end_time, start_time);
+    double elapsed_time = progress_now() - start_time;
+    
+    // Trace: fragmentos do coordinator e dos workers num único JSON
+    instr_end(&coord_instr, 0);
+    if (trace_path != NULL) {
+        int events = instr_trace_merge(trace_path, nodes_list != NULL || submit_path != NULL ? 0 : num_workers);
+        if (events < 0) {
+            perror(trace_path);
+        } else {
+            LOG(LOG_NORMAL, "Trace gravado em %s (%d eventos)\n", trace_path, events);
+        }
+    }
+    
+    // Potfile: só as senhas novas (as que voltaram de um checkpoint já estão nele)
+    // e conferidas com o alvo, para que uma senha errada nunca seja lembrada
+    if (potfile_path != NULL) {
+        int appended = 0;
+        for (int i = 0; i < num_targets; i++) {
+            const shared_crack_t *crack = &shared->cracks[i];
+            char computed_hash[HASH_HEX_MAX], target_hex[HASH_HEX_MAX], known_password[MD5_SINGLE_BLOCK_MAX + 1];
+            if (!atomic_load_explicit(&crack->ready, memory_order_acquire) ||
+                potfile_find(&potfile, algo, spec, &targets[i], known_password)) {
+                continue;
+            }
+            result_hash(algo, spec, &targets[i], crack->password, computed_hash);
+            hash_digest_to_hex(algo, targets[i].digest, target_hex);
+            if (strcmp(computed_hash, target_hex) != 0) {
+                continue;
+            }
+            if (potfile_append(&potfile, algo, spec, &targets[i], crack->password) != 0) {
+                perror(potfile_path);
+                break;
+            }
+            appended++;
+        }
+        if (appended > 0) {
+            LOG(LOG_NORMAL, "Potfile: %d senhas novas gravadas em %s\n", appended, potfile_path);
+        }
+        potfile_close(&potfile);
+    }
+    
+    if (checkpoint_path != NULL) {
+        keyspace_index_t saved = checkpoint_stop(&checkpoint);
+        char saved_str[KEYSPACE_INDEX_DIGITS];
+        if (interrupted || dispatch_failed) {
+            if (saved < 0) {
+                return 1;
+            }
+            printf("\nBusca interrompida. Checkpoint salvo em %s: %s de %s %s (%.1f%%)\n",
+                   checkpoint_path, keyspace_index_format(saved, saved_str), total_str, space_unit,
+                   100.0 * (double)saved / (double)total_space);
+            printf("Para continuar: repita o comando com --resume %s\n", checkpoint_path);
+            return interrupted ? 130 : 1;
+        }
+        // Busca concluída (ou todos os alvos achados): nada a retomar, a não ser
+        // que o espaço passe da janela desta execução
+        if (window < total_space - resume_from && saved >= 0 && !shared_state_done(shared)) {
+            printf("\nJanela concluída. Checkpoint salvo em %s: %s de %s %s\n", checkpoint_path,
+                   keyspace_index_format(saved, saved_str), total_str, space_unit);
+            printf("Para continuar: repita o comando com --resume %s\n", checkpoint_path);
+        } else {
+            unlink(checkpoint_path);
+        }
+    }
+    if (dispatch_failed) {
+        printf("Deu erro,busca distribuida incompleta (use --checkpoint para poder retomar)\n");
+        return 1;
+    }
     
     printf("\n=== Resultado ===\n");
     
     // TODO 9: Verificar se algum worker encontrou a senha
-    // Ler o arquivo password_found.txt se existir
+    // O slot de resultado na memória compartilhada só é lido após todos terminarem;
+    // ready (acquire) garante que a senha já foi escrita por inteiro
     
-    // IMPLEMENTE AQUI:
-    // - Abrir arquivo RESULT_FILE para leitura
-    // - Ler conteúdo do arquivo
-    // - Fazer parse do formato "worker_id:password"
-    // - Verificar o hash usando md5_string()
-    // - Exibir resultado encontrado
+    FILE *result_file = NULL;
+    if (export_result_file) {
+        // Exportação opcional para scripts, no formato "worker_id:password"
+        // (com --hash-file, "worker_id:password:hash", uma linha por senha)
+        int any_found = num_known > 0;
+        for (int i = 0; i < num_targets; i++) {
+            any_found |= atomic_load_explicit(&shared->cracks[i].ready, memory_order_acquire);
+        }
+        if (any_found && (result_file = fopen(RESULT_FILE, "w")) == NULL) {
+            perror("Erro ao gravar " RESULT_FILE);
+        }
+    }
     
-    FILE *result_file = fopen(RESULT_FILE, "r");
-    if (result_file != NULL) {
-        char line[256];
-        if (fgets(line, sizeof(line), result_file) != NULL) {
-            // Parse do formato "worker_id:password\n"
-            char *colon = strchr(line, ':');
-            if (colon != NULL) {
-                *colon = '\0';
-                int found_worker_id = atoi(line);
-                char *found_password = colon + 1;
-                
-                // Remover newline se presente
-                char *newline = strchr(found_password, '\n');
-                if (newline != NULL) {
-                    *newline = '\0';
-                }
-                
-                // Verificar o hash usando md5_string()
-                char computed_hash[33];
-                md5_string(found_password, computed_hash);
-                
-                printf("✓ SENHA ENCONTRADA!\n");
-                printf("Worker ID: %d\n", found_worker_id);
-                printf("Senha: %s\n", found_password);
-                printf("Hash calculado: %s\n", computed_hash);
-                printf("Hash alvo:      %s\n", target_hash);
-                
-                if (strcmp(computed_hash, target_hash) == 0) {
-                    printf("✓ Hash verificado com sucesso!\n");
-                } else {
-                    printf("✗ ERRO: Hash não confere!\n");
-                }
+    if (hash_file == NULL && atomic_load_explicit(&shared->cracks[0].ready, memory_order_acquire)) {
+        int found_worker_id = shared->cracks[0].worker_id;
+        const char *found_password = shared->cracks[0].password;
+        
+        if (result_file != NULL) {
+            fprintf(result_file, "%d:%s\n", found_worker_id, found_password);
+        }
+        
+        // Verificar o hash usando md5_string() (com sal, no formato do --hash-spec; ou o do --algo)
+        char computed_hash[HASH_HEX_MAX], target_hex[HASH_HEX_MAX];
+        result_hash(algo, spec, &single_target, found_password, computed_hash);
+        hash_digest_to_hex(algo, single_target.digest, target_hex);
+        
+        printf("✓ SENHA ENCONTRADA!\n");
+        printf("Worker ID: %d\n", found_worker_id);
+        printf("Senha: %s\n", found_password);
+        printf("Hash calculado: %s\n", computed_hash);
+        printf("Hash alvo:      %s\n", target_hash);
+        
+        if (strcmp(computed_hash, target_hex) == 0) {
+            printf("✓ Hash verificado com sucesso!\n");
+        } else {
+            printf("✗ ERRO: Hash não confere!\n");
+        }
+    } else if (hash_file != NULL && (num_targets > atomic_load(&shared->remaining) || num_known > 0)) {
+        int found = num_targets - atomic_load(&shared->remaining) + num_known;
+        
+        printf("✓ %d de %d SENHAS ENCONTRADAS!\n", found, total_targets);
+        int mismatches = print_known(known, num_known, algo, spec, 1, result_file);
+        for (int i = 0; i < num_targets; i++) {
+            const shared_crack_t *crack = &shared->cracks[i];
+            if (!atomic_load_explicit(&crack->ready, memory_order_acquire)) {
+                continue;
+            }
+            
+            char target_hex[HASH_HEX_MAX], computed_hash[HASH_HEX_MAX];
+            hash_digest_to_hex(algo, crack->digest, target_hex);
+            result_hash(algo, spec, &targets[i], crack->password, computed_hash);
+            mismatches += strcmp(computed_hash, target_hex) != 0;
+            
+            // Com sal, o alvo aparece como no --hash-file ("hash:sal")
+            const char *salt_sep = spec != MD5_SPEC_PLAIN ? ":" : "";
+            int salt_len = spec != MD5_SPEC_PLAIN ? targets[i].salt_len : 0;
+            printf("%s%s%.*s:%s (worker %d)\n", target_hex, salt_sep, salt_len,
+                   (const char*)targets[i].salt, crack->password, crack->worker_id);
+            if (result_file != NULL) {
+                fprintf(result_file, "%d:%s:%s%s%.*s\n", crack->worker_id, crack->password, target_hex,
+                        salt_sep, salt_len, (const char*)targets[i].salt);
             }
         }
-        fclose(result_file);
+        
+        if (mismatches == 0) {
+            printf("✓ Hashes verificados com sucesso!\n");
+        } else {
+            printf("✗ ERRO: %d hashes não conferem!\n", mismatches);
+        }
+    } else if (window < total_space - resume_from) {
+        // Só a janela desta execução foi percorrida: o resto do espaço não foi verificado
+        printf("✗ Senha não encontrada nos %lld %s cobertos por esta execução (o espaço passa de 2^62).\n",
+               window, space_unit);
+        printf("  O resto do espaço não foi verificado: use --checkpoint <arquivo> e depois --resume <arquivo>.\n");
     } else {
         printf("✗ Senha não encontrada no espaço de busca especificado.\n");
         printf("  Verifique se o hash está correto e se o charset contém todos os caracteres.\n");
     }
+    if (result_file != NULL) {
+        fclose(result_file);
+    }
     
     // Estatísticas finais (opcional)
     // TODO: Calcular e exibir estatísticas de performance
     
-    printf("\n=== Estatísticas de Performance ===\n");
-    printf("Tempo total de execução: %.2f segundos\n", elapsed_time);
-    printf("Espaço de busca total: %lld combinações\n", total_space);
-    printf("Número de workers: %d\n", num_workers);
+    LOG(LOG_NORMAL, "\n=== Estatísticas de Performance ===\n");
+    LOG(LOG_NORMAL, "Tempo total de execução: %.2f segundos\n", elapsed_time);
+    LOG(LOG_NORMAL, "Espaço de busca total: %s %s\n", total_str, space_unit);
+    if (nodes_list != NULL) {
+        LOG(LOG_NORMAL, "Número de nós: %d\n", num_nodes);
+    } else if (submit_path != NULL) {
+        LOG(LOG_NORMAL, "Daemon: %s\n", submit_path);
+    } else {
+        LOG(LOG_NORMAL, "Número de workers: %d\n", num_workers);
+    }
+    scheduler_report(&shared->sched);
+    instr_report(shared->instr, &shared->sched,
+                 trace_path != NULL || perf ? LOG_NORMAL : LOG_VERBOSE);
+    // Taxa sobre o que foi de fato verificado: a busca pode parar antes do fim do espaço
+    long long checked = scheduler_checked(&shared->sched);
+    LOG(LOG_NORMAL, "Verificado nesta execução: %lld %s\n", checked, space_unit);
     if (elapsed_time > 0) {
-        printf("Taxa de verificação estimada: %.0f senhas/segundo\n", total_space / elapsed_time);
-        printf("Speedup teórico com %d workers: %.1fx\n", num_workers, (double)num_workers);
+        if (wordlist_path != NULL) {
+            LOG(LOG_NORMAL, "Taxa de leitura: %.0f bytes/segundo\n", checked / elapsed_time);
+        } else {
+            LOG(LOG_NORMAL, "Taxa de verificação: %.0f senhas/segundo\n", checked / elapsed_time);
+        }
+        if (nodes_list == NULL && submit_path == NULL) {
+            LOG(LOG_NORMAL, "Speedup teórico com %d workers: %.1fx\n", num_workers, (double)num_workers);
+        }
     }
     
     return 0;
@@ -0,0 +1,637 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "daemon.h"
+#include "remote_job.h"
+#include "thread_engine.h"
+
+/**
+ * Job na fila do daemon (alocado: contém um keyspace_t)
+ */
+typedef struct daemon_job {
+    remote_job_t rj;
+    int id;
+    int priority;
+    int max_threads;            // Limite de threads do pool (0 = sem limite)
+    int fd;                     // Conexão do cliente (-1 = fechada)
+    int running;                // Threads do pool neste job (server.lock)
+    int finished;               // Sem threads e sem chunks: pronto para DONE (server.lock)
+    int cancelled;
+    unsigned char *sent;        // Senhas já enviadas ao cliente (por alvo)
+    double start;
+    struct daemon_job *next;
+} daemon_job_t;
+
+/**
+ * Thread do pool: uma linha de cache por thread
+ */
+typedef struct {
+    _Alignas(SHARED_CACHE_LINE)
+    pthread_t tid;
+    int id;
+    unsigned epoch;             // Última versão da fila reavaliada por esta thread
+} pool_thread_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work;        // Job novo ou com chunks liberados
+    atomic_uint epoch;          // Muda a cada alteração da fila (preempção)
+    daemon_job_t *jobs;         // Em ordem de chegada; só a thread principal altera a lista
+    int num_jobs;
+    int next_id;
+    int threads;
+    pool_thread_t *pool;
+    int wake_fd;                // eventfd: algum job terminou
+    // Conexões sem a primeira mensagem: entram no poll em vez de bloquear o laço
+    int pending_fd[DAEMON_MAX_PENDING];
+    double pending_since[DAEMON_MAX_PENDING];
+    int num_pending;
+} daemon_server_t;
+
+static daemon_server_t server = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER
+};
+static volatile sig_atomic_t stop_requested;
+
+static void handle_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+/**
+ * O job ainda tem chunks a entregar? (com server.lock)
+ */
+static int job_has_chunks(daemon_job_t *job) {
+    scheduler_t *sched = &job->rj.shared->sched;
+    return !job->finished && !shared_state_done(job->rj.shared) &&
+           atomic_load_explicit(&sched->cursor, memory_order_relaxed) < sched->end;
+}
+
+/**
+ * O job pode receber mais uma thread? (com server.lock)
+ */
+static int job_runnable(daemon_job_t *job) {
+    return job_has_chunks(job) && (job->max_threads == 0 || job->running < job->max_threads);
+}
+
+/**
+ * Escolhe o job para uma thread livre (com server.lock)
+ */
+static daemon_job_t *pool_pick(void) {
+    daemon_job_t *best = NULL;
+    for (daemon_job_t *job = server.jobs; job != NULL; job = job->next) {
+        if (!job_runnable(job)) {
+            continue;
+        }
+        if (best == NULL || job->priority > best->priority ||
+            (job->priority == best->priority && job->running < best->running)) {
+            best = job;
+        }
+    }
+    return best;
+}
+
+/**
+ * Avisa as threads ocupadas de que a fila mudou (com server.lock)
+ */
+static void pool_changed(void) {
+    atomic_fetch_add_explicit(&server.epoch, 1, memory_order_release);
+}
+
+/**
+ * search_job_t.yield: entre dois chunks, a thread troca de job se a fila
+ * mudou e há um job mais prioritário, ou de mesma prioridade com menos
+ * threads (o lock só é tomado quando a fila mudou)
+ */
+static int pool_yield(void *arg, int worker_id) {
+    daemon_job_t *current = arg;
+    pool_thread_t *t = &server.pool[worker_id];
+    unsigned epoch = atomic_load_explicit(&server.epoch, memory_order_acquire);
+    if (epoch == t->epoch) {
+        return 0;
+    }
+    t->epoch = epoch;
+
+    int yield = 0;
+    pthread_mutex_lock(&server.lock);
+    for (daemon_job_t *job = server.jobs; job != NULL && !yield; job = job->next) {
+        yield = job != current && job_runnable(job) &&
+                (job->priority > current->priority ||
+                 (job->priority == current->priority && job->running + 1 < current->running));
+    }
+    pthread_mutex_unlock(&server.lock);
+    return yield;
+}
+
+static void *pool_main(void *arg) {
+    pool_thread_t *t = arg;
+    uint64_t one = 1;
+
+    // Contexto alocado pela própria thread (já fixada): páginas no nó local
+    search_ctx_t *ctx = aligned_alloc(SHARED_CACHE_LINE, sizeof(search_ctx_t));
+    if (ctx == NULL) {
+        perror("Erro ao alocar contexto do pool");
+        return NULL;
+    }
+
+    pthread_mutex_lock(&server.lock);
+    for (;;) {
+        daemon_job_t *job;
+        while ((job = pool_pick()) == NULL) {
+            pthread_cond_wait(&server.work, &server.lock);
+        }
+        job->running++;
+        pool_changed();
+        t->epoch = atomic_load_explicit(&server.epoch, memory_order_relaxed);
+        pthread_mutex_unlock(&server.lock);
+
+        search_init(ctx, &job->rj.job, t->id);
+        search_job_run(ctx);
+
+        pthread_mutex_lock(&server.lock);
+        job->running--;
+        if (job->running == 0 && !job_has_chunks(job)) {
+            job->finished = 1;
+            if (write(server.wake_fd, &one, sizeof(one)) != sizeof(one)) {
+                perror("Erro ao sinalizar fim do job");
+            }
+        }
+        pool_changed();
+    }
+    return NULL;
+}
+
+/**
+ * Cria o pool, com as threads fixadas por nó NUMA se couberem nas CPUs
+ *
+ * @return Threads criadas
+ */
+static int pool_start(int threads) {
+    static int cpus[CPU_SETSIZE], nodes[CPU_SETSIZE];
+    int num_cpus = thread_engine_cpu_order(cpus, nodes);
+    int pin = num_cpus > 0 && threads <= num_cpus;
+
+    server.pool = aligned_alloc(SHARED_CACHE_LINE, threads * sizeof(pool_thread_t));
+    if (server.pool == NULL) {
+        return 0;
+    }
+    int started = 0;
+    for (int i = 0; i < threads; i++) {
+        pool_thread_t *t = &server.pool[i];
+        t->id = i;
+        t->epoch = 0;
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (pin) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[i], &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+        int rc = pthread_create(&t->tid, &attr, pool_main, t);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            fprintf(stderr, "Erro ao criar thread %d do pool: %s\n", i, strerror(rc));
+            break;
+        }
+        started++;
+    }
+    LOG(LOG_VERBOSE, "Pool: %d threads em %d CPUs disponíveis (%s)\n", started, num_cpus,
+        pin ? "fixadas por nó NUMA" : "sem afinidade");
+    return started;
+}
+
+/**
+ * Envia ERROR com uma mensagem
+ */
+static void send_error(int fd, const char *message) {
+    net_msg_t msg = {0};
+    net_msg_begin(&msg, NET_MSG_ERROR);
+    net_put_str(&msg, message);
+    net_send(fd, &msg);
+    net_msg_free(&msg);
+}
+
+/**
+ * Envia ao cliente as senhas do job que ele ainda não recebeu
+ */
+static void job_report_cracks(daemon_job_t *job, net_msg_t *msg) {
+    for (int i = 0; i < job->rj.params.num_targets && job->fd >= 0; i++) {
+        const shared_crack_t *crack = &job->rj.shared->cracks[i];
+        if (job->sent[i] || !atomic_load_explicit(&crack->ready, memory_order_acquire)) {
+            continue;
+        }
+        job->sent[i] = 1;
+        net_msg_begin(msg, NET_MSG_FOUND);
+        net_put_u32(msg, i);
+        net_put_u32(msg, crack->worker_id);
+        net_put_str(msg, crack->password);
+        if (net_send(job->fd, msg) != 0) {
+            close(job->fd);
+            job->fd = -1;
+        }
+    }
+}
+
+/**
+ * Para o job: as threads saem no próximo lote; sem threads, já está pronto
+ */
+static void job_cancel(daemon_job_t *job) {
+    pthread_mutex_lock(&server.lock);
+    job->cancelled = 1;
+    atomic_store(&job->rj.shared->done, 1);
+    if (job->running == 0) {
+        job->finished = 1;
+    }
+    pool_changed();
+    pthread_mutex_unlock(&server.lock);
+}
+
+static void job_free(daemon_job_t *job) {
+    if (job->fd >= 0) {
+        close(job->fd);
+    }
+    remote_job_close(&job->rj);
+    free(job->sent);
+    free(job);
+}
+
+/**
+ * Monta o job da mensagem JOB recebida em msg e o coloca na fila
+ */
+static void accept_job(int fd, net_msg_t *msg) {
+    char message[256];
+
+    if (server.num_jobs >= DAEMON_MAX_JOBS) {
+        send_error(fd, "fila do daemon cheia");
+        close(fd);
+        return;
+    }
+    daemon_job_t *job = calloc(1, sizeof(daemon_job_t));
+    if (job == NULL) {
+        send_error(fd, "sem memória para o job");
+        close(fd);
+        return;
+    }
+    // A mensagem passa para o job (as strings dos parâmetros apontam para ela)
+    job->rj.msg = *msg;
+    memset(msg, 0, sizeof(*msg));
+    job->fd = fd;
+    if (remote_job_open(&job->rj, message, sizeof(message)) != 0 ||
+        (job->sent = calloc(job->rj.params.num_targets, 1)) == NULL) {
+        send_error(fd, job->sent == NULL && job->rj.shared != NULL ? "sem memória para o job" : message);
+        job_free(job);
+        return;
+    }
+
+    job->id = ++server.next_id;
+    job->priority = job->rj.params.priority;
+    job->max_threads = job->rj.params.threads;
+    job->start = progress_now();
+    scheduler_init(&job->rj.shared->sched, 0, job->rj.window, server.threads);
+    job->rj.job.yield = pool_yield;
+    job->rj.job.yield_arg = job;
+
+    net_msg_t ready = {0};
+    net_msg_begin(&ready, NET_MSG_READY);
+    net_put_u32(&ready, job->id);
+    net_put_u128(&ready, job->rj.space);
+    if (net_send(fd, &ready) != 0) {
+        net_msg_free(&ready);
+        job_free(job);
+        return;
+    }
+    net_msg_free(&ready);
+
+    pthread_mutex_lock(&server.lock);
+    daemon_job_t **tail = &server.jobs;
+    while (*tail != NULL) {
+        tail = &(*tail)->next;
+    }
+    *tail = job;
+    server.num_jobs++;
+    pool_changed();
+    pthread_cond_broadcast(&server.work);
+    pthread_mutex_unlock(&server.lock);
+    char space_str[KEYSPACE_INDEX_DIGITS];
+    LOG(LOG_NORMAL, "Daemon: job %d recebido (prioridade %d, %d alvo(s), espaço %s)\n",
+        job->id, job->priority, job->rj.params.num_targets, keyspace_index_format(job->rj.space, space_str));
+}
+
+/**
+ * CANCEL de outra conexão: responde DONE se o job existia
+ */
+static void accept_cancel(int fd, net_msg_t *msg) {
+    int id = (int)net_get_u32(msg);
+    daemon_job_t *job = server.jobs;
+    while (job != NULL && job->id != id) {
+        job = job->next;
+    }
+
+    char message[64];
+    if (msg->error || job == NULL) {
+        snprintf(message, sizeof(message), "job %d não existe (ou já terminou)", id);
+        send_error(fd, message);
+    } else {
+        job_cancel(job);
+        LOG(LOG_NORMAL, "Daemon: job %d cancelado\n", id);
+        net_msg_begin(msg, NET_MSG_DONE);
+        net_put_u64(msg, 0);
+        net_put_u64(msg, 0);
+        net_send(fd, msg);
+    }
+    close(fd);
+}
+
+/**
+ * Nova conexão: só entra na lista de pendentes; a primeira mensagem é lida
+ * quando o poll avisa que ela chegou (um cliente calado não trava o laço)
+ */
+static void accept_client(int listen_fd) {
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd == -1) {
+        if (errno != EINTR) {
+            perror("Erro ao aceitar conexão");
+        }
+        return;
+    }
+    net_configure(fd);
+    if (server.num_pending >= DAEMON_MAX_PENDING) {
+        send_error(fd, "conexões pendentes demais no daemon");
+        close(fd);
+        return;
+    }
+    server.pending_fd[server.num_pending] = fd;
+    server.pending_since[server.num_pending] = progress_now();
+    server.num_pending++;
+}
+
+/**
+ * Tira a conexão i da lista de pendentes (a última ocupa o seu lugar)
+ */
+static int pending_take(int i) {
+    int fd = server.pending_fd[i];
+    server.num_pending--;
+    server.pending_fd[i] = server.pending_fd[server.num_pending];
+    server.pending_since[i] = server.pending_since[server.num_pending];
+    return fd;
+}
+
+/**
+ * Primeira mensagem de uma conexão pendente, já anunciada pelo poll: um JOB
+ * ou um CANCEL. O timeout curto limita o bloqueio a uma mensagem incompleta.
+ */
+static void read_first_message(int fd) {
+    net_msg_t msg = {0};
+    struct timeval timeout = {0, DAEMON_FIRST_MSG_MS * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    int rc = net_recv(fd, &msg);
+    net_configure(fd);      // De volta ao NET_IO_TIMEOUT para o resto da conexão
+    if (rc != 0) {
+        close(fd);
+    } else if (msg.type == NET_MSG_JOB) {
+        accept_job(fd, &msg);
+    } else if (msg.type == NET_MSG_CANCEL) {
+        accept_cancel(fd, &msg);
+    } else {
+        send_error(fd, "mensagem inesperada");
+        close(fd);
+    }
+    net_msg_free(&msg);
+}
+
+/**
+ * Tira da fila os jobs concluídos e envia o resultado aos clientes
+ */
+static void reap_jobs(net_msg_t *msg) {
+    daemon_job_t *done = NULL;
+
+    pthread_mutex_lock(&server.lock);
+    for (daemon_job_t **link = &server.jobs; *link != NULL;) {
+        daemon_job_t *job = *link;
+        if (job->finished) {
+            *link = job->next;
+            job->next = done;
+            done = job;
+            server.num_jobs--;
+        } else {
+            link = &job->next;
+        }
+    }
+    pthread_mutex_unlock(&server.lock);
+
+    while (done != NULL) {
+        daemon_job_t *job = done;
+        done = job->next;
+        // Sem threads no job: as estatísticas podem ser lidas sem corrida
+        long long checked = scheduler_checked(&job->rj.shared->sched);
+        double elapsed = progress_now() - job->start;
+        job_report_cracks(job, msg);
+        if (job->fd >= 0 && job->cancelled) {
+            send_error(job->fd, "job cancelado");
+        } else if (job->fd >= 0) {
+            net_msg_begin(msg, NET_MSG_DONE);
+            net_put_u64(msg, checked);
+            net_put_u64(msg, (uint64_t)(elapsed * 1e6));
+            net_send(job->fd, msg);
+        }
+        LOG(LOG_NORMAL, "Daemon: job %d %s em %.3f s (%lld verificados)\n", job->id,
+            job->cancelled ? "cancelado" : "concluído", elapsed, checked);
+        job_free(job);
+    }
+}
+
+int daemon_serve(const char *socket_path, int threads) {
+    int listen_fd = net_listen_unix(socket_path);
+    if (listen_fd == -1) {
+        perror(socket_path);
+        return 1;
+    }
+    server.threads = threads;
+    server.wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (server.wake_fd == -1 || pool_start(threads) != threads) {
+        perror("Erro ao criar o pool do daemon");
+        unlink(socket_path);
+        return 1;
+    }
+
+    // Sem SA_RESTART: o poll volta com EINTR e o laço termina
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    LOG(LOG_NORMAL, "Daemon escutando em %s: %d threads (kernel %s)\n", socket_path, threads,
+        md5_kernel_name());
+    fflush(stdout);
+
+    static struct pollfd pfd[2 + DAEMON_MAX_PENDING + DAEMON_MAX_JOBS];
+    static daemon_job_t *owner[2 + DAEMON_MAX_PENDING + DAEMON_MAX_JOBS];
+    net_msg_t msg = {0};
+    while (!stop_requested) {
+        int n = 0;
+        pfd[n++] = (struct pollfd){.fd = listen_fd, .events = POLLIN};
+        pfd[n++] = (struct pollfd){.fd = server.wake_fd, .events = POLLIN};
+        int num_pending = server.num_pending;
+        for (int i = 0; i < num_pending; i++) {
+            pfd[n++] = (struct pollfd){.fd = server.pending_fd[i], .events = POLLIN};
+        }
+        int first_job = n;
+        for (daemon_job_t *job = server.jobs; job != NULL; job = job->next) {
+            if (job->fd >= 0) {
+                owner[n] = job;
+                pfd[n++] = (struct pollfd){.fd = job->fd, .events = POLLIN};
+            }
+        }
+
+        if (poll(pfd, n, DAEMON_POLL_MS) > 0) {
+            uint64_t wakes;
+            if (pfd[1].revents != 0 && read(server.wake_fd, &wakes, sizeof(wakes)) < 0 && errno != EAGAIN) {
+                perror("Erro ao ler fim de job");
+            }
+            // Pendentes com dados (ou fechadas), de trás para frente: pending_take
+            // move a última para a posição liberada
+            for (int i = num_pending - 1; i >= 0; i--) {
+                if (pfd[2 + i].revents != 0) {
+                    read_first_message(pending_take(i));
+                }
+            }
+            // STOP, ou a conexão caiu: o cliente desistiu do job
+            for (int i = first_job; i < n; i++) {
+                daemon_job_t *job = owner[i];
+                if (pfd[i].revents == 0) {
+                    continue;
+                }
+                if (net_recv(job->fd, &msg) != 0 || msg.type == NET_MSG_STOP) {
+                    close(job->fd);
+                    job->fd = -1;
+                    job_cancel(job);
+                    LOG(LOG_NORMAL, "Daemon: job %d cancelado pelo cliente\n", job->id);
+                }
+            }
+            if (pfd[0].revents != 0) {
+                accept_client(listen_fd);
+            }
+        }
+
+        // Conexões que não mandaram nada em NET_IO_TIMEOUT segundos
+        double now = progress_now();
+        for (int i = server.num_pending - 1; i >= 0; i--) {
+            if (now - server.pending_since[i] > NET_IO_TIMEOUT) {
+                close(pending_take(i));
+            }
+        }
+
+        for (daemon_job_t *job = server.jobs; job != NULL; job = job->next) {
+            job_report_cracks(job, &msg);
+        }
+        reap_jobs(&msg);
+        fflush(stdout);
+    }
+
+    // Os jobs em andamento morrem com o processo; os clientes veem a conexão cair
+    LOG(LOG_NORMAL, "Daemon encerrado (%d job(s) pendente(s))\n", server.num_jobs);
+    net_msg_free(&msg);
+    close(listen_fd);
+    unlink(socket_path);
+    return 0;
+}
+
+int daemon_submit(const char *socket_path, const net_job_t *job, shared_state_t *shared) {
+    int fd = net_connect_unix(socket_path);
+    if (fd == -1) {
+        printf("Deu erro,daemon indisponivel em %s: %s\n", socket_path, strerror(errno));
+        return -1;
+    }
+
+    net_msg_t msg = {0};
+    net_job_encode(&msg, job);
+    int status = net_send(fd, &msg) == 0 ? 1 : -1;
+    double start = progress_now();
+
+    // 1 = esperando; a espera pelo DONE não tem timeout (o job pode ser longo)
+    while (status == 1) {
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        if (poll(&pfd, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            status = -1;
+            break;
+        }
+        if (net_recv(fd, &msg) != 0) {
+            status = -1;
+            break;
+        }
+        if (msg.type == NET_MSG_READY) {
+            int id = (int)net_get_u32(&msg);
+            LOG(LOG_NORMAL, "Job %d na fila do daemon (%s)\n", id, socket_path);
+            fflush(stdout);
+        } else if (msg.type == NET_MSG_FOUND) {
+            uint32_t target = net_get_u32(&msg);
+            uint32_t worker_id = net_get_u32(&msg);
+            const char *password = net_get_str(&msg);
+            if (!msg.error && password != NULL && target < (uint32_t)shared->num_targets) {
+                shared_state_publish(shared, target, worker_id, password);
+            }
+        } else if (msg.type == NET_MSG_DONE) {
+            // O daemon é o único "worker" do escalonador local
+            sched_worker_stats_t *stats = &shared->sched.workers[0];
+            stats->chunks = 1;
+            stats->checked = (long long)net_get_u64(&msg);
+            stats->busy = net_get_u64(&msg) / 1e6;
+            stats->min_chunk = stats->max_chunk = stats->busy;
+            stats->finish = progress_now();
+            status = 0;
+        } else if (msg.type == NET_MSG_ERROR) {
+            const char *error = net_get_str(&msg);
+            printf("Deu erro,daemon: %s\n", error != NULL ? error : "?");
+            status = -2;
+        }
+    }
+    if (status == -1) {
+        printf("Deu erro,conexao com o daemon perdida apos %.1f s\n", progress_now() - start);
+    }
+    net_msg_free(&msg);
+    close(fd);
+    return status == 0 ? 0 : -1;
+}
+
+int daemon_cancel(const char *socket_path, int job_id) {
+    int fd = net_connect_unix(socket_path);
+    if (fd == -1) {
+        printf("Deu erro,daemon indisponivel em %s: %s\n", socket_path, strerror(errno));
+        return 1;
+    }
+
+    net_msg_t msg = {0};
+    net_msg_begin(&msg, NET_MSG_CANCEL);
+    net_put_u32(&msg, job_id);
+    int rc = 1;
+    if (net_send(fd, &msg) != 0 || net_recv(fd, &msg) != 0) {
+        printf("Deu erro,conexao com o daemon perdida\n");
+    } else if (msg.type == NET_MSG_DONE) {
+        printf("Job %d cancelado\n", job_id);
+        rc = 0;
+    } else {
+        const char *error = msg.type == NET_MSG_ERROR ? net_get_str(&msg) : NULL;
+        printf("Deu erro,%s\n", error != NULL ? error : "resposta inesperada do daemon");
+    }
+    net_msg_free(&msg);
+    close(fd);
+    return rc;
+}
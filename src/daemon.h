@@ -0,0 +1,62 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include "net_proto.h"
+#include "shared_state.h"
+
+/**
+ * Daemon com pool de threads aquecido (coordinator --daemon) - Mini-Projeto 1
+ *
+ * Com muitos jobs pequenos, o custo de cada execução do coordinator (fork
+ * + execl de um worker por CPU, cada um relendo argv e preparando os alvos)
+ * domina. O daemon cria o pool uma única vez (threads fixadas por nó NUMA,
+ * como em --threads, cada uma com o seu search_ctx_t) e recebe os jobs num
+ * socket Unix, uma conexão por job, com as mensagens de net_proto.h:
+ *
+ * - Prioridade: uma thread livre vai para o job de maior prioridade; entre
+ *   jobs de mesma prioridade, para o que tem menos threads (empate: o mais
+ *   antigo). Vários jobs pequenos dividem o pool ao mesmo tempo, e
+ *   net_job_t.threads limita as threads de um job (0 = o pool inteiro)
+ * - Preempção entre chunks: quando a fila muda (job novo, thread que entrou
+ *   ou saiu de um job, job concluído ou cancelado), cada thread reavalia no
+ *   fim do chunk se deve trocar de job (search_job_t.yield); o que falta do
+ *   job fica no escalonador dele
+ * - Cancelamento: STOP ou a queda da conexão do cliente (Ctrl+C no
+ *   coordinator --submit), ou CANCEL <id> vindo de outra conexão
+ * - As senhas vão para o cliente assim que aparecem; DONE no fim
+ *
+ * O cliente é o próprio coordinator com --submit <socket>: mesmas opções,
+ * validação e relatório final (o daemon é o único "worker" do escalonador
+ * local do cliente).
+ */
+
+#define DAEMON_MAX_JOBS 256             // Jobs na fila ou em execução
+#define DAEMON_POLL_MS 50               // Latência de envio das senhas encontradas
+#define DAEMON_MAX_PENDING 64           // Conexões aceitas esperando a primeira mensagem
+#define DAEMON_FIRST_MSG_MS 100         // Leitura da primeira mensagem depois que o poll a anuncia
+
+/**
+ * Atende jobs no socket Unix indicado até SIGINT/SIGTERM
+ *
+ * @param threads Threads do pool (1..THREAD_ENGINE_MAX_THREADS)
+ * @return 0 ao encerrar, 1 se o socket ou o pool não puderam ser criados
+ */
+int daemon_serve(const char *socket_path, int threads);
+
+/**
+ * Envia um job ao daemon e espera o fim: as senhas são publicadas em
+ * shared->cracks e as estatísticas vão para o slot 0 de shared->sched
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro ou cancelamento (já
+ *         informado na saída)
+ */
+int daemon_submit(const char *socket_path, const net_job_t *job, shared_state_t *shared);
+
+/**
+ * Cancela um job do daemon pelo id (informado ao cliente que o enviou)
+ *
+ * @return Código de saída do coordinator
+ */
+int daemon_cancel(const char *socket_path, int job_id);
+
+#endif // DAEMON_H
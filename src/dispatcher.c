@@ -0,0 +1,324 @@
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "dispatcher.h"
+#include "progress.h"
+
+/**
+ * Estado de um nó no coordinator
+ */
+typedef struct {
+    const dispatch_node_t *addr;
+    int fd;                 // -1 = não conectado ou perdido
+    int threads;
+    sched_local_t local;    // Slot do nó no escalonador (worker_id = índice do nó)
+    int busy;
+    long long start, count; // Intervalo em andamento
+    double rate;            // Senhas (bytes) por segundo, última medida do nó
+    double last_heard;
+} dispatch_peer_t;
+
+/**
+ * Intervalo de um nó perdido, à espera de outro nó
+ */
+typedef struct {
+    long long start, count;
+    int from;
+} dispatch_orphan_t;
+
+int dispatcher_parse_nodes(const char *list, dispatch_node_t *nodes, int max_nodes) {
+    int n = 0;
+    const char *p = list;
+
+    while (*p != '\0') {
+        const char *end = strchr(p, ',');
+        size_t len = end != NULL ? (size_t)(end - p) : strlen(p);
+        const char *host = p, *host_end;
+
+        if (n == max_nodes) {
+            return -1;
+        }
+        if (*p == '[') {
+            // [::1]:porta
+            host = p + 1;
+            host_end = memchr(host, ']', len - 1);
+            if (host_end == NULL || host_end + 1 >= p + len || host_end[1] != ':') {
+                return -1;
+            }
+        } else {
+            host_end = memchr(p, ':', len);
+            if (host_end == NULL) {
+                return -1;
+            }
+        }
+        const char *port = strchr(host_end, ':') + 1;
+        size_t host_len = host_end - host;
+        size_t port_len = p + len - port;
+        if (host_len == 0 || host_len >= sizeof(nodes[n].host) ||
+            port_len == 0 || port_len >= sizeof(nodes[n].port)) {
+            return -1;
+        }
+        memcpy(nodes[n].host, host, host_len);
+        nodes[n].host[host_len] = '\0';
+        memcpy(nodes[n].port, port, port_len);
+        nodes[n].port[port_len] = '\0';
+        n++;
+
+        p += len;
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return n;
+}
+
+/**
+ * Conecta a um nó, envia o job e espera o READY
+ */
+static int dispatch_connect(dispatch_peer_t *peer, int id, net_msg_t *job_msg, net_msg_t *msg) {
+    const dispatch_node_t *addr = peer->addr;
+
+    peer->fd = net_connect(addr->host, addr->port);
+    if (peer->fd == -1) {
+        fprintf(stderr, "Nó %d (%s:%s): %s\n", id, addr->host, addr->port, strerror(errno));
+        return -1;
+    }
+    if (net_send(peer->fd, job_msg) != 0 || net_recv(peer->fd, msg) != 0) {
+        fprintf(stderr, "Nó %d (%s:%s): conexão perdida ao enviar o job\n", id, addr->host, addr->port);
+    } else if (msg->type == NET_MSG_ERROR) {
+        const char *error = net_get_str(msg);
+        fprintf(stderr, "Nó %d (%s:%s): %s\n", id, addr->host, addr->port, error != NULL ? error : "erro");
+    } else if (msg->type == NET_MSG_READY) {
+        peer->threads = net_get_u32(msg);
+        LOG(LOG_NORMAL, "Nó %d (%s:%s): %d threads\n", id, addr->host, addr->port, peer->threads);
+        scheduler_local_init(&peer->local, id);
+        return 0;
+    }
+    close(peer->fd);
+    peer->fd = -1;
+    return -1;
+}
+
+/**
+ * Desconecta um nó; o intervalo em andamento vai para a fila de órfãos
+ */
+static void dispatch_lose(dispatch_peer_t *peer, int id, const char *reason,
+                          dispatch_orphan_t *orphans, int *num_orphans) {
+    fprintf(stderr, "Nó %d (%s:%s) perdido: %s\n", id, peer->addr->host, peer->addr->port, reason);
+    close(peer->fd);
+    peer->fd = -1;
+    if (peer->busy) {
+        LOG(LOG_NORMAL, "Intervalo %lld + %lld do nó %d volta para a fila\n", peer->start, peer->count, id);
+        orphans[(*num_orphans)++] = (dispatch_orphan_t){peer->start, peer->count, id};
+        peer->busy = 0;
+    }
+}
+
+/**
+ * Entrega o próximo intervalo a um nó ocioso: primeiro os órfãos, depois o cursor
+ *
+ * @return 1 se o nó recebeu um intervalo, 0 se não há mais trabalho, -1 se o envio falhou
+ */
+static int dispatch_assign(dispatch_peer_t *peer, scheduler_t *sched, dispatch_orphan_t *orphans,
+                           int *num_orphans, net_msg_t *msg) {
+    long long start, count;
+
+    if (*num_orphans > 0) {
+        dispatch_orphan_t *orphan = &orphans[--*num_orphans];
+        start = orphan->start;
+        count = orphan->count;
+        scheduler_reassign(sched, &peer->local, orphan->from, start, count);
+    } else {
+        // Proporcional à velocidade: DISPATCH_RANGE_SECONDS na taxa medida pelo nó
+        if (peer->rate > 0) {
+            peer->local.chunk = (long long)(peer->rate * DISPATCH_RANGE_SECONDS);
+        }
+        if (!scheduler_next(sched, &peer->local, &start, &count)) {
+            return 0;
+        }
+    }
+
+    peer->busy = 1;
+    peer->start = start;
+    peer->count = count;
+    peer->last_heard = progress_now();
+    net_msg_begin(msg, NET_MSG_RANGE);
+    net_put_u64(msg, start);
+    net_put_u64(msg, count);
+    return net_send(peer->fd, msg) == 0 ? 1 : -1;
+}
+
+/**
+ * Repassa uma senha aos outros nós
+ */
+static void dispatch_forward(dispatch_peer_t *peers, int num_nodes, int from, net_msg_t *msg) {
+    for (int i = 0; i < num_nodes; i++) {
+        if (i != from && peers[i].fd != -1) {
+            net_send(peers[i].fd, msg);     // Falha aparece no próximo recv/heartbeat
+        }
+    }
+}
+
+/**
+ * Trata uma mensagem de um nó
+ *
+ * @return 0 em caso de sucesso, -1 se o nó deve ser dado como perdido
+ */
+static int dispatch_handle(dispatch_peer_t *peers, int num_nodes, int id, shared_state_t *shared,
+                           net_msg_t *msg, const char **reason) {
+    dispatch_peer_t *peer = &peers[id];
+
+    peer->last_heard = progress_now();
+    switch (msg->type) {
+    case NET_MSG_PROGRESS:
+        net_get_u64(msg);
+        peer->rate = (double)net_get_u64(msg);
+        break;
+
+    case NET_MSG_DONE: {
+        long long checked = net_get_u64(msg);
+        double rate = (double)net_get_u64(msg);
+        if (!peer->busy || msg->error) {
+            *reason = "DONE inesperado";
+            return -1;
+        }
+        scheduler_complete(&shared->sched, &peer->local, checked);
+        if (rate > 0) {
+            peer->rate = rate;
+        }
+        peer->busy = 0;
+        LOG(LOG_VERBOSE, "Nó %d: intervalo %lld + %lld concluído (%.0f/s)\n", id, peer->start,
+            peer->count, peer->rate);
+        break;
+    }
+
+    case NET_MSG_FOUND: {
+        char password[MD5_SINGLE_BLOCK_MAX + 1];
+        uint32_t target = net_get_u32(msg);
+        net_get_u32(msg);
+        const char *received = net_get_str(msg);
+        if (msg->error || received == NULL || strlen(received) > MD5_SINGLE_BLOCK_MAX ||
+            target >= (uint32_t)shared->num_targets) {
+            *reason = "FOUND inválido";
+            return -1;
+        }
+        strcpy(password, received);     // msg é reaproveitada para o repasse
+        // No resultado, o "worker" é o nó
+        if (shared_state_publish(shared, target, id, password)) {
+            LOG(LOG_NORMAL, "Nó %d (%s:%s) encontrou: %s\n", id, peer->addr->host, peer->addr->port, password);
+            net_msg_begin(msg, NET_MSG_FOUND);
+            net_put_u32(msg, target);
+            net_put_u32(msg, id);
+            net_put_str(msg, password);
+            dispatch_forward(peers, num_nodes, id, msg);
+        }
+        break;
+    }
+
+    case NET_MSG_ERROR:
+        *reason = net_get_str(msg);
+        if (*reason == NULL) {
+            *reason = "erro informado pelo nó";
+        }
+        return -1;
+
+    default:
+        *reason = "mensagem desconhecida";
+        return -1;
+    }
+    return 0;
+}
+
+int dispatcher_run(const net_job_t *job, shared_state_t *shared,
+                   const dispatch_node_t *nodes, int num_nodes) {
+    scheduler_t *sched = &shared->sched;
+    dispatch_peer_t peers[DISPATCH_MAX_NODES];
+    dispatch_orphan_t orphans[DISPATCH_MAX_NODES];
+    struct pollfd pfds[DISPATCH_MAX_NODES];
+    int num_orphans = 0, connected = 0;
+    net_msg_t job_msg = {0}, msg = {0};
+    int status = 0;
+
+    net_job_encode(&job_msg, job);
+    for (int i = 0; i < num_nodes; i++) {
+        memset(&peers[i], 0, sizeof(peers[i]));
+        peers[i].addr = &nodes[i];
+        connected += dispatch_connect(&peers[i], i, &job_msg, &msg) == 0;
+    }
+    net_msg_free(&job_msg);
+    if (connected == 0) {
+        fprintf(stderr, "Nenhum nó disponível\n");
+        return -1;
+    }
+    fflush(stdout);
+
+    while (!shared_state_done(shared)) {
+        // Intervalos para todos os nós ociosos
+        int busy = 0, alive = 0;
+        for (int i = 0; i < num_nodes; i++) {
+            dispatch_peer_t *peer = &peers[i];
+            if (peer->fd != -1 && !peer->busy &&
+                dispatch_assign(peer, sched, orphans, &num_orphans, &msg) < 0) {
+                dispatch_lose(peer, i, "falha ao enviar intervalo", orphans, &num_orphans);
+            }
+            alive += peer->fd != -1;
+            busy += peer->busy;
+        }
+        if (busy == 0) {
+            // Sem nada em andamento: ou o espaço acabou, ou não sobrou nó para o resto
+            if (alive == 0 && (num_orphans > 0 || atomic_load(&sched->cursor) < sched->end)) {
+                fprintf(stderr, "Todos os nós foram perdidos com trabalho pendente\n");
+                status = -1;
+            }
+            break;
+        }
+
+        int nfds = 0;
+        int ids[DISPATCH_MAX_NODES];
+        for (int i = 0; i < num_nodes; i++) {
+            if (peers[i].fd != -1) {
+                pfds[nfds] = (struct pollfd){.fd = peers[i].fd, .events = POLLIN};
+                ids[nfds++] = i;
+            }
+        }
+        if (poll(pfds, nfds, DISPATCH_POLL_MS) < 0 && errno != EINTR) {
+            perror("Erro em poll");
+            status = -1;
+            break;
+        }
+
+        double now = progress_now();
+        for (int k = 0; k < nfds; k++) {
+            int id = ids[k];
+            dispatch_peer_t *peer = &peers[id];
+            const char *reason = NULL;
+            if (pfds[k].revents != 0) {
+                if (net_recv(peer->fd, &msg) != 0) {
+                    reason = "conexão encerrada";
+                } else {
+                    dispatch_handle(peers, num_nodes, id, shared, &msg, &reason);
+                }
+            } else if (peer->busy && now - peer->last_heard > DISPATCH_NODE_TIMEOUT) {
+                reason = "sem heartbeat";
+            }
+            if (reason != NULL) {
+                dispatch_lose(peer, id, reason, orphans, &num_orphans);
+            }
+        }
+        fflush(stdout);
+    }
+
+    // Fim (espaço esgotado, último alvo encontrado ou interrupção): os nós param
+    net_msg_begin(&msg, NET_MSG_STOP);
+    for (int i = 0; i < num_nodes; i++) {
+        if (peers[i].fd != -1) {
+            net_send(peers[i].fd, &msg);
+            close(peers[i].fd);
+        }
+    }
+    net_msg_free(&msg);
+    return status;
+}
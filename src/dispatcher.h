@@ -0,0 +1,54 @@
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+#include "net_proto.h"
+#include "shared_state.h"
+
+/**
+ * Distribuição entre máquinas (coordinator --nodes) - Mini-Projeto 1
+ *
+ * Cada nó (worker --listen, node.h) é um "worker" do escalonador dinâmico
+ * do coordinator, com o seu slot de estatísticas: os intervalos saem do
+ * mesmo cursor em shared->sched, então checkpoints (--checkpoint) e o
+ * relatório final funcionam como nos outros modos.
+ *
+ * - Tamanho proporcional à velocidade: o nó informa a taxa medida a cada
+ *   heartbeat e no fim de cada intervalo; o próximo mira
+ *   DISPATCH_RANGE_SECONDS nessa taxa (o primeiro, ainda sem medida, tem o
+ *   tamanho inicial do escalonador)
+ * - Nó perdido (conexão caiu, ERROR ou DISPATCH_NODE_TIMEOUT segundos sem
+ *   heartbeat): o intervalo dele volta para uma fila e é o próximo a ser
+ *   entregue, com o pending transferido (scheduler_reassign)
+ * - Senhas encontradas são publicadas em shared e repassadas aos outros nós
+ */
+
+#define DISPATCH_MAX_NODES 64
+#define DISPATCH_RANGE_SECONDS 2.0      // Duração alvo de um intervalo num nó
+#define DISPATCH_NODE_TIMEOUT 10.0      // Segundos sem notícias de um nó ocupado
+#define DISPATCH_POLL_MS 200
+
+typedef struct {
+    char host[256];
+    char port[16];
+} dispatch_node_t;
+
+/**
+ * Lê a lista de nós ("host:porta,host:porta,..."; IPv6 entre colchetes)
+ *
+ * @return Número de nós, ou -1 se a lista é inválida ou longa demais
+ */
+int dispatcher_parse_nodes(const char *list, dispatch_node_t *nodes, int max_nodes);
+
+/**
+ * Conecta aos nós, envia o job e distribui o espaço de shared->sched até
+ * ele acabar, todos os alvos serem encontrados ou a flag de parada ser
+ * ligada (SIGINT com checkpoint)
+ *
+ * @param job Parâmetros enviados aos nós (job->total = tamanho do espaço)
+ * @return 0 em caso de sucesso, -1 se nenhum nó conectou ou todos caíram
+ *         com trabalho pendente
+ */
+int dispatcher_run(const net_job_t *job, shared_state_t *shared,
+                   const dispatch_node_t *nodes, int num_nodes);
+
+#endif // DISPATCHER_H
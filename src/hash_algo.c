@@ -0,0 +1,379 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hash_algo.h"
+#include "hash_kernels.h"
+#include "md5_kernels.h"
+
+static const hash_algo_t algos[HASH_ALGO_COUNT] = {
+    [HASH_MD5] = {"md5", "MD5", 16, 4, MD5_SINGLE_BLOCK_MAX, 0},
+    [HASH_MD4] = {"md4", "MD4", 16, 4, MD5_SINGLE_BLOCK_MAX, 0},
+    [HASH_NTLM] = {"ntlm", "NTLM", 16, 4, (MD5_SINGLE_BLOCK_MAX - 1) / 2, 0},
+    [HASH_SHA1] = {"sha1", "SHA-1", 20, 5, MD5_SINGLE_BLOCK_MAX, 1},
+    [HASH_SHA256] = {"sha256", "SHA-256", 32, 8, MD5_SINGLE_BLOCK_MAX, 1},
+};
+
+const hash_algo_t *hash_algo_get(int algo) {
+    return &algos[algo];
+}
+
+int hash_algo_parse(const char *name) {
+    for (int algo = 0; algo < HASH_ALGO_COUNT; algo++) {
+        if (strcmp(name, algos[algo].name) == 0) {
+            return algo;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Converte bytes em palavras (e vice-versa) na ordem do algoritmo
+ */
+static void hash_decode(int algo, uint32_t *words, const uint8_t *bytes, int count) {
+    for (int i = 0; i < count; i++) {
+        const uint8_t *p = bytes + 4 * i;
+        words[i] = algos[algo].big_endian
+            ? ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]
+            : ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+    }
+}
+
+static void hash_encode(int algo, uint8_t *bytes, const uint32_t *words, int count) {
+    for (int i = 0; i < count; i++) {
+        for (int b = 0; b < 4; b++) {
+            int shift = algos[algo].big_endian ? 24 - 8 * b : 8 * b;
+            bytes[4 * i + b] = (uint8_t)(words[i] >> shift);
+        }
+    }
+}
+
+/**
+ * Compressões de referência, com as mesmas macros dos kernels
+ */
+static void md4_compress(uint32_t state[4], const uint32_t x[16]) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+
+    MD4_STEPS(MD4_STEP_RUN)
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+static void sha1_compress(uint32_t state[5], const uint32_t block[16]) {
+    uint32_t w[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    memcpy(w, block, sizeof(w));
+    SHA1_ROUNDS(uint32_t)
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+static void sha256_compress(uint32_t state[8], const uint32_t block[16]) {
+    uint32_t w[16];
+    uint32_t s0 = state[0], s1 = state[1], s2 = state[2], s3 = state[3];
+    uint32_t s4 = state[4], s5 = state[5], s6 = state[6], s7 = state[7];
+
+    memcpy(w, block, sizeof(w));
+    SHA256_ROUNDS(uint32_t)
+
+    state[0] += s0;
+    state[1] += s1;
+    state[2] += s2;
+    state[3] += s3;
+    state[4] += s4;
+    state[5] += s5;
+    state[6] += s6;
+    state[7] += s7;
+}
+
+static void hash_compress(int algo, uint32_t *state, const uint8_t block[64]) {
+    uint32_t x[16];
+
+    hash_decode(algo, x, block, 16);
+    if (algo == HASH_SHA1) {
+        sha1_compress(state, x);
+    } else if (algo == HASH_SHA256) {
+        sha256_compress(state, x);
+    } else {
+        md4_compress(state, x);
+    }
+}
+
+/**
+ * Merkle-Damgård: blocos de 64 bytes, 0x80, zeros e o comprimento em bits
+ * (64 bits, na ordem do algoritmo) no fim do último bloco
+ */
+static void hash_bytes(int algo, const uint8_t *input, size_t len, uint8_t digest[HASH_DIGEST_MAX]) {
+    uint32_t state[8];
+    uint8_t block[64];
+    uint64_t bits = (uint64_t)len << 3;
+    size_t done = 0;
+
+    memcpy(state, hash_iv[algo], sizeof(state));
+    for (; len - done >= 64; done += 64) {
+        hash_compress(algo, state, input + done);
+    }
+
+    memset(block, 0, sizeof(block));
+    memcpy(block, input + done, len - done);
+    block[len - done] = 0x80;
+    if (len - done >= 56) {
+        hash_compress(algo, state, block);
+        memset(block, 0, sizeof(block));
+    }
+    for (int i = 0; i < 8; i++) {
+        block[algos[algo].big_endian ? 63 - i : 56 + i] = (uint8_t)(bits >> (8 * i));
+    }
+    hash_compress(algo, state, block);
+
+    memset(digest, 0, HASH_DIGEST_MAX);
+    hash_encode(algo, digest, state, algos[algo].words);
+}
+
+void hash_digest(int algo, const char *input, size_t len, uint8_t digest[HASH_DIGEST_MAX]) {
+    if (algo == HASH_MD5) {
+        uint8_t md5[1][MD5_DIGEST_LENGTH];
+        md5_batch(&input, &len, 1, md5);
+        memset(digest, 0, HASH_DIGEST_MAX);
+        memcpy(digest, md5[0], MD5_DIGEST_LENGTH);
+    } else if (algo == HASH_NTLM) {
+        // Senha em UTF-16LE: cada byte vira um caractere (Latin-1)
+        uint8_t *wide = calloc(2 * len + 1, 1);
+        if (wide == NULL) {
+            memset(digest, 0, HASH_DIGEST_MAX);
+            return;
+        }
+        for (size_t i = 0; i < len; i++) {
+            wide[2 * i] = (uint8_t)input[i];
+        }
+        hash_bytes(algo, wide, 2 * len, digest);
+        free(wide);
+    } else {
+        hash_bytes(algo, (const uint8_t*)input, len, digest);
+    }
+}
+
+void hash_digest_to_hex(int algo, const uint8_t *digest, char output[HASH_HEX_MAX]) {
+    static const char hex[] = "0123456789abcdef";
+    int n = algos[algo].digest_len;
+
+    for (int i = 0; i < n; i++) {
+        output[i * 2] = hex[digest[i] >> 4];
+        output[i * 2 + 1] = hex[digest[i] & 0x0f];
+    }
+    output[2 * n] = '\0';
+}
+
+void hash_string(int algo, const char *input, char output[HASH_HEX_MAX]) {
+    uint8_t digest[HASH_DIGEST_MAX];
+
+    hash_digest(algo, input, strlen(input), digest);
+    hash_digest_to_hex(algo, digest, output);
+}
+
+int hash_target_parse(int algo, const char *hex, md5_target_t *target) {
+    int n = algos[algo].digest_len;
+
+    if (algo == HASH_MD5) {
+        return md5_target_parse(hex, target);
+    }
+    if (hex == NULL || strlen(hex) != (size_t)(2 * n)) {
+        return -1;
+    }
+    for (int i = 0; i < 2 * n; i++) {
+        char ch = hex[i];
+        int nibble;
+
+        if (ch >= '0' && ch <= '9') {
+            nibble = ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            nibble = ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+            nibble = ch - 'A' + 10;
+        } else {
+            return -1;
+        }
+
+        if (i % 2 == 0) {
+            target->digest[i / 2] = (uint8_t)(nibble << 4);
+        } else {
+            target->digest[i / 2] |= (uint8_t)nibble;
+        }
+    }
+
+    hash_target_from_digest(algo, target->digest, target);
+    return 0;
+}
+
+void hash_target_from_digest(int algo, const uint8_t *digest, md5_target_t *target) {
+    int n = algos[algo].digest_len;
+
+    if (algo == HASH_MD5) {
+        md5_target_from_digest(digest, target);
+        return;
+    }
+    if (target->digest != digest) {
+        memcpy(target->digest, digest, n);
+    }
+    memset(target->digest + n, 0, HASH_DIGEST_MAX - n);
+    memset(target->words, 0, sizeof(target->words));
+    hash_decode(algo, target->words, target->digest, algos[algo].words);
+    target->salt_len = 0;
+    target->reversed_len = 0;
+    target->reversed_steps = 0;
+}
+
+void hash_batch(int algo, const char *const inputs[], const size_t lengths[], int count,
+                uint8_t digests[][HASH_DIGEST_MAX]) {
+    const hash_kernel_t *kernel = hash_kernel_active();
+    const hash_algo_t *a = &algos[algo];
+    uint32_t words[16 * MD5_MAX_LANES] = {0};
+    uint32_t state[8 * MD5_MAX_LANES];
+    int lane_index[MD5_MAX_LANES];
+    int i = 0;
+
+    if (algo == HASH_MD5) {
+        uint8_t md5[MD5_MAX_LANES][MD5_DIGEST_LENGTH];
+        for (; i < count; i += MD5_MAX_LANES) {
+            int n = count - i < MD5_MAX_LANES ? count - i : MD5_MAX_LANES;
+            md5_batch(inputs + i, lengths + i, n, md5);
+            for (int k = 0; k < n; k++) {
+                memset(digests[i + k], 0, HASH_DIGEST_MAX);
+                memcpy(digests[i + k], md5[k], MD5_DIGEST_LENGTH);
+            }
+        }
+        return;
+    }
+
+    while (i < count) {
+        int lanes = 0;
+
+        // Como md5_batch: cada lane guarda o próprio comprimento na palavra 14
+        while (i < count && lanes < kernel->lanes) {
+            if (lengths[i] > (size_t)a->max_len) {
+                hash_digest(algo, inputs[i], lengths[i], digests[i]);
+            } else {
+                md5_pad_lane(words + lanes, MD5_MAX_LANES, (const uint8_t*)inputs[i], lengths[i]);
+                lane_index[lanes++] = i;
+            }
+            i++;
+        }
+        if (lanes == 0) {
+            continue;
+        }
+
+        kernel->match[algo](words, MD5_MAX_LANES, NULL, state);
+
+        for (int l = 0; l < lanes; l++) {
+            uint32_t digest_words[8];
+            for (int w = 0; w < a->words; w++) {
+                digest_words[w] = state[w * kernel->lanes + l] + hash_iv[algo][w];
+            }
+            memset(digests[lane_index[l]], 0, HASH_DIGEST_MAX);
+            hash_encode(algo, digests[lane_index[l]], digest_words, a->words);
+        }
+    }
+}
+
+/**
+ * Estado final esperado sem o estado inicial, como os kernels o comparam
+ */
+static void hash_target_expect(int algo, const md5_target_t *target, uint32_t expect[8]) {
+    memset(expect, 0, 8 * sizeof(uint32_t));
+    for (int w = 0; w < algos[algo].words; w++) {
+        expect[w] = target->words[w] - hash_iv[algo][w];
+    }
+}
+
+int hash_block_batch_find(int algo, const md5_block_batch_t *batch, const md5_target_t *target) {
+    const hash_kernel_t *kernel;
+    uint32_t expect[8];
+
+    if (algo == HASH_MD5) {
+        return md5_block_batch_find(batch, target);
+    }
+    kernel = hash_kernel_active();
+    hash_target_expect(algo, target, expect);
+
+    for (int start = 0; start < batch->count; start += kernel->lanes) {
+        uint32_t mask = kernel->match[algo](&batch->words[0][start], MD5_BATCH_MAX, expect, NULL);
+
+        // Lanes além de count guardam candidatos antigos: descartar
+        if (batch->count - start < 32) {
+            mask &= (1u << (batch->count - start)) - 1;
+        }
+        if (mask != 0) {
+            return start + __builtin_ctz(mask);
+        }
+    }
+    return -1;
+}
+
+int hash_target_set_init(int algo, md5_target_set_t *set, const md5_target_t *targets, int count,
+                         int len) {
+    if (algo == HASH_MD5) {
+        return md5_target_set_init(set, targets, count, len);
+    }
+    if (md5_target_set_alloc(set, count, len) != 0) {
+        return -1;
+    }
+    if (algos[algo].words > 4) {
+        set->tail = calloc((size_t)count, sizeof(*set->tail));
+        if (set->tail == NULL) {
+            md5_target_set_free(set);
+            return -1;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        uint32_t expect[8];
+        hash_target_expect(algo, &targets[i], expect);
+        md5_target_set_insert(set, i, expect);
+        if (set->tail != NULL) {
+            memcpy(set->tail[i], expect + 4, sizeof(set->tail[i]));
+        }
+    }
+    set->last_step = 63;
+    return 0;
+}
+
+int hash_block_batch_find_set(int algo, const md5_block_batch_t *batch, const md5_target_set_t *set,
+                              md5_hit_t *hits) {
+    const hash_kernel_t *kernel;
+    uint32_t state[8 * MD5_MAX_LANES];
+    int words = algos[algo].words;
+    int found = 0;
+
+    if (algo == HASH_MD5) {
+        return md5_block_batch_find_set(batch, set, hits);
+    }
+    kernel = hash_kernel_active();
+
+    for (int start = 0; start < batch->count; start += kernel->lanes) {
+        int lanes = kernel->lanes;
+        kernel->match[algo](&batch->words[0][start], MD5_BATCH_MAX, NULL, state);
+
+        int valid = batch->count - start < lanes ? batch->count - start : lanes;
+        for (int l = 0; l < valid; l++) {
+            int t = md5_target_set_lookup(set, state[l], state[lanes + l],
+                                          state[2 * lanes + l], state[3 * lanes + l]);
+            // SHA: as palavras além da quarta ficam fora da chave
+            for (int w = 4; t >= 0 && w < words; w++) {
+                if (state[w * lanes + l] != set->tail[t][w - 4]) {
+                    t = -1;
+                }
+            }
+            if (t >= 0) {
+                hits[found].index = start + l;
+                hits[found].target = t;
+                found++;
+            }
+        }
+    }
+    return found;
+}
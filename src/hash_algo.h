@@ -0,0 +1,122 @@
+#ifndef HASH_ALGO_H
+#define HASH_ALGO_H
+
+#include "hash_utils.h"
+
+/**
+ * Registro de algoritmos de hash (--algo) - Mini-Projeto 1
+ *
+ * Além do MD5 (hash_utils.h), a busca aceita MD4, NTLM (MD4 da senha em
+ * UTF-16LE), SHA-1 e SHA-256, todos atrás da mesma interface em lote: os
+ * candidatos continuam sendo gravados num md5_block_batch_t (gerador,
+ * wordlist e regras não mudam) e o kernel do algoritmo monta o seu próprio
+ * bloco a partir dele, nos registradores. Cada algoritmo tem um kernel
+ * escalar e kernels SIMD multi-buffer (SSE2/AVX2/AVX-512), escolhidos em
+ * tempo de execução junto com o do MD5 (md5_kernel_name, MD5_KERNEL).
+ *
+ * O MD5 continua com os seus caminhos próprios (alvo revertido, modo
+ * incremental, variantes por comprimento, sal); os outros algoritmos
+ * comparam o estado final inteiro, sempre em lotes de blocos completos.
+ *
+ * No NTLM, cada byte da senha vira um caractere UTF-16LE (Latin-1), e o
+ * bloco único comporta até 27 caracteres.
+ */
+
+#define HASH_HEX_MAX (2 * HASH_DIGEST_MAX + 1)   // Digest em hexadecimal + '\0'
+
+typedef enum {
+    HASH_MD5 = 0,
+    HASH_MD4,
+    HASH_NTLM,
+    HASH_SHA1,
+    HASH_SHA256,
+    HASH_ALGO_COUNT
+} hash_algo_id_t;
+
+/**
+ * Parâmetros de um algoritmo do registro
+ */
+typedef struct {
+    const char *name;       // Nome aceito por --algo ("md5", "md4", "ntlm", "sha1", "sha256")
+    const char *label;      // Nome para as mensagens ("MD5", "SHA-256"...)
+    int digest_len;         // Bytes do digest
+    int words;              // Palavras de 32 bits do estado (digest_len / 4)
+    int max_len;            // Maior candidato num único bloco de 64 bytes
+    int big_endian;         // Palavras do digest em big-endian (SHA)
+} hash_algo_t;
+
+/**
+ * Parâmetros do algoritmo (hash_algo_id_t)
+ */
+const hash_algo_t *hash_algo_get(int algo);
+
+/**
+ * Converte o nome de um algoritmo
+ *
+ * @return hash_algo_id_t, ou -1 se o nome não for conhecido
+ */
+int hash_algo_parse(const char *name);
+
+/**
+ * Decodifica um hash hexadecimal (2 * digest_len caracteres) do algoritmo
+ *
+ * @return 0 em caso de sucesso, -1 se a string não for um hash válido
+ */
+int hash_target_parse(int algo, const char *hex, md5_target_t *target);
+
+/**
+ * Prepara o alvo a partir do digest binário (digest_len bytes), sem sal
+ */
+void hash_target_from_digest(int algo, const uint8_t *digest, md5_target_t *target);
+
+/**
+ * Digest da entrada (qualquer tamanho) pela implementação escalar de
+ * referência (conferência do resultado e testes)
+ */
+void hash_digest(int algo, const char *input, size_t len, uint8_t digest[HASH_DIGEST_MAX]);
+
+/**
+ * Converte um digest binário do algoritmo para hexadecimal
+ */
+void hash_digest_to_hex(int algo, const uint8_t *digest, char output[HASH_HEX_MAX]);
+
+/**
+ * Hash hexadecimal de uma string no algoritmo (como md5_string)
+ */
+void hash_string(int algo, const char *input, char output[HASH_HEX_MAX]);
+
+/**
+ * Calcula o digest de várias entradas de uma vez, como md5_batch: entradas
+ * de até max_len bytes vão pelo kernel SIMD ativo, as maiores pelo caminho
+ * escalar
+ */
+void hash_batch(int algo, const char *const inputs[], const size_t lengths[], int count,
+                uint8_t digests[][HASH_DIGEST_MAX]);
+
+/**
+ * Procura o alvo entre os batch->count candidatos do lote (sem sal;
+ * batch->len <= max_len). No MD5, é md5_block_batch_find.
+ *
+ * @return Índice do primeiro candidato cujo hash é o alvo, ou -1
+ */
+int hash_block_batch_find(int algo, const md5_block_batch_t *batch, const md5_target_t *target);
+
+/**
+ * Monta o conjunto de alvos para candidatos de comprimento len (no MD5, é
+ * md5_target_set_init; nos outros, o conjunto não depende de len)
+ *
+ * @return 0 em caso de sucesso, -1 se faltar memória
+ */
+int hash_target_set_init(int algo, md5_target_set_t *set, const md5_target_t *targets, int count,
+                         int len);
+
+/**
+ * Procura todos os alvos do conjunto entre os candidatos do lote, como
+ * md5_block_batch_find_set
+ *
+ * @return Número de acertos gravados em hits
+ */
+int hash_block_batch_find_set(int algo, const md5_block_batch_t *batch, const md5_target_set_t *set,
+                              md5_hit_t *hits);
+
+#endif // HASH_ALGO_H
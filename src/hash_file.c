@@ -0,0 +1,70 @@
+#include <ctype.h>
+#include "hash_file.h"
+
+static int compare_targets(const void *a, const void *b) {
+    const md5_target_t *x = a, *y = b;
+    int cmp = memcmp(x->digest, y->digest, HASH_DIGEST_MAX);
+    if (cmp == 0 && x->salt_len != y->salt_len) {
+        cmp = x->salt_len < y->salt_len ? -1 : 1;
+    }
+    return cmp != 0 ? cmp : memcmp(x->salt, y->salt, x->salt_len);
+}
+
+int hash_file_load(const char *path, md5_target_t **targets, int algo, int salted) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    md5_target_t *list = NULL;
+    int count = 0, capacity = 0;
+    char line[256];
+    int line_number = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+
+        // Remove espaços nas pontas (inclusive "\r\n")
+        char *start = line;
+        while (isspace((unsigned char)*start)) {
+            start++;
+        }
+        char *end = start + strlen(start);
+        while (end > start && isspace((unsigned char)end[-1])) {
+            *--end = '\0';
+        }
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            md5_target_t *grown = realloc(list, capacity * sizeof(md5_target_t));
+            if (grown == NULL) {
+                free(list);
+                fclose(file);
+                return -1;
+            }
+            list = grown;
+        }
+        if ((salted ? md5_target_parse_salted(start, &list[count])
+                    : hash_target_parse(algo, start, &list[count])) != 0) {
+            fprintf(stderr, "Aviso: %s:%d: hash inválido ignorado: %s\n", path, line_number, start);
+            continue;
+        }
+        count++;
+    }
+    fclose(file);
+
+    // Ordena pelo digest (e pelo sal) e remove repetidos
+    qsort(list, count, sizeof(md5_target_t), compare_targets);
+    int unique = 0;
+    for (int i = 0; i < count; i++) {
+        if (unique == 0 || compare_targets(&list[unique - 1], &list[i]) != 0) {
+            list[unique++] = list[i];
+        }
+    }
+
+    *targets = list;
+    return unique;
+}
@@ -0,0 +1,30 @@
+#ifndef HASH_FILE_H
+#define HASH_FILE_H
+
+#include "hash_utils.h"
+#include "hash_algo.h"
+
+/**
+ * Leitura de listas de hashes (--hash-file) - Mini-Projeto 1
+ *
+ * Formato: um hash hexadecimal por linha (do algoritmo do job, --algo). Linhas vazias e começadas por
+ * '#' são ignoradas; linhas inválidas geram um aviso e também são
+ * ignoradas. Hashes repetidos entram uma única vez.
+ *
+ * Nos formatos com sal (--hash-spec), cada linha é "hash:sal": o sal é o
+ * resto da linha depois do primeiro ':' (até MD5_SALT_MAX bytes, sem os
+ * espaços das pontas), e o mesmo hash com sais diferentes são alvos distintos.
+ */
+
+/**
+ * Carrega e decodifica os hashes de um arquivo
+ *
+ * @param path Caminho do arquivo
+ * @param targets Saída: vetor alocado com malloc (liberar com free)
+ * @param algo hash_algo_id_t dos hashes
+ * @param salted 1 = linhas "hash:sal" (só MD5)
+ * @return Número de alvos distintos, ou -1 se o arquivo não pôde ser lido
+ */
+int hash_file_load(const char *path, md5_target_t **targets, int algo, int salted);
+
+#endif // HASH_FILE_H
@@ -0,0 +1,168 @@
+#ifndef HASH_KERNELS_H
+#define HASH_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hash_algo.h"
+
+/**
+ * Definições internas dos kernels de hash_algo.h (MD4/NTLM, SHA-1, SHA-256).
+ * NÃO faz parte da API pública - use hash_algo.h.
+ *
+ * Como em md5_kernels.h, as funções e os passos são macros de expressão
+ * pura: valem para uint32_t (kernel escalar e implementação de referência)
+ * e para os tipos vetoriais do GCC, então cada compressão é escrita uma vez.
+ */
+
+#define HASH_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define HASH_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+/* Troca a ordem dos bytes de cada palavra (little-endian -> big-endian) */
+#define HASH_BSWAP(x) \
+    (((x) << 24) | (((x) << 8) & 0x00ff0000u) | (((x) >> 8) & 0x0000ff00u) | ((x) >> 24))
+
+/* ---- MD4 (RFC 1320) ---- */
+
+#define MD4_F(x, y, z) (((x) & (y)) | (~(x) & (z)))
+#define MD4_G(x, y, z) (((x) & (y)) | ((x) & (z)) | ((y) & (z)))
+#define MD4_H(x, y, z) ((x) ^ (y) ^ (z))
+
+#define MD4_STEP(f, a, b, c, d, x, s, ac) (a) = HASH_ROTL((a) + f((b), (c), (d)) + (x) + (uint32_t)(ac), s)
+
+/**
+ * Os 48 passos do MD4 sobre as palavras x[0..15], como X-macro:
+ * STEP(f, a, b, c, d, k, s, ac), com k a palavra consumida
+ */
+#define MD4_STEPS(STEP) \
+    STEP(MD4_F, a, b, c, d,  0,  3, 0) STEP(MD4_F, d, a, b, c,  1,  7, 0) \
+    STEP(MD4_F, c, d, a, b,  2, 11, 0) STEP(MD4_F, b, c, d, a,  3, 19, 0) \
+    STEP(MD4_F, a, b, c, d,  4,  3, 0) STEP(MD4_F, d, a, b, c,  5,  7, 0) \
+    STEP(MD4_F, c, d, a, b,  6, 11, 0) STEP(MD4_F, b, c, d, a,  7, 19, 0) \
+    STEP(MD4_F, a, b, c, d,  8,  3, 0) STEP(MD4_F, d, a, b, c,  9,  7, 0) \
+    STEP(MD4_F, c, d, a, b, 10, 11, 0) STEP(MD4_F, b, c, d, a, 11, 19, 0) \
+    STEP(MD4_F, a, b, c, d, 12,  3, 0) STEP(MD4_F, d, a, b, c, 13,  7, 0) \
+    STEP(MD4_F, c, d, a, b, 14, 11, 0) STEP(MD4_F, b, c, d, a, 15, 19, 0) \
+    STEP(MD4_G, a, b, c, d,  0,  3, 0x5a827999) STEP(MD4_G, d, a, b, c,  4,  5, 0x5a827999) \
+    STEP(MD4_G, c, d, a, b,  8,  9, 0x5a827999) STEP(MD4_G, b, c, d, a, 12, 13, 0x5a827999) \
+    STEP(MD4_G, a, b, c, d,  1,  3, 0x5a827999) STEP(MD4_G, d, a, b, c,  5,  5, 0x5a827999) \
+    STEP(MD4_G, c, d, a, b,  9,  9, 0x5a827999) STEP(MD4_G, b, c, d, a, 13, 13, 0x5a827999) \
+    STEP(MD4_G, a, b, c, d,  2,  3, 0x5a827999) STEP(MD4_G, d, a, b, c,  6,  5, 0x5a827999) \
+    STEP(MD4_G, c, d, a, b, 10,  9, 0x5a827999) STEP(MD4_G, b, c, d, a, 14, 13, 0x5a827999) \
+    STEP(MD4_G, a, b, c, d,  3,  3, 0x5a827999) STEP(MD4_G, d, a, b, c,  7,  5, 0x5a827999) \
+    STEP(MD4_G, c, d, a, b, 11,  9, 0x5a827999) STEP(MD4_G, b, c, d, a, 15, 13, 0x5a827999) \
+    STEP(MD4_H, a, b, c, d,  0,  3, 0x6ed9eba1) STEP(MD4_H, d, a, b, c,  8,  9, 0x6ed9eba1) \
+    STEP(MD4_H, c, d, a, b,  4, 11, 0x6ed9eba1) STEP(MD4_H, b, c, d, a, 12, 15, 0x6ed9eba1) \
+    STEP(MD4_H, a, b, c, d,  2,  3, 0x6ed9eba1) STEP(MD4_H, d, a, b, c, 10,  9, 0x6ed9eba1) \
+    STEP(MD4_H, c, d, a, b,  6, 11, 0x6ed9eba1) STEP(MD4_H, b, c, d, a, 14, 15, 0x6ed9eba1) \
+    STEP(MD4_H, a, b, c, d,  1,  3, 0x6ed9eba1) STEP(MD4_H, d, a, b, c,  9,  9, 0x6ed9eba1) \
+    STEP(MD4_H, c, d, a, b,  5, 11, 0x6ed9eba1) STEP(MD4_H, b, c, d, a, 13, 15, 0x6ed9eba1) \
+    STEP(MD4_H, a, b, c, d,  3,  3, 0x6ed9eba1) STEP(MD4_H, d, a, b, c, 11,  9, 0x6ed9eba1) \
+    STEP(MD4_H, c, d, a, b,  7, 11, 0x6ed9eba1) STEP(MD4_H, b, c, d, a, 15, 15, 0x6ed9eba1)
+
+#define MD4_STEP_RUN(f, a, b, c, d, k, s, ac) MD4_STEP(f, a, b, c, d, x[k], s, ac);
+
+/* ---- SHA-1 (FIPS 180-4) ---- */
+
+#define SHA1_CH(x, y, z) (((x) & (y)) | (~(x) & (z)))
+#define SHA1_PARITY(x, y, z) ((x) ^ (y) ^ (z))
+#define SHA1_MAJ(x, y, z) (((x) & (y)) | ((x) & (z)) | ((y) & (z)))
+
+/**
+ * Os 80 passos do SHA-1 sobre w[0..15], que vira a janela circular da
+ * expansão da mensagem (w[t & 15] = W[t]); variáveis a..e do chamador
+ */
+#define SHA1_ROUNDS(T) \
+    _Pragma("GCC unroll 80") \
+    for (int t = 0; t < 80; t++) { \
+        T f; \
+        if (t >= 16) { \
+            w[t & 15] = HASH_ROTL(w[(t + 13) & 15] ^ w[(t + 8) & 15] ^ w[(t + 2) & 15] ^ w[t & 15], 1); \
+        } \
+        if (t < 20) { \
+            f = SHA1_CH(b, c, d) + 0x5a827999u; \
+        } else if (t < 40) { \
+            f = SHA1_PARITY(b, c, d) + 0x6ed9eba1u; \
+        } else if (t < 60) { \
+            f = SHA1_MAJ(b, c, d) + 0x8f1bbcdcu; \
+        } else { \
+            f = SHA1_PARITY(b, c, d) + 0xca62c1d6u; \
+        } \
+        T tmp = HASH_ROTL(a, 5) + f + e + w[t & 15]; \
+        e = d; \
+        d = c; \
+        c = HASH_ROTL(b, 30); \
+        b = a; \
+        a = tmp; \
+    }
+
+/* ---- SHA-256 (FIPS 180-4) ---- */
+
+#define SHA256_CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define SHA256_MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SHA256_S0(x) (HASH_ROTR(x, 2) ^ HASH_ROTR(x, 13) ^ HASH_ROTR(x, 22))
+#define SHA256_S1(x) (HASH_ROTR(x, 6) ^ HASH_ROTR(x, 11) ^ HASH_ROTR(x, 25))
+#define SHA256_s0(x) (HASH_ROTR(x, 7) ^ HASH_ROTR(x, 18) ^ ((x) >> 3))
+#define SHA256_s1(x) (HASH_ROTR(x, 17) ^ HASH_ROTR(x, 19) ^ ((x) >> 10))
+
+extern const uint32_t sha256_k[64];
+
+/**
+ * Os 64 passos do SHA-256 sobre w[0..15] (janela circular, como no SHA-1);
+ * variáveis s0..s7 (a..h) do chamador
+ */
+#define SHA256_ROUNDS(T) \
+    _Pragma("GCC unroll 64") \
+    for (int t = 0; t < 64; t++) { \
+        if (t >= 16) { \
+            w[t & 15] += SHA256_s1(w[(t + 14) & 15]) + w[(t + 9) & 15] + SHA256_s0(w[(t + 1) & 15]); \
+        } \
+        T t1 = s7 + SHA256_S1(s4) + SHA256_CH(s4, s5, s6) + sha256_k[t] + w[t & 15]; \
+        T t2 = SHA256_S0(s0) + SHA256_MAJ(s0, s1, s2); \
+        s7 = s6; \
+        s6 = s5; \
+        s5 = s4; \
+        s4 = s3 + t1; \
+        s3 = s2; \
+        s2 = s1; \
+        s1 = s0; \
+        s0 = t1 + t2; \
+    }
+
+/**
+ * Estado inicial de cada algoritmo (até 8 palavras), na ordem do digest
+ */
+extern const uint32_t hash_iv[HASH_ALGO_COUNT][8];
+
+/**
+ * Assinatura comum dos kernels multi-buffer de hash_algo.h
+ *
+ * words está no layout de md5_block_batch_t (words[j * stride + l] é a
+ * palavra j, little-endian, do bloco MD5 do candidato da lane l: bytes do
+ * candidato, 0x80 e o comprimento em bits na palavra 14, então as lanes
+ * podem ter comprimentos diferentes). Cada kernel monta o seu bloco a partir
+ * dele, nos registradores: o MD4 usa as palavras como estão, o NTLM expande
+ * cada byte para um caractere UTF-16LE (dois bytes) e os SHA invertem a
+ * ordem dos bytes e põem o comprimento na palavra 15.
+ *
+ * Compara o estado final sem o estado inicial (expect = alvo - IV, todas as
+ * palavras do algoritmo; a primeira antes das outras). Com expect == NULL,
+ * grava o estado de cada lane em state_out[i * lanes + l] e devolve todas.
+ *
+ * @return Máscara de bits das lanes cujo estado é exatamente o esperado
+ */
+typedef uint32_t (*hash_match_fn)(const uint32_t *words, size_t stride, const uint32_t *expect,
+                                  uint32_t *state_out);
+
+typedef struct {
+    const char *name;       // O kernel MD5 correspondente ("scalar", "sse2"...)
+    int lanes;
+    hash_match_fn match[HASH_ALGO_COUNT];   // NULL no HASH_MD5 (kernels de md5_kernels.h)
+} hash_kernel_t;
+
+/**
+ * Kernel do mesmo conjunto de instruções que o kernel MD5 ativo
+ * (md5_kernel_name: CPUID, MD5_KERNEL ou md5_select_kernel)
+ */
+const hash_kernel_t *hash_kernel_active(void);
+
+#endif // HASH_KERNELS_H
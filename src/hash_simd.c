@@ -0,0 +1,92 @@
+#include <string.h>
+#include "hash_kernels.h"
+#include "md5_kernels.h"
+
+/**
+ * Kernels multi-buffer de MD4/NTLM, SHA-1 e SHA-256 (hash_algo.h)
+ *
+ * Como em md5_simd.c, cada kernel x86 é gerado a partir de
+ * hash_simd_kernel.h com um __attribute__((target)) diferente; o escalar
+ * usa o mesmo template com uint32_t. O conjunto de instruções não é
+ * escolhido aqui: hash_kernel_active segue o kernel MD5 ativo.
+ */
+
+const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t hash_iv[HASH_ALGO_COUNT][8] = {
+    [HASH_MD5] = {MD5_INIT_A, MD5_INIT_B, MD5_INIT_C, MD5_INIT_D},
+    [HASH_MD4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476},
+    [HASH_NTLM] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476},
+    [HASH_SHA1] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0},
+    [HASH_SHA256] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19},
+};
+
+/* Kernel escalar: 1 lane */
+#define HASH_SIMD_SUFFIX scalar
+#define HASH_SIMD_ATTR
+#define HASH_SIMD_VEC uint32_t
+#define HASH_SIMD_MASK(v) ((uint32_t)(v))
+#include "hash_simd_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HASH_HAVE_X86_KERNELS 1
+
+#include <immintrin.h>
+
+typedef uint32_t hash_vec4 __attribute__((vector_size(16)));
+typedef uint32_t hash_vec8 __attribute__((vector_size(32)));
+typedef uint32_t hash_vec16 __attribute__((vector_size(64)));
+
+#define HASH_SIMD_SUFFIX sse2
+#define HASH_SIMD_ATTR __attribute__((target("sse2")))
+#define HASH_SIMD_VEC hash_vec4
+#define HASH_SIMD_MASK(v) ((uint32_t)_mm_movemask_ps((__m128)(v)))
+#include "hash_simd_kernel.h"
+
+#define HASH_SIMD_SUFFIX avx2
+#define HASH_SIMD_ATTR __attribute__((target("avx2")))
+#define HASH_SIMD_VEC hash_vec8
+#define HASH_SIMD_MASK(v) ((uint32_t)_mm256_movemask_ps((__m256)(v)))
+#include "hash_simd_kernel.h"
+
+#define HASH_SIMD_SUFFIX avx512
+#define HASH_SIMD_ATTR __attribute__((target("avx512f")))
+#define HASH_SIMD_VEC hash_vec16
+#define HASH_SIMD_MASK(v) ((uint32_t)_mm512_test_epi32_mask((__m512i)(v), (__m512i)(v)))
+#include "hash_simd_kernel.h"
+#endif
+
+#define HASH_KERNEL_ENTRY(name, lanes, sfx) \
+    {name, lanes, {NULL, hash_md4_##sfx, hash_ntlm_##sfx, hash_sha1_##sfx, hash_sha256_##sfx}}
+
+// Mesmos nomes da tabela de md5_simd.c
+static const hash_kernel_t kernels[] = {
+#ifdef HASH_HAVE_X86_KERNELS
+    HASH_KERNEL_ENTRY("avx512", 16, avx512),
+    HASH_KERNEL_ENTRY("avx2", 8, avx2),
+    HASH_KERNEL_ENTRY("sse2", 4, sse2),
+#endif
+    HASH_KERNEL_ENTRY("scalar", 1, scalar),
+    {NULL, 0, {NULL}}
+};
+
+const hash_kernel_t *hash_kernel_active(void) {
+    const char *name = md5_kernel_name();
+
+    for (const hash_kernel_t *k = kernels; k->name != NULL; k++) {
+        if (strcmp(k->name, name) == 0) {
+            return k;
+        }
+    }
+    return &kernels[sizeof(kernels) / sizeof(kernels[0]) - 2];     // Escalar
+}
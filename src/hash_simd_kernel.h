@@ -0,0 +1,162 @@
+/**
+ * Template dos kernels multi-buffer de hash_algo.h - incluído uma vez por
+ * conjunto de instruções em hash_simd.c (sem include guard de propósito),
+ * como md5_simd_kernel.h.
+ *
+ * Antes de incluir, defina:
+ *   HASH_SIMD_SUFFIX - sufixo dos nomes gerados (hash_md4_<sufixo>...)
+ *   HASH_SIMD_ATTR   - atributos das funções (__attribute__((target(...))) ou nada)
+ *   HASH_SIMD_VEC    - tipo de 32 bits por lane (vector_size; uint32_t no escalar)
+ *   HASH_SIMD_MASK(v) - máscara de bits das lanes não nulas de v
+ *
+ * Gera hash_md4_, hash_ntlm_, hash_sha1_ e hash_sha256_<sufixo>, com a
+ * assinatura hash_match_fn (hash_kernels.h). Os passos vêm das macros de
+ * hash_kernels.h, as mesmas da implementação de referência.
+ */
+
+#ifndef HASH_SIMD_RETURN
+#define HASH_CAT(a, b) HASH_CAT_(a, b)
+#define HASH_CAT_(a, b) a##b
+
+/* Palavra j de todas as lanes do lote */
+#define HASH_SIMD_LOAD(v, j) memcpy(&(v), words + (j) * stride, sizeof(HASH_SIMD_VEC))
+
+/**
+ * Sem alvo, grava as n palavras do estado de cada lane; com alvo, compara a
+ * primeira palavra e, só se alguma lane bate, as outras
+ */
+#define HASH_SIMD_RETURN(st, n) \
+    do { \
+        const size_t lanes = sizeof(HASH_SIMD_VEC) / sizeof(uint32_t); \
+        uint32_t mask; \
+        if (expect == NULL) { \
+            for (int i = 0; i < (n); i++) { \
+                memcpy(state_out + i * lanes, &(st)[i], sizeof(HASH_SIMD_VEC)); \
+            } \
+            return (uint32_t)((1ull << lanes) - 1); \
+        } \
+        mask = HASH_SIMD_MASK((st)[0] == expect[0]); \
+        if (mask == 0) { \
+            return 0; \
+        } \
+        md5_prefilter_passes += __builtin_popcount(mask); \
+        for (int i = 1; i < (n); i++) { \
+            mask &= HASH_SIMD_MASK((st)[i] == expect[i]); \
+        } \
+        return mask; \
+    } while (0)
+#endif
+
+/* MD4 e NTLM: mesmo corpo; no NTLM, a mensagem é a senha em UTF-16LE */
+HASH_SIMD_ATTR __attribute__((always_inline))
+static inline uint32_t HASH_CAT(hash_md4_body_, HASH_SIMD_SUFFIX)(const uint32_t *words, size_t stride,
+                                                                  const uint32_t *expect,
+                                                                  uint32_t *state_out, const int ntlm) {
+    HASH_SIMD_VEC x[16];
+    HASH_SIMD_VEC a, b, c, d;
+
+    if (ntlm) {
+        // Cada palavra do candidato (4 bytes) vira duas (4 caracteres de 16 bits);
+        // o 0x80 do padding cai no byte 2 * len, e o comprimento em bits dobra
+#pragma GCC unroll 7
+        for (int j = 0; j < 7; j++) {
+            HASH_SIMD_VEC v;
+            HASH_SIMD_LOAD(v, j);
+            x[2 * j] = (v & 0xffu) | ((v & 0xff00u) << 8);
+            x[2 * j + 1] = ((v >> 16) & 0xffu) | ((v >> 8) & 0xff0000u);
+        }
+        HASH_SIMD_LOAD(x[14], 14);
+        x[14] <<= 1;
+        x[15] = (HASH_SIMD_VEC){0};
+    } else {
+#pragma GCC unroll 16
+        for (int j = 0; j < 16; j++) {
+            HASH_SIMD_LOAD(x[j], j);
+        }
+    }
+
+    a = (HASH_SIMD_VEC){0} + hash_iv[HASH_MD4][0];
+    b = (HASH_SIMD_VEC){0} + hash_iv[HASH_MD4][1];
+    c = (HASH_SIMD_VEC){0} + hash_iv[HASH_MD4][2];
+    d = (HASH_SIMD_VEC){0} + hash_iv[HASH_MD4][3];
+
+    MD4_STEPS(MD4_STEP_RUN)
+
+    HASH_SIMD_VEC st[4] = {a, b, c, d};
+    HASH_SIMD_RETURN(st, 4);
+}
+
+HASH_SIMD_ATTR
+static uint32_t HASH_CAT(hash_md4_, HASH_SIMD_SUFFIX)(const uint32_t *words, size_t stride,
+                                                      const uint32_t *expect, uint32_t *state_out) {
+    return HASH_CAT(hash_md4_body_, HASH_SIMD_SUFFIX)(words, stride, expect, state_out, 0);
+}
+
+HASH_SIMD_ATTR
+static uint32_t HASH_CAT(hash_ntlm_, HASH_SIMD_SUFFIX)(const uint32_t *words, size_t stride,
+                                                       const uint32_t *expect, uint32_t *state_out) {
+    return HASH_CAT(hash_md4_body_, HASH_SIMD_SUFFIX)(words, stride, expect, state_out, 1);
+}
+
+/* SHA-1 e SHA-256: palavras big-endian, comprimento (64 bits) nas palavras 14-15 */
+HASH_SIMD_ATTR
+static uint32_t HASH_CAT(hash_sha1_, HASH_SIMD_SUFFIX)(const uint32_t *words, size_t stride,
+                                                       const uint32_t *expect, uint32_t *state_out) {
+    HASH_SIMD_VEC w[16];
+    HASH_SIMD_VEC a, b, c, d, e;
+
+#pragma GCC unroll 14
+    for (int j = 0; j < 14; j++) {
+        HASH_SIMD_VEC v;
+        HASH_SIMD_LOAD(v, j);
+        w[j] = HASH_BSWAP(v);
+    }
+    w[14] = (HASH_SIMD_VEC){0};
+    HASH_SIMD_LOAD(w[15], 14);
+
+    a = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA1][0];
+    b = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA1][1];
+    c = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA1][2];
+    d = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA1][3];
+    e = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA1][4];
+
+    SHA1_ROUNDS(HASH_SIMD_VEC)
+
+    HASH_SIMD_VEC st[5] = {a, b, c, d, e};
+    HASH_SIMD_RETURN(st, 5);
+}
+
+HASH_SIMD_ATTR
+static uint32_t HASH_CAT(hash_sha256_, HASH_SIMD_SUFFIX)(const uint32_t *words, size_t stride,
+                                                         const uint32_t *expect, uint32_t *state_out) {
+    HASH_SIMD_VEC w[16];
+    HASH_SIMD_VEC s0, s1, s2, s3, s4, s5, s6, s7;
+
+#pragma GCC unroll 14
+    for (int j = 0; j < 14; j++) {
+        HASH_SIMD_VEC v;
+        HASH_SIMD_LOAD(v, j);
+        w[j] = HASH_BSWAP(v);
+    }
+    w[14] = (HASH_SIMD_VEC){0};
+    HASH_SIMD_LOAD(w[15], 14);
+
+    s0 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][0];
+    s1 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][1];
+    s2 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][2];
+    s3 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][3];
+    s4 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][4];
+    s5 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][5];
+    s6 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][6];
+    s7 = (HASH_SIMD_VEC){0} + hash_iv[HASH_SHA256][7];
+
+    SHA256_ROUNDS(HASH_SIMD_VEC)
+
+    HASH_SIMD_VEC st[8] = {s0, s1, s2, s3, s4, s5, s6, s7};
+    HASH_SIMD_RETURN(st, 8);
+}
+
+#undef HASH_SIMD_SUFFIX
+#undef HASH_SIMD_ATTR
+#undef HASH_SIMD_VEC
+#undef HASH_SIMD_MASK
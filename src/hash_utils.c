@@ -1,4 +1,5 @@
 #include "hash_utils.h"
+#include "md5_kernels.h"
 
 // Implementação MD5 de domínio público
 // Baseada na RFC 1321
@@ -9,67 +10,22 @@ typedef struct {
     uint8_t buffer[64];
 } MD5_CTX;
 
-#define S11 7
-#define S12 12
-#define S13 17
-#define S14 22
-#define S21 5
-#define S22 9
-#define S23 14
-#define S24 20
-#define S31 4
-#define S32 11
-#define S33 16
-#define S34 23
-#define S41 6
-#define S42 10
-#define S43 15
-#define S44 21
-
 static uint8_t PADDING[64] = {
     0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
-#define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
-#define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
-#define H(x, y, z) ((x) ^ (y) ^ (z))
-#define I(x, y, z) ((y) ^ ((x) | (~z)))
-
-#define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32-(n))))
-
-#define FF(a, b, c, d, x, s, ac) { \
-    (a) += F ((b), (c), (d)) + (x) + (uint32_t)(ac); \
-    (a) = ROTATE_LEFT ((a), (s)); \
-    (a) += (b); \
-}
-#define GG(a, b, c, d, x, s, ac) { \
-    (a) += G ((b), (c), (d)) + (x) + (uint32_t)(ac); \
-    (a) = ROTATE_LEFT ((a), (s)); \
-    (a) += (b); \
-}
-#define HH(a, b, c, d, x, s, ac) { \
-    (a) += H ((b), (c), (d)) + (x) + (uint32_t)(ac); \
-    (a) = ROTATE_LEFT ((a), (s)); \
-    (a) += (b); \
-}
-#define II(a, b, c, d, x, s, ac) { \
-    (a) += I ((b), (c), (d)) + (x) + (uint32_t)(ac); \
-    (a) = ROTATE_LEFT ((a), (s)); \
-    (a) += (b); \
-}
-
 static void MD5Transform(uint32_t state[4], const uint8_t block[64]);
 static void Encode(uint8_t *output, const uint32_t *input, size_t len);
 static void Decode(uint32_t *output, const uint8_t *input, size_t len);
 
 static void MD5Init(MD5_CTX *context) {
     context->count[0] = context->count[1] = 0;
-    context->state[0] = 0x67452301;
-    context->state[1] = 0xefcdab89;
-    context->state[2] = 0x98badcfe;
-    context->state[3] = 0x10325476;
+    context->state[0] = MD5_INIT_A;
+    context->state[1] = MD5_INIT_B;
+    context->state[2] = MD5_INIT_C;
+    context->state[3] = MD5_INIT_D;
 }
 
 static void MD5Update(MD5_CTX *context, const uint8_t *input, size_t inputLen) {
@@ -116,84 +72,26 @@ static void MD5Final(uint8_t digest[MD5_DIGEST_LENGTH], MD5_CTX *context) {
 }
 
 static void MD5Transform(uint32_t state[4], const uint8_t block[64]) {
-    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], x[16];
+    uint32_t x[16];
 
     Decode(x, block, 64);
+    md5_compress(state, x);
+
+    memset(x, 0, sizeof(x));
+}
+
+/**
+ * Compressão MD5 sobre palavras já decodificadas (usada também pelo kernel escalar)
+ */
+void md5_compress(uint32_t state[4], const uint32_t x[16]) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
 
-    FF(a, b, c, d, x[ 0], S11, 0xd76aa478);
-    FF(d, a, b, c, x[ 1], S12, 0xe8c7b756);
-    FF(c, d, a, b, x[ 2], S13, 0x242070db);
-    FF(b, c, d, a, x[ 3], S14, 0xc1bdceee);
-    FF(a, b, c, d, x[ 4], S11, 0xf57c0faf);
-    FF(d, a, b, c, x[ 5], S12, 0x4787c62a);
-    FF(c, d, a, b, x[ 6], S13, 0xa8304613);
-    FF(b, c, d, a, x[ 7], S14, 0xfd469501);
-    FF(a, b, c, d, x[ 8], S11, 0x698098d8);
-    FF(d, a, b, c, x[ 9], S12, 0x8b44f7af);
-    FF(c, d, a, b, x[10], S13, 0xffff5bb1);
-    FF(b, c, d, a, x[11], S14, 0x895cd7be);
-    FF(a, b, c, d, x[12], S11, 0x6b901122);
-    FF(d, a, b, c, x[13], S12, 0xfd987193);
-    FF(c, d, a, b, x[14], S13, 0xa679438e);
-    FF(b, c, d, a, x[15], S14, 0x49b40821);
-
-    GG(a, b, c, d, x[ 1], S21, 0xf61e2562);
-    GG(d, a, b, c, x[ 6], S22, 0xc040b340);
-    GG(c, d, a, b, x[11], S23, 0x265e5a51);
-    GG(b, c, d, a, x[ 0], S24, 0xe9b6c7aa);
-    GG(a, b, c, d, x[ 5], S21, 0xd62f105d);
-    GG(d, a, b, c, x[10], S22,  0x2441453);
-    GG(c, d, a, b, x[15], S23, 0xd8a1e681);
-    GG(b, c, d, a, x[ 4], S24, 0xe7d3fbc8);
-    GG(a, b, c, d, x[ 9], S21, 0x21e1cde6);
-    GG(d, a, b, c, x[14], S22, 0xc33707d6);
-    GG(c, d, a, b, x[ 3], S23, 0xf4d50d87);
-    GG(b, c, d, a, x[ 8], S24, 0x455a14ed);
-    GG(a, b, c, d, x[13], S21, 0xa9e3e905);
-    GG(d, a, b, c, x[ 2], S22, 0xfcefa3f8);
-    GG(c, d, a, b, x[ 7], S23, 0x676f02d9);
-    GG(b, c, d, a, x[12], S24, 0x8d2a4c8a);
-
-    HH(a, b, c, d, x[ 5], S31, 0xfffa3942);
-    HH(d, a, b, c, x[ 8], S32, 0x8771f681);
-    HH(c, d, a, b, x[11], S33, 0x6d9d6122);
-    HH(b, c, d, a, x[14], S34, 0xfde5380c);
-    HH(a, b, c, d, x[ 1], S31, 0xa4beea44);
-    HH(d, a, b, c, x[ 4], S32, 0x4bdecfa9);
-    HH(c, d, a, b, x[ 7], S33, 0xf6bb4b60);
-    HH(b, c, d, a, x[10], S34, 0xbebfbc70);
-    HH(a, b, c, d, x[13], S31, 0x289b7ec6);
-    HH(d, a, b, c, x[ 0], S32, 0xeaa127fa);
-    HH(c, d, a, b, x[ 3], S33, 0xd4ef3085);
-    HH(b, c, d, a, x[ 6], S34,  0x4881d05);
-    HH(a, b, c, d, x[ 9], S31, 0xd9d4d039);
-    HH(d, a, b, c, x[12], S32, 0xe6db99e5);
-    HH(c, d, a, b, x[15], S33, 0x1fa27cf8);
-    HH(b, c, d, a, x[ 2], S34, 0xc4ac5665);
-
-    II(a, b, c, d, x[ 0], S41, 0xf4292244);
-    II(d, a, b, c, x[ 7], S42, 0x432aff97);
-    II(c, d, a, b, x[14], S43, 0xab9423a7);
-    II(b, c, d, a, x[ 5], S44, 0xfc93a039);
-    II(a, b, c, d, x[12], S41, 0x655b59c3);
-    II(d, a, b, c, x[ 3], S42, 0x8f0ccc92);
-    II(c, d, a, b, x[10], S43, 0xffeff47d);
-    II(b, c, d, a, x[ 1], S44, 0x85845dd1);
-    II(a, b, c, d, x[ 8], S41, 0x6fa87e4f);
-    II(d, a, b, c, x[15], S42, 0xfe2ce6e0);
-    II(c, d, a, b, x[ 6], S43, 0xa3014314);
-    II(b, c, d, a, x[13], S44, 0x4e0811a1);
-    II(a, b, c, d, x[ 4], S41, 0xf7537e82);
-    II(d, a, b, c, x[11], S42, 0xbd3af235);
-    II(c, d, a, b, x[ 2], S43, 0x2ad7d2bb);
-    II(b, c, d, a, x[ 9], S44, 0xeb86d391);
+    MD5_STEPS(MD5_STEP_RUN)
 
     state[0] += a;
     state[1] += b;
     state[2] += c;
     state[3] += d;
-
-    memset(x, 0, sizeof(x));
 }
 
 static void Encode(uint8_t *output, const uint32_t *input, size_t len) {
@@ -215,13 +113,613 @@ static void Decode(uint32_t *output, const uint8_t *input, size_t len) {
                     (((uint32_t)input[j+2]) << 16) | (((uint32_t)input[j+3]) << 24);
 }
 
+/**
+ * MD5 completo de um buffer de bytes (qualquer tamanho)
+ */
+static void md5_bytes(const uint8_t *input, size_t len, uint8_t digest[MD5_DIGEST_LENGTH]) {
+    MD5_CTX ctx;
+
+    MD5Init(&ctx);
+    MD5Update(&ctx, input, len);
+    MD5Final(digest, &ctx);
+}
+
+void md5_pad_lane(uint32_t *words, size_t stride, const uint8_t *input, size_t len) {
+    uint8_t block[64] = {0};
+    uint32_t x[16];
+
+    memcpy(block, input, len);
+    block[len] = 0x80;
+    Decode(x, block, 56);
+    x[14] = (uint32_t)(len << 3);
+    x[15] = 0;
+
+    for (int j = 0; j < 16; j++) {
+        words[j * stride] = x[j];
+    }
+}
+
+void md5_batch(const char *const inputs[], const size_t lengths[], int count,
+               uint8_t digests[][MD5_DIGEST_LENGTH]) {
+    const md5_kernel_t *kernel = md5_kernel_active();
+    uint32_t words[16 * MD5_MAX_LANES] = {0};
+    uint32_t state[4 * MD5_MAX_LANES];
+    int lane_index[MD5_MAX_LANES];
+    int i = 0;
+
+    while (i < count) {
+        int lanes = 0;
+
+        // Junta até kernel->lanes entradas de bloco único; as longas vão pelo caminho escalar
+        while (i < count && lanes < kernel->lanes) {
+            if (lengths[i] > MD5_SINGLE_BLOCK_MAX) {
+                md5_bytes((const uint8_t*)inputs[i], lengths[i], digests[i]);
+            } else {
+                md5_pad_lane(words + lanes, MD5_MAX_LANES, (const uint8_t*)inputs[i], lengths[i]);
+                lane_index[lanes++] = i;
+            }
+            i++;
+        }
+        if (lanes == 0) {
+            continue;
+        }
+
+        // Lanes sobrando num lote parcial são calculadas sobre lixo e descartadas
+        kernel->fn(words, MD5_MAX_LANES, state, MD5_MAX_LANES);
+
+        for (int l = 0; l < lanes; l++) {
+            uint32_t digest_words[4];
+            for (int w = 0; w < 4; w++) {
+                digest_words[w] = state[w * MD5_MAX_LANES + l];
+            }
+            Encode(digests[lane_index[l]], digest_words, 16);
+        }
+    }
+}
+
+int md5_target_parse(const char *hex, md5_target_t *target) {
+    if (hex == NULL || strlen(hex) != 2 * MD5_DIGEST_LENGTH) {
+        return -1;
+    }
+
+    for (int i = 0; i < 2 * MD5_DIGEST_LENGTH; i++) {
+        char ch = hex[i];
+        int nibble;
+
+        if (ch >= '0' && ch <= '9') {
+            nibble = ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            nibble = ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+            nibble = ch - 'A' + 10;
+        } else {
+            return -1;
+        }
+
+        if (i % 2 == 0) {
+            target->digest[i / 2] = (uint8_t)(nibble << 4);
+        } else {
+            target->digest[i / 2] |= (uint8_t)nibble;
+        }
+    }
+
+    md5_target_from_digest(target->digest, target);
+    return 0;
+}
+
+void md5_target_from_digest(const uint8_t digest[MD5_DIGEST_LENGTH], md5_target_t *target) {
+    if (target->digest != digest) {
+        memcpy(target->digest, digest, MD5_DIGEST_LENGTH);
+    }
+    memset(target->digest + MD5_DIGEST_LENGTH, 0, HASH_DIGEST_MAX - MD5_DIGEST_LENGTH);
+    memset(target->words, 0, sizeof(target->words));
+    Decode(target->words, target->digest, MD5_DIGEST_LENGTH);
+    target->salt_len = 0;
+    target->reversed_len = 0;
+    target->reversed_steps = 0;
+}
+
+int md5_target_parse_salted(const char *text, md5_target_t *target) {
+    char hex[2 * MD5_DIGEST_LENGTH + 1];
+    const char *salt = text + 2 * MD5_DIGEST_LENGTH + 1;
+
+    if (text == NULL || strnlen(text, sizeof(hex)) < sizeof(hex) ||
+        text[2 * MD5_DIGEST_LENGTH] != ':' || strlen(salt) > MD5_SALT_MAX) {
+        return -1;
+    }
+    memcpy(hex, text, 2 * MD5_DIGEST_LENGTH);
+    hex[2 * MD5_DIGEST_LENGTH] = '\0';
+    if (md5_target_parse(hex, target) != 0) {
+        return -1;
+    }
+    target->salt_len = (int)strlen(salt);
+    memcpy(target->salt, salt, target->salt_len);
+    return 0;
+}
+
+static const char *const md5_spec_names[] = {"md5", "md5(salt.pass)", "md5(pass.salt)"};
+
+int md5_spec_parse(const char *name) {
+    for (int spec = MD5_SPEC_PLAIN; spec <= MD5_SPEC_PASS_SALT; spec++) {
+        if (strcmp(name, md5_spec_names[spec]) == 0) {
+            return spec;
+        }
+    }
+    return -1;
+}
+
+const char *md5_spec_name(int spec) {
+    return md5_spec_names[spec];
+}
+
+int md5_spec_max_len(int spec, int salt_len) {
+    return MD5_SINGLE_BLOCK_MAX - (spec == MD5_SPEC_SALT_PASS ? salt_len % 64 : salt_len);
+}
+
+void md5_spec_string(int spec, const md5_target_t *target, const char *password, char output[33]) {
+    uint8_t digest[MD5_DIGEST_LENGTH];
+    MD5_CTX ctx;
+
+    MD5Init(&ctx);
+    if (spec == MD5_SPEC_SALT_PASS) {
+        MD5Update(&ctx, target->salt, target->salt_len);
+    }
+    MD5Update(&ctx, (const uint8_t*)password, strlen(password));
+    if (spec == MD5_SPEC_PASS_SALT) {
+        MD5Update(&ctx, target->salt, target->salt_len);
+    }
+    MD5Final(digest, &ctx);
+    md5_digest_to_hex(digest, output);
+}
+
+int md5_salted_init(md5_salted_t *salted, int spec, const uint8_t *salt, int salt_len, int len) {
+    uint8_t block[64] = {0};
+    int blocks = spec == MD5_SPEC_SALT_PASS ? salt_len / 64 : 0;
+    int rest = salt_len - 64 * blocks;
+
+    if (len < 1 || len > md5_spec_max_len(spec, salt_len)) {
+        return -1;
+    }
+
+    // Blocos inteiros do sal: comprimidos uma vez (midstate)
+    salted->iv[0] = MD5_INIT_A;
+    salted->iv[1] = MD5_INIT_B;
+    salted->iv[2] = MD5_INIT_C;
+    salted->iv[3] = MD5_INIT_D;
+    for (int i = 0; i < blocks; i++) {
+        uint32_t x[16];
+        Decode(x, salt + 64 * i, 64);
+        md5_compress(salted->iv, x);
+    }
+
+    // Resto do sal antes (salt.pass) ou depois (pass.salt) do candidato
+    salted->len = len;
+    salted->blocks = blocks;
+    salted->offset = spec == MD5_SPEC_SALT_PASS ? rest : 0;
+    memcpy(block + (spec == MD5_SPEC_SALT_PASS ? 0 : len), salt + 64 * blocks, rest);
+    block[rest + len] = 0x80;
+    Decode(salted->words, block, 64);
+    salted->words[14] = (uint32_t)(salt_len + len) << 3;
+    return 0;
+}
+
+// Parâmetros de cada passo, extraídos da mesma lista usada pelos kernels
+#define MD5_STEP_INFO(n, op, a, b, c, d, k, s, ac) {MD5_REG_##a, k, s, ac},
+static const struct {
+    uint8_t reg;        // registrador atualizado (0=a, 1=b, 2=c, 3=d)
+    uint8_t k;          // palavra da mensagem consumida
+    uint8_t s;          // rotação
+    uint32_t ac;        // constante aditiva
+} md5_step_info[64] = { MD5_STEPS(MD5_STEP_INFO) };
+
+/**
+ * Desfaz os passos finais que só usam palavras constantes do bloco x (as
+ * palavras first_varying..last_varying contêm o candidato), a partir do
+ * digest menos o estado inicial iv
+ */
+static void md5_target_reverse_block(md5_target_t *target, int len, const uint32_t x[16],
+                                     const uint32_t iv[4], int first_varying, int last_varying) {
+    uint32_t st[4];
+    int steps = 0;
+
+    for (int i = 0; i < 4; i++) {
+        st[i] = target->words[i] - iv[i];
+    }
+
+    // O kernel compara no passo 48 ou depois: no máximo os passos 49..63
+    for (int n = 63; n > 48 && (md5_step_info[n].k < first_varying ||
+                                md5_step_info[n].k > last_varying); n--) {
+        int r = md5_step_info[n].reg;
+        uint32_t b = st[(r + 1) & 3], c = st[(r + 2) & 3], d = st[(r + 3) & 3];
+        uint32_t v = st[r] - b;
+
+        // Inverso de a = b + ROTATE_LEFT(a + I(b, c, d) + x[k] + ac, s)
+        v = (v >> md5_step_info[n].s) | (v << (32 - md5_step_info[n].s));
+        st[r] = v - I(b, c, d) - x[md5_step_info[n].k] - md5_step_info[n].ac;
+        steps++;
+    }
+
+    memcpy(target->reversed, st, sizeof(st));
+    target->reversed_steps = steps;
+    target->reversed_len = len;
+}
+
+void md5_target_reverse(md5_target_t *target, int len) {
+    static const uint32_t iv[4] = {MD5_INIT_A, MD5_INIT_B, MD5_INIT_C, MD5_INIT_D};
+    uint32_t x[16] = {0};
+
+    x[len / 4] = 0x80u << (8 * (len % 4));
+    x[14] = (uint32_t)len << 3;
+    md5_target_reverse_block(target, len, x, iv, 0, (len - 1) / 4);
+}
+
+void md5_target_reverse_salted(md5_target_t *target, const md5_salted_t *salted) {
+    md5_target_reverse_block(target, salted->len, salted->words, salted->iv, salted->offset / 4,
+                             (salted->offset + salted->len - 1) / 4);
+}
+
+/**
+ * Escolhe o ponto de comparação dos kernels para candidatos de comprimento len:
+ * o alvo revertido, se foi calculado para esse comprimento, ou o estado final
+ * (digest menos o IV, gravado em plain) comparado após o passo 63.
+ */
+static void md5_target_expect(const md5_target_t *target, int len, uint32_t plain[4],
+                              const uint32_t **expect, int *last_step) {
+    if (target->reversed_len == len) {
+        *expect = target->reversed;
+        *last_step = 63 - target->reversed_steps;
+        return;
+    }
+
+    plain[0] = target->words[0] - MD5_INIT_A;
+    plain[1] = target->words[1] - MD5_INIT_B;
+    plain[2] = target->words[2] - MD5_INIT_C;
+    plain[3] = target->words[3] - MD5_INIT_D;
+    *expect = plain;
+    *last_step = 63;
+}
+
+// Bits do bitmap por alvo: ~3% dos candidatos passam do pré-filtro
+#define MD5_SET_BITMAP_BITS_PER_TARGET 32
+#define MD5_SET_BITMAP_MIN_BITS (1u << 12)
+#define MD5_SET_BITMAP_MAX_BITS (1u << 31)
+
+int md5_target_set_alloc(md5_target_set_t *set, int count, int len) {
+    uint64_t bits = MD5_SET_BITMAP_MIN_BITS;
+    uint32_t slots = 2;
+    int table_bits = 1;
+
+    memset(set, 0, sizeof(*set));
+    while (bits < (uint64_t)count * MD5_SET_BITMAP_BITS_PER_TARGET && bits < MD5_SET_BITMAP_MAX_BITS) {
+        bits <<= 1;
+    }
+    // Tabela com ocupação <= 50%: sondagens curtas
+    while (slots < 2u * (uint32_t)count) {
+        slots <<= 1;
+        table_bits++;
+    }
+
+    set->expect = malloc((size_t)count * sizeof(*set->expect));
+    set->bitmap = calloc(bits / 64, sizeof(uint64_t));
+    set->table = calloc(slots, sizeof(uint32_t));
+    if (set->expect == NULL || set->bitmap == NULL || set->table == NULL) {
+        md5_target_set_free(set);
+        return -1;
+    }
+    set->len = len;
+    set->count = count;
+    set->bitmap_mask = (uint32_t)(bits - 1);
+    set->table_mask = slots - 1;
+    set->table_shift = 32 - table_bits;
+    return 0;
+}
+
+void md5_target_set_insert(md5_target_set_t *set, int i, const uint32_t expect[4]) {
+    uint32_t a = expect[0];
+
+    memcpy(set->expect[i], expect, sizeof(set->expect[i]));
+    set->bitmap[(a & set->bitmap_mask) >> 6] |= 1ull << (a & 63);
+
+    uint32_t pos = (a * MD5_SET_HASH_MULT) >> set->table_shift;
+    while (set->table[pos] != 0) {
+        pos = (pos + 1) & set->table_mask;
+    }
+    set->table[pos] = (uint32_t)i + 1;
+}
+
+/**
+ * Monta o conjunto para candidatos de comprimento len, com os alvos
+ * revertidos sobre o bloco com sal (ou sem sal, com salted == NULL)
+ */
+static int md5_target_set_build(md5_target_set_t *set, const md5_target_t *targets, int count,
+                                int len, const md5_salted_t *salted) {
+    if (md5_target_set_alloc(set, count, len) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        md5_target_t t = targets[i];
+        if (salted != NULL) {
+            md5_target_reverse_salted(&t, salted);
+        } else {
+            md5_target_reverse(&t, len);
+        }
+        md5_target_set_insert(set, i, t.reversed);
+        set->last_step = 63 - t.reversed_steps;     // Igual para todos: só depende de len
+    }
+    return 0;
+}
+
+int md5_target_set_init(md5_target_set_t *set, const md5_target_t *targets, int count, int len) {
+    return md5_target_set_build(set, targets, count, len, NULL);
+}
+
+int md5_target_set_init_salted(md5_target_set_t *set, const md5_target_t *targets, int count,
+                               const md5_salted_t *salted) {
+    return md5_target_set_build(set, targets, count, salted->len, salted);
+}
+
+void md5_target_set_free(md5_target_set_t *set) {
+    free(set->expect);
+    free(set->bitmap);
+    free(set->table);
+    free(set->tail);
+    memset(set, 0, sizeof(*set));
+}
+
+void md5_block_batch_init(md5_block_batch_t *batch, int len) {
+    memset(batch, 0, sizeof(*batch));
+    batch->len = len;
+
+    for (int l = 0; l < MD5_BATCH_MAX; l++) {
+        batch->words[len / 4][l] = 0x80u << (8 * (len % 4));
+        batch->words[14][l] = (uint32_t)len << 3;
+    }
+}
+
+void md5_block_batch_init_salted(md5_block_batch_t *batch, const md5_salted_t *salted) {
+    memset(batch, 0, sizeof(*batch));
+    batch->len = salted->len;
+    batch->offset = salted->offset;
+    batch->salted = 1;
+    memcpy(batch->tmpl, salted->words, sizeof(batch->tmpl));
+    memcpy(batch->iv, salted->iv, sizeof(batch->iv));
+
+    for (int j = 0; j < 16; j++) {
+        for (int l = 0; l < MD5_BATCH_MAX; l++) {
+            batch->words[j][l] = salted->words[j];
+        }
+    }
+}
+
+/**
+ * md5_block_batch_set com sal: as palavras do candidato partem do molde,
+ * que pode ter bytes do sal e o padding nas pontas
+ */
+static void md5_block_batch_set_salted(md5_block_batch_t *batch, int lane, const uint8_t *p) {
+    int end = batch->offset + batch->len;
+
+    for (int j = batch->offset / 4; j <= (end - 1) / 4; j++) {
+        batch->words[j][lane] = batch->tmpl[j];
+    }
+    for (int i = batch->offset; i < end; i++) {
+        batch->words[i / 4][lane] |= ((uint32_t)*p++) << (8 * (i % 4));
+    }
+}
+
+void md5_block_batch_set(md5_block_batch_t *batch, int lane, const char *candidate) {
+    const uint8_t *p = (const uint8_t*)candidate;
+    int len = batch->len;
+    int j = 0;
+
+    if (batch->salted) {
+        md5_block_batch_set_salted(batch, lane, p);
+        return;
+    }
+
+    for (; j * 4 + 4 <= len; j++, p += 4) {
+        batch->words[j][lane] = ((uint32_t)p[0]) | (((uint32_t)p[1]) << 8) |
+                                (((uint32_t)p[2]) << 16) | (((uint32_t)p[3]) << 24);
+    }
+
+    // Última palavra: bytes restantes do candidato + o 0x80 do padding
+    uint32_t last = 0x80u << (8 * (len % 4));
+    for (int i = 0; i < len % 4; i++) {
+        last |= ((uint32_t)p[i]) << (8 * i);
+    }
+    batch->words[j][lane] = last;
+}
+
+void md5_block_batch_get(const md5_block_batch_t *batch, int lane, char *output) {
+    for (int i = 0; i < batch->len; i++) {
+        int pos = batch->offset + i;
+        output[i] = (char)(batch->words[pos / 4][lane] >> (8 * (pos % 4)));
+    }
+    output[batch->len] = '\0';
+}
+
+void md5_block_batch_digests(const md5_block_batch_t *batch, uint32_t words[4][MD5_BATCH_MAX]) {
+    const md5_kernel_t *kernel = md5_kernel_active();
+
+    // Lanes de um grupo parcial (além de count) também são gravadas, dentro do lote
+    for (int start = 0; start < batch->count; start += kernel->lanes) {
+        kernel->fn(&batch->words[0][start], MD5_BATCH_MAX, &words[0][start], MD5_BATCH_MAX);
+    }
+}
+
+int md5_block_batch_find(const md5_block_batch_t *batch, const md5_target_t *target) {
+    const md5_kernel_t *kernel = md5_kernel_active();
+    const uint32_t *expect;
+    uint32_t plain[4];
+    int last_step;
+
+    md5_target_expect(target, batch->len, plain, &expect, &last_step);
+
+    md5_match_fn match = batch->salted ? kernel->match : md5_kernel_match(kernel, batch->len);
+    for (int start = 0; start < batch->count; start += kernel->lanes) {
+        uint32_t mask = match(&batch->words[0][start], MD5_BATCH_MAX, batch->salted ? batch->iv : NULL,
+                              expect, last_step, NULL);
+
+        // Lanes além de count guardam candidatos antigos: descartar
+        if (batch->count - start < 32) {
+            mask &= (1u << (batch->count - start)) - 1;
+        }
+        if (mask != 0) {
+            return start + __builtin_ctz(mask);
+        }
+    }
+    return -1;
+}
+
+int md5_block_batch_find_set(const md5_block_batch_t *batch, const md5_target_set_t *set,
+                             md5_hit_t *hits) {
+    const md5_kernel_t *kernel = md5_kernel_active();
+    uint32_t state[4 * MD5_MAX_LANES];
+    int lanes = kernel->lanes;
+    int found = 0;
+    md5_match_fn match = batch->salted ? kernel->match : md5_kernel_match(kernel, batch->len);
+
+    for (int start = 0; start < batch->count; start += lanes) {
+        match(&batch->words[0][start], MD5_BATCH_MAX, batch->salted ? batch->iv : NULL,
+              NULL, set->last_step, state);
+
+        int valid = batch->count - start < lanes ? batch->count - start : lanes;
+        for (int l = 0; l < valid; l++) {
+            int t = md5_target_set_lookup(set, state[l], state[lanes + l],
+                                          state[2 * lanes + l], state[3 * lanes + l]);
+            if (t >= 0) {
+                hits[found].index = start + l;
+                hits[found].target = t;
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+void md5_incremental_init(md5_incremental_t *inc, int len) {
+    memset(inc, 0, sizeof(*inc));
+    inc->len = len;
+    inc->var_word = (len - 1) / 4;
+    inc->var_shift = 8 * ((len - 1) % 4);
+    inc->words[len / 4] = 0x80u << (8 * (len % 4));
+    inc->words[14] = (uint32_t)len << 3;
+    inc->iv[0] = MD5_INIT_A;
+    inc->iv[1] = MD5_INIT_B;
+    inc->iv[2] = MD5_INIT_C;
+    inc->iv[3] = MD5_INIT_D;
+}
+
+void md5_incremental_init_salted(md5_incremental_t *inc, const md5_salted_t *salted) {
+    int last = salted->offset + salted->len - 1;
+
+    memset(inc, 0, sizeof(*inc));
+    inc->len = salted->len;
+    inc->offset = salted->offset;
+    inc->salted = 1;
+    inc->var_word = last / 4;
+    inc->var_shift = 8 * (last % 4);
+    memcpy(inc->words, salted->words, sizeof(inc->words));
+    memcpy(inc->iv, salted->iv, sizeof(inc->iv));
+}
+
+void md5_incremental_set_prefix(md5_incremental_t *inc, const char *candidate) {
+    const uint8_t *p = (const uint8_t*)candidate;
+    uint32_t *st = inc->state;
+
+    // Bytes do prefixo; a posição do último caractere fica zerada
+    for (int i = inc->offset; i < inc->offset + inc->len - 1; i++) {
+        uint32_t mask = 0xffu << (8 * (i % 4));
+        inc->words[i / 4] = (inc->words[i / 4] & ~mask) | (((uint32_t)*p++) << (8 * (i % 4)));
+    }
+    inc->words[inc->var_word] &= ~(0xffu << inc->var_shift);
+
+    // Passos da rodada 1 anteriores a var_word só usam palavras do prefixo (e do sal)
+    memcpy(st, inc->iv, sizeof(inc->iv));
+    for (int n = 0; n < inc->var_word; n++) {
+        int r = md5_step_info[n].reg;
+        uint32_t v = st[r] + F(st[(r + 1) & 3], st[(r + 2) & 3], st[(r + 3) & 3]) +
+                     inc->words[md5_step_info[n].k] + md5_step_info[n].ac;
+        st[r] = st[(r + 1) & 3] + ROTATE_LEFT(v, md5_step_info[n].s);
+    }
+}
+
+int md5_incremental_find(const md5_incremental_t *inc, const char *last_chars, int count,
+                         const md5_target_t *target) {
+    const md5_kernel_t *kernel = md5_kernel_active();
+    const uint32_t *expect;
+    uint32_t plain[4];
+    uint32_t var_values[MD5_MAX_LANES];
+    int last_step;
+
+    md5_target_expect(target, inc->len, plain, &expect, &last_step);
+
+    md5_resume_fn resume = inc->salted ? kernel->resume : md5_kernel_resume(kernel, inc->len);
+    for (int start = 0; start < count; start += kernel->lanes) {
+        int lanes = count - start < kernel->lanes ? count - start : kernel->lanes;
+
+        for (int l = 0; l < kernel->lanes; l++) {
+            // Lanes excedentes repetem o último candidato válido
+            uint8_t ch = (uint8_t)last_chars[start + (l < lanes ? l : lanes - 1)];
+            var_values[l] = inc->words[inc->var_word] | ((uint32_t)ch << inc->var_shift);
+        }
+
+        uint32_t mask = resume(inc->words, inc->state, inc->var_word, inc->var_word,
+                               var_values, expect, last_step, NULL);
+        if (mask != 0) {
+            return start + __builtin_ctz(mask);
+        }
+    }
+    return -1;
+}
+
+int md5_incremental_find_set(const md5_incremental_t *inc, const char *last_chars, int count,
+                             const md5_target_set_t *set, md5_hit_t *hits) {
+    const md5_kernel_t *kernel = md5_kernel_active();
+    uint32_t state[4 * MD5_MAX_LANES];
+    uint32_t var_values[MD5_MAX_LANES];
+    int lanes = kernel->lanes;
+    int found = 0;
+    md5_resume_fn resume = inc->salted ? kernel->resume : md5_kernel_resume(kernel, inc->len);
+
+    for (int start = 0; start < count; start += lanes) {
+        int valid = count - start < lanes ? count - start : lanes;
+
+        for (int l = 0; l < lanes; l++) {
+            uint8_t ch = (uint8_t)last_chars[start + (l < valid ? l : valid - 1)];
+            var_values[l] = inc->words[inc->var_word] | ((uint32_t)ch << inc->var_shift);
+        }
+
+        resume(inc->words, inc->state, inc->var_word, inc->var_word,
+               var_values, NULL, set->last_step, state);
+
+        for (int l = 0; l < valid; l++) {
+            int t = md5_target_set_lookup(set, state[l], state[lanes + l],
+                                          state[2 * lanes + l], state[3 * lanes + l]);
+            if (t >= 0) {
+                hits[found].index = start + l;
+                hits[found].target = t;
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+void md5_digest_to_hex(const uint8_t digest[MD5_DIGEST_LENGTH], char output[33]) {
+    static const char hex[] = "0123456789abcdef";
+
+    for (int i = 0; i < MD5_DIGEST_LENGTH; i++) {
+        output[i * 2] = hex[digest[i] >> 4];
+        output[i * 2 + 1] = hex[digest[i] & 0x0f];
+    }
+    output[32] = '\0';
+}
+
 /**
  * Função pública para calcular MD5 de uma string
  */
 void md5_string(const char *input, char output[33]) {
-    MD5_CTX ctx;
     uint8_t digest[MD5_DIGEST_LENGTH];
-    int i;
     
     // Verificação de segurança
     if (input == NULL || output == NULL) {
@@ -231,14 +729,7 @@ void md5_string(const char *input, char output[33]) {
         return;
     }
     
-    // Calcula o hash MD5
-    MD5Init(&ctx);
-    MD5Update(&ctx, (const uint8_t*)input, strlen(input));
-    MD5Final(digest, &ctx);
-    
-    // Converte para string hexadecimal
-    for (i = 0; i < MD5_DIGEST_LENGTH; i++) {
-        sprintf(output + (i * 2), "%02x", digest[i]);
-    }
-    output[32] = '\0';
-}
\ No newline at end of file
+    // Calcula o hash MD5 e converte para string hexadecimal
+    md5_bytes((const uint8_t*)input, strlen(input), digest);
+    md5_digest_to_hex(digest, output);
+}
@@ -7,6 +7,105 @@
 #include <stdint.h>
 
 #define MD5_DIGEST_LENGTH 16
+#define HASH_DIGEST_MAX 32       // Maior digest dos algoritmos de hash_algo.h (SHA-256)
+#define MD5_MAX_LANES 16         // Maior largura SIMD suportada (AVX-512: 16 x 32 bits)
+#define MD5_SINGLE_BLOCK_MAX 55  // Maior entrada que cabe num único bloco de 64 bytes
+#define MD5_BATCH_MAX 64         // Candidatos por lote de blocos (múltiplo de MD5_MAX_LANES)
+#define MD5_SPECIALIZED_MAX 16   // Maior comprimento com código especializado
+#define MD5_SALT_MAX 128         // Maior sal por alvo (--hash-spec com sal)
+
+/* Comprimentos com kernels e geradores especializados em tempo de compilação */
+#define MD5_SPECIALIZED_LENS(X) \
+    X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) \
+    X(9) X(10) X(11) X(12) X(13) X(14) X(15) X(16)
+
+/**
+ * Hash alvo já decodificado para binário (feito uma única vez por job); os
+ * outros algoritmos (hash_algo.h) usam o mesmo tipo, com digests maiores
+ */
+typedef struct {
+    uint8_t digest[HASH_DIGEST_MAX];    // MD5: os 16 primeiros bytes (o resto zerado)
+    uint32_t words[8];      // Mesmo digest como as palavras do estado final (MD5: 4)
+    int salt_len;           // Bytes do sal (0 = sem sal)
+    uint8_t salt[MD5_SALT_MAX];
+    int reversed_len;       // Comprimento para o qual reversed vale (0 = nenhum)
+    int reversed_steps;     // Passos finais do MD5 desfeitos (0..15)
+    uint32_t reversed[4];   // Estado (a, b, c, d) esperado após o passo 63 - reversed_steps
+} md5_target_t;
+
+/**
+ * Formatos de hash (--hash-spec): onde o sal de cada alvo entra na mensagem
+ */
+typedef enum {
+    MD5_SPEC_PLAIN = 0,     // md5(pass)
+    MD5_SPEC_SALT_PASS,     // md5(salt.pass)
+    MD5_SPEC_PASS_SALT      // md5(pass.salt)
+} md5_spec_t;
+
+/**
+ * Bloco final de md5(salt.pass) ou md5(pass.salt) para candidatos de
+ * comprimento len, montado uma vez por sal:
+ * - Com o sal antes da senha, os blocos de 64 bytes inteiros do sal são
+ *   comprimidos aqui (iv é o estado depois deles, em vez do IV do MD5)
+ * - O resto do sal fica em posição fixa no bloco (antes ou depois do
+ *   candidato), com o padding e o comprimento total da mensagem; os kernels
+ *   só reescrevem os bytes do candidato, como sem sal
+ */
+typedef struct {
+    int len;                // Comprimento dos candidatos
+    int offset;             // Posição (em bytes) do primeiro caractere do candidato
+    int blocks;             // Blocos do sal comprimidos em iv (0 = iv é o IV do MD5)
+    uint32_t words[16];     // Bloco final com os bytes do candidato zerados
+    uint32_t iv[4];         // Estado antes do bloco final
+} md5_salted_t;
+
+/**
+ * Lote de candidatos de mesmo comprimento (<= MD5_SINGLE_BLOCK_MAX), cada um
+ * já montado como bloco MD5 único, no layout transposto dos kernels SIMD:
+ * words[j][l] é a palavra j do bloco do candidato l.
+ * 
+ * O padding (0x80) e a palavra de comprimento são gravados uma vez em
+ * md5_block_batch_init; depois só os bytes do candidato são reescritos.
+ */
+typedef struct {
+    int len;                // Comprimento comum dos candidatos
+    int count;              // Candidatos válidos no lote (0..MD5_BATCH_MAX)
+    int offset;             // Posição do candidato no bloco (sal antes da senha)
+    int salted;             // Bloco com sal (md5_block_batch_init_salted): usa tmpl
+    uint32_t tmpl[16];      // Bloco com sal e os bytes do candidato zerados
+    uint32_t iv[4];         // Estado antes do bloco (IV do MD5 ou o dos blocos do sal)
+    uint32_t words[16][MD5_BATCH_MAX];
+} md5_block_batch_t;
+
+/**
+ * Conjunto de alvos (modo multi-alvo), preparado para candidatos de um único
+ * comprimento. Cada alvo é revertido como em md5_target_reverse, e testar
+ * um candidato custa o mesmo com 1 ou 100 mil alvos:
+ * - bitmap indexado pelos bits baixos da palavra A do estado (pré-filtro:
+ *   quase todo candidato para aqui, com um único acesso à memória)
+ * - tabela de endereçamento aberto (sondagem linear) com chave na palavra A,
+ *   seguida da comparação das 4 palavras
+ */
+typedef struct {
+    int len;                // Comprimento dos candidatos
+    int count;              // Número de alvos (distintos)
+    int last_step;          // Passo em que o estado é comparado (63 - passos revertidos)
+    uint32_t (*expect)[4];  // Estado esperado de cada alvo nesse passo
+    uint64_t *bitmap;
+    uint32_t bitmap_mask;   // Número de bits do bitmap - 1
+    uint32_t *table;        // Índice do alvo + 1 (0 = posição vazia)
+    uint32_t table_mask;    // Número de posições da tabela - 1
+    int table_shift;        // 32 - log2(número de posições)
+    uint32_t (*tail)[4];    // Palavras 4..7 esperadas (SHA-1/SHA-256, hash_algo.h) ou NULL
+} md5_target_set_t;
+
+/**
+ * Um candidato que bateu com um alvo do conjunto
+ */
+typedef struct {
+    int index;              // Posição do candidato (lane do lote / último caractere)
+    int target;             // Índice do alvo no conjunto
+} md5_hit_t;
 
 /**
  * Computa o hash MD5 de uma string de entrada
@@ -21,4 +120,278 @@
  */
 void md5_string(const char *input, char output[33]);
 
+/**
+ * Calcula o MD5 de várias entradas de uma vez (multi-buffer)
+ * 
+ * Entradas de até MD5_SINGLE_BLOCK_MAX bytes são agrupadas e processadas
+ * em paralelo pelo kernel SIMD ativo (SSE2: 4, AVX2: 8, AVX-512: 16 por vez);
+ * entradas maiores caem no caminho escalar. A ordem da saída segue a entrada.
+ * 
+ * @param inputs Ponteiros para as entradas (não precisam terminar em '\0')
+ * @param lengths Tamanho em bytes de cada entrada
+ * @param count Número de entradas
+ * @param digests Saída: digest binário de 16 bytes por entrada
+ * 
+ * Exemplo de uso:
+ *   const char *senhas[] = {"abc", "abd"};
+ *   size_t tamanhos[] = {3, 3};
+ *   uint8_t digests[2][MD5_DIGEST_LENGTH];
+ *   md5_batch(senhas, tamanhos, 2, digests);
+ */
+void md5_batch(const char *const inputs[], const size_t lengths[], int count,
+               uint8_t digests[][MD5_DIGEST_LENGTH]);
+
+/**
+ * Converte um digest binário para a string hexadecimal (32 caracteres + '\0')
+ */
+void md5_digest_to_hex(const uint8_t digest[MD5_DIGEST_LENGTH], char output[33]);
+
+/**
+ * Contexto do modo incremental: candidatos que só diferem no último caractere
+ * 
+ * As palavras da mensagem do prefixo (len - 1 primeiros caracteres) ficam
+ * em cache, assim como o estado após os passos da rodada 1 que vêm antes da
+ * palavra que contém o último caractere - esses passos não dependem dele.
+ * Cada candidato só reexecuta do passo var_word em diante.
+ */
+typedef struct {
+    int len;                // Comprimento dos candidatos (<= MD5_SINGLE_BLOCK_MAX)
+    int offset;             // Posição do candidato no bloco (sal antes da senha)
+    int salted;             // Bloco com sal: kernels genéricos (layout diferente do de len)
+    int var_word;           // Palavra da mensagem que contém o último caractere
+    int var_shift;          // Posição (em bits) do último caractere nessa palavra
+    uint32_t words[16];     // Bloco com padding/comprimento e o último caractere zerado
+    uint32_t iv[4];         // Estado antes do bloco (IV do MD5 ou o dos blocos do sal)
+    uint32_t state[4];      // Estado após os passos 0..var_word-1
+} md5_incremental_t;
+
+/**
+ * Decodifica um hash hexadecimal (32 caracteres) para o formato binário
+ * 
+ * @return 0 em caso de sucesso, -1 se a string não for um MD5 hexadecimal válido
+ */
+int md5_target_parse(const char *hex, md5_target_t *target);
+
+/**
+ * Decodifica um alvo com sal no formato "hash:sal" (o sal é o resto da
+ * linha, de 0 a MD5_SALT_MAX bytes)
+ *
+ * @return 0 em caso de sucesso, -1 se o hash ou o sal forem inválidos
+ */
+int md5_target_parse_salted(const char *text, md5_target_t *target);
+
+/**
+ * Prepara o alvo a partir do digest binário (16 bytes), sem sal
+ */
+void md5_target_from_digest(const uint8_t digest[MD5_DIGEST_LENGTH], md5_target_t *target);
+
+/**
+ * Converte o nome de um formato ("md5", "md5(salt.pass)", "md5(pass.salt)")
+ *
+ * @return md5_spec_t, ou -1 se o nome não for conhecido
+ */
+int md5_spec_parse(const char *name);
+
+/**
+ * Nome do formato (o aceito por md5_spec_parse)
+ */
+const char *md5_spec_name(int spec);
+
+/**
+ * Maior comprimento de candidato cujo bloco final cabe com um sal de
+ * salt_len bytes (o resto do sal depois dos blocos inteiros, no md5(salt.pass))
+ */
+int md5_spec_max_len(int spec, int salt_len);
+
+/**
+ * Hash hexadecimal da senha no formato spec, com o sal do alvo (conferência
+ * do resultado, como md5_string)
+ */
+void md5_spec_string(int spec, const md5_target_t *target, const char *password, char output[33]);
+
+/**
+ * Monta o bloco final do formato spec com o sal dado, para candidatos de
+ * comprimento len
+ *
+ * @return 0 em caso de sucesso, -1 se o candidato não cabe no bloco final
+ *         (len > md5_spec_max_len)
+ */
+int md5_salted_init(md5_salted_t *salted, int spec, const uint8_t *salt, int salt_len, int len);
+
+/**
+ * Desfaz os últimos passos do MD5 a partir do alvo ("alvo revertido")
+ * 
+ * Para candidatos de comprimento fixo, as palavras da mensagem que não
+ * contêm bytes do candidato (zeros, padding e comprimento) são constantes.
+ * Os passos finais da rodada 4 que só usam essas palavras podem ser
+ * invertidos uma vez por job, e md5_block_batch_find passa a comparar o
+ * estado no meio da rodada 4, pulando esses passos para cada candidato
+ * (até 15 passos para len <= 4, 8 para len <= 8).
+ * 
+ * @param target Alvo já decodificado por md5_target_parse
+ * @param len Comprimento dos candidatos (1..MD5_SINGLE_BLOCK_MAX)
+ */
+void md5_target_reverse(md5_target_t *target, int len);
+
+/**
+ * Como md5_target_reverse, para o bloco final com sal de md5_salted_init: as
+ * palavras só com sal também são constantes, e o ponto de comparação é
+ * sempre o revertido (mesmo sem passos desfeitos, o estado inicial é o iv)
+ */
+void md5_target_reverse_salted(md5_target_t *target, const md5_salted_t *salted);
+
+/**
+ * Prepara um lote de blocos para candidatos de comprimento len
+ * (padding e comprimento ficam fixos para todos os candidatos do lote)
+ */
+void md5_block_batch_init(md5_block_batch_t *batch, int len);
+
+/**
+ * Prepara um lote sobre o bloco final com sal; os lotes com sal usam os
+ * kernels genéricos, a partir de salted->iv
+ */
+void md5_block_batch_init_salted(md5_block_batch_t *batch, const md5_salted_t *salted);
+
+/**
+ * Grava um candidato (batch->len bytes) na posição lane do lote
+ */
+void md5_block_batch_set(md5_block_batch_t *batch, int lane, const char *candidate);
+
+/**
+ * Recupera o candidato da posição lane (saída com batch->len + 1 bytes)
+ */
+void md5_block_batch_get(const md5_block_batch_t *batch, int lane, char *output);
+
+/**
+ * Calcula o digest de todos os batch->count candidatos do lote, como as 4
+ * palavras do estado final (words[w][l] = palavra w do digest do candidato l,
+ * na ordem de md5_target_t.words)
+ */
+void md5_block_batch_digests(const md5_block_batch_t *batch, uint32_t words[4][MD5_BATCH_MAX]);
+
+/**
+ * Procura o alvo entre os batch->count candidatos do lote
+ * 
+ * Cada kernel compara primeiro só a palavra A do estado; as demais
+ * palavras são conferidas apenas nas lanes em que A bateu, e nenhum
+ * digest é convertido para hexadecimal.
+ * 
+ * @return Índice do primeiro candidato cujo MD5 é o alvo, ou -1
+ */
+int md5_block_batch_find(const md5_block_batch_t *batch, const md5_target_t *target);
+
+/**
+ * Monta o conjunto de alvos para candidatos de comprimento len
+ * 
+ * @param targets Alvos decodificados (sem repetições)
+ * @param count Número de alvos (>= 1)
+ * @return 0 em caso de sucesso, -1 se faltar memória
+ */
+int md5_target_set_init(md5_target_set_t *set, const md5_target_t *targets, int count, int len);
+
+/**
+ * Como md5_target_set_init, para alvos com o mesmo sal (o do bloco salted)
+ */
+int md5_target_set_init_salted(md5_target_set_t *set, const md5_target_t *targets, int count,
+                               const md5_salted_t *salted);
+
+/**
+ * Libera a memória do conjunto de alvos
+ */
+void md5_target_set_free(md5_target_set_t *set);
+
+/**
+ * Procura todos os alvos do conjunto entre os batch->count candidatos do lote
+ * (set->len deve ser batch->len)
+ * 
+ * @param hits Saída: até MD5_BATCH_MAX acertos (um por candidato)
+ * @return Número de acertos gravados em hits
+ */
+int md5_block_batch_find_set(const md5_block_batch_t *batch, const md5_target_set_t *set,
+                             md5_hit_t *hits);
+
+/**
+ * Prepara o contexto incremental para candidatos de comprimento len
+ */
+void md5_incremental_init(md5_incremental_t *inc, int len);
+
+/**
+ * Prepara o contexto incremental sobre o bloco final com sal: os passos
+ * anteriores à palavra do último caractere (inclusive os do sal) são
+ * calculados uma vez por prefixo, a partir de salted->iv
+ */
+void md5_incremental_init_salted(md5_incremental_t *inc, const md5_salted_t *salted);
+
+/**
+ * Fixa o prefixo (os len - 1 primeiros caracteres de candidate) e
+ * recalcula o estado em cache; o último caractere de candidate é ignorado
+ */
+void md5_incremental_set_prefix(md5_incremental_t *inc, const char *candidate);
+
+/**
+ * Testa prefixo + last_chars[i] para i em 0..count-1, direto sobre o bloco
+ * em cache (sem montar strings), usando o kernel SIMD ativo
+ * 
+ * @return Índice i do primeiro último-caractere cujo MD5 é o alvo, ou -1
+ */
+int md5_incremental_find(const md5_incremental_t *inc, const char *last_chars, int count,
+                         const md5_target_t *target);
+
+/**
+ * Como md5_incremental_find, mas contra todos os alvos do conjunto
+ * 
+ * @param count Número de últimos caracteres (<= MD5_BATCH_MAX)
+ * @param hits Saída: até count acertos (index = i do último caractere)
+ * @return Número de acertos gravados em hits
+ */
+int md5_incremental_find_set(const md5_incremental_t *inc, const char *last_chars, int count,
+                             const md5_target_set_t *set, md5_hit_t *hits);
+
+/**
+ * Nome do kernel usado por md5_batch ("scalar", "sse2", "avx2" ou "avx512")
+ * 
+ * Na primeira chamada (de qualquer thread; a escolha é feita uma única vez,
+ * com pthread_once) o kernel mais largo suportado pela CPU é escolhido via
+ * CPUID. A variável de ambiente MD5_KERNEL força um kernel específico.
+ */
+const char *md5_kernel_name(void);
+
+/**
+ * Número de candidatos processados em paralelo pelo kernel ativo
+ */
+int md5_kernel_lanes(void);
+
+/**
+ * Força o uso de um kernel pelo nome (antes de criar threads de busca)
+ * 
+ * @return 0 se o kernel existe e é suportado por esta CPU, -1 caso contrário
+ */
+int md5_select_kernel(const char *name);
+
+/**
+ * Liga (padrão) ou desliga os kernels e geradores especializados por
+ * comprimento (1..MD5_SPECIALIZED_MAX) e tamanho de charset
+ *
+ * Com eles, o comprimento é constante em tempo de compilação: as palavras
+ * de padding e de comprimento viram constantes dobradas nos passos do MD5, e
+ * o odômetro de candidate_gen.h é desenrolado. Os outros casos (e tudo, com
+ * a variável de ambiente MD5_SPECIALIZED=0) usam o caminho genérico; o
+ * resultado é o mesmo, só muda a velocidade (comparação em ./benchmark).
+ */
+void md5_select_specialized(int enabled);
+
+/**
+ * Indica se os candidatos de comprimento len usam o caminho especializado
+ */
+int md5_kernel_specialized(int len);
+
+/**
+ * Candidatos (lanes) da thread atual que passaram do pré-filtro: a palavra
+ * A do alvo (busca com alvo único) ou o bitmap do conjunto (md5_target_set_t)
+ * 
+ * Só é incrementado depois que o pré-filtro bate, fora do caminho comum de
+ * rejeição; a instrumentação (instrument.h) lê a diferença por worker.
+ */
+extern _Thread_local unsigned long long md5_prefilter_passes;
+
 #endif // HASH_UTILS_H
\ No newline at end of file
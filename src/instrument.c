@@ -0,0 +1,234 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "instrument.h"
+#include "hash_utils.h"
+#include "progress.h"
+
+/**
+ * Nome do fragmento de um worker (ou do coordinator) para o trace em path
+ */
+static void instr_part_path(char *out, size_t size, const char *path, int worker_id) {
+    if (worker_id == INSTR_COORDINATOR) {
+        snprintf(out, size, "%s.coordinator.part", path);
+    } else {
+        snprintf(out, size, "%s.%d.part", path, worker_id);
+    }
+}
+
+/**
+ * Abre um contador de hardware da thread atual, em modo usuário
+ *
+ * @return Descritor, ou -1 (errno do perf_event_open)
+ */
+static int perf_open(unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // pid = 0, cpu = -1: só esta thread, em qualquer CPU
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static long long perf_read(int fd) {
+    long long value;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return -1;
+    }
+    return value;
+}
+
+int instr_perf_available(void) {
+    int fd = perf_open(PERF_COUNT_HW_INSTRUCTIONS);
+    if (fd < 0) {
+        return -1;
+    }
+    close(fd);
+    return 0;
+}
+
+void instr_begin(instr_t *in, instr_worker_t *slot, const char *trace_path, int worker_id,
+                 int perf, double origin) {
+    memset(in, 0, sizeof(*in));
+    in->pid = getpid();
+    in->tid = (int)syscall(SYS_gettid);
+    in->origin = origin;
+    in->last = origin;
+    in->slot = slot;
+    in->perf_fd[0] = perf ? perf_open(PERF_COUNT_HW_CPU_CYCLES) : -1;
+    in->perf_fd[1] = perf ? perf_open(PERF_COUNT_HW_INSTRUCTIONS) : -1;
+    in->prefilter_start = md5_prefilter_passes;
+
+    if (trace_path == NULL) {
+        return;
+    }
+    char part[PATH_MAX];
+    instr_part_path(part, sizeof(part), trace_path, worker_id);
+    in->trace = fopen(part, "w");
+    if (in->trace == NULL) {
+        perror(part);
+        return;
+    }
+
+    // Metadados: nome da linha no visualizador (e do processo, se o worker é um processo)
+    char name[32];
+    if (worker_id == INSTR_COORDINATOR) {
+        snprintf(name, sizeof(name), "Coordinator");
+    } else {
+        snprintf(name, sizeof(name), "Worker %d", worker_id);
+    }
+    if (in->pid == in->tid) {
+        fprintf(in->trace, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, "
+                "\"args\": {\"name\": \"%s\"}},\n", in->pid, name);
+    }
+    fprintf(in->trace, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, "
+            "\"args\": {\"name\": \"%s\"}},\n", in->pid, in->tid, name);
+}
+
+void instr_event(instr_t *in, const char *name, double start, double end, const char *args) {
+    if (in->trace == NULL) {
+        return;
+    }
+    // Eventos "X" (completos): início e duração em microssegundos
+    fprintf(in->trace, "{\"name\": \"%s\", \"cat\": \"search\", \"ph\": \"X\", \"ts\": %.3f, "
+            "\"dur\": %.3f, \"pid\": %d, \"tid\": %d", name, start * 1e6, (end - start) * 1e6,
+            in->pid, in->tid);
+    if (args != NULL) {
+        fprintf(in->trace, ", \"args\": %s", args);
+    }
+    fprintf(in->trace, "},\n");
+}
+
+void instr_chunk(instr_t *in, double start, double end, long long first, long long count,
+                 long long checked) {
+    if (in->chunks++ == 0) {
+        if (in->slot != NULL) {
+            in->slot->setup = start - in->origin;
+        }
+        instr_event(in, "inicialização", in->origin, start, NULL);
+    } else if (in->slot != NULL) {
+        in->slot->idle += start - in->last;
+    }
+    in->last = end;
+
+    if (in->trace != NULL) {
+        char args[96];
+        snprintf(args, sizeof(args), "{\"first\": %lld, \"count\": %lld, \"checked\": %lld}",
+                 first, count, checked);
+        instr_event(in, "chunk", start, end, args);
+    }
+}
+
+void instr_end(instr_t *in, long long batches) {
+    double now = progress_now();
+
+    if (in->slot != NULL) {
+        instr_worker_t *slot = in->slot;
+        if (in->chunks == 0) {
+            slot->setup = now - in->origin;
+        } else {
+            slot->idle += now - in->last;
+        }
+        slot->batches = batches;
+        slot->prefilter = (long long)(md5_prefilter_passes - in->prefilter_start);
+        slot->cycles = perf_read(in->perf_fd[0]);
+        slot->instructions = perf_read(in->perf_fd[1]);
+        slot->active = 1;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (in->perf_fd[i] >= 0) {
+            close(in->perf_fd[i]);
+        }
+    }
+    if (in->trace != NULL) {
+        fclose(in->trace);
+        in->trace = NULL;
+    }
+}
+
+int instr_trace_merge(const char *trace_path, int num_workers) {
+    FILE *out = fopen(trace_path, "w");
+    if (out == NULL) {
+        return -1;
+    }
+
+    // Cada linha dos fragmentos é um evento terminado em ","
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    int events = 0;
+    for (int id = INSTR_COORDINATOR; id < num_workers; id++) {
+        char part[PATH_MAX], line[1024];
+        instr_part_path(part, sizeof(part), trace_path, id);
+        FILE *in = fopen(part, "r");
+        if (in == NULL) {
+            continue;
+        }
+        while (fgets(line, sizeof(line), in) != NULL) {
+            fputs(line, out);
+            events++;
+        }
+        fclose(in);
+        unlink(part);
+    }
+    // Último evento (sem vírgula): o coordinator no topo do visualizador
+    fprintf(out, "{\"name\": \"process_sort_index\", \"ph\": \"M\", \"pid\": %d, "
+            "\"args\": {\"sort_index\": -1}}\n]}\n", getpid());
+    if (fclose(out) != 0) {
+        return -1;
+    }
+    return events;
+}
+
+void instr_report(const instr_worker_t *workers, const scheduler_t *sched, int level) {
+    int num_workers = sched->num_workers < SCHED_MAX_WORKERS ? sched->num_workers : SCHED_MAX_WORKERS;
+    long long batches = 0, prefilter = 0, cycles = 0, instructions = 0, perf_checked = 0;
+    double setup = 0, idle = 0;
+    int reported = 0, perf = 0;
+
+    for (int i = 0; i < num_workers; i++) {
+        const instr_worker_t *w = &workers[i];
+        long long checked = sched->workers[i].checked;
+        if (!w->active) {
+            continue;
+        }
+        reported++;
+        batches += w->batches;
+        prefilter += w->prefilter;
+        setup += w->setup;
+        idle += w->idle;
+
+        LOG(LOG_VERBOSE, "Worker %d: %lld lotes, %lld passaram do pré-filtro, "
+            "inicialização %.3f s, ocioso %.3f s", i, w->batches, w->prefilter, w->setup, w->idle);
+        if (w->cycles >= 0 && w->instructions >= 0) {
+            perf++;
+            perf_checked += checked;
+            cycles += w->cycles;
+            instructions += w->instructions;
+            LOG(LOG_VERBOSE, ", %.2f instruções/ciclo, %.1f ciclos/senha",
+                w->cycles > 0 ? (double)w->instructions / w->cycles : 0.0,
+                checked > 0 ? (double)w->cycles / checked : 0.0);
+        }
+        LOG(LOG_VERBOSE, "\n");
+    }
+    if (reported == 0) {
+        return;
+    }
+
+    long long checked = scheduler_checked(sched);
+    LOG(level, "Lotes nos kernels: %lld (%.1f senhas por lote)\n", batches,
+        batches > 0 ? (double)checked / batches : 0.0);
+    LOG(level, "Rejeitadas no pré-filtro: %lld de %lld (passaram: %lld)\n",
+        checked - prefilter > 0 ? checked - prefilter : 0, checked, prefilter);
+    LOG(level, "Inicialização média: %.3f s, tempo ocioso médio: %.3f s por worker\n",
+        setup / reported, idle / reported);
+    if (perf > 0) {
+        LOG(level, "Contadores de hardware: %.2f instruções/ciclo, %.1f ciclos/senha\n",
+            cycles > 0 ? (double)instructions / cycles : 0.0,
+            perf_checked > 0 ? (double)cycles / perf_checked : 0.0);
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdio.h>
+#include "scheduler.h"
+
+/**
+ * Instrumentação dos workers (--trace / --perf) - Mini-Projeto 1
+ *
+ * Cada worker/thread preenche, ao terminar, o seu slot instr_worker_t na
+ * região compartilhada, que o coordinator resume junto com o escalonador
+ * (chunks, senhas e tempo ocupado já ficam em sched_worker_stats_t):
+ * - lotes entregues aos kernels MD5
+ * - candidatos que passaram do pré-filtro (palavra A ou bitmap dos alvos,
+ *   md5_prefilter_passes): todos os outros foram rejeitados cedo
+ * - inicialização (do início do worker ao primeiro chunk) e tempo ocioso
+ *   entre chunks (escalonador, disputa pelo cursor, fim do espaço)
+ * - com --perf, ciclos e instruções em modo usuário (perf_event_open); sem
+ *   permissão (perf_event_paranoid, contêineres) ficam indisponíveis
+ *
+ * Tudo é medido por chunk, com os instantes que o escalonador já toma: o
+ * laço por candidato só soma lotes, e o pré-filtro só conta depois de bater.
+ * Com a instrumentação desligada (sem --trace e sem --perf), sobram algumas
+ * somas por chunk; nenhum arquivo, syscall ou leitura extra do relógio.
+ *
+ * --trace <arquivo> grava eventos no formato Chrome trace (chrome://tracing,
+ * ui.perfetto.dev): cada worker escreve os seus num fragmento
+ * <arquivo>.<id>.part e o coordinator junta tudo (e os próprios eventos:
+ * inicialização, fork, espera) num único JSON no fim. Os instantes vêm do
+ * relógio monotônico (progress_now), o mesmo em todos os processos.
+ */
+
+#define INSTR_COORDINATOR (-1)      // "worker_id" dos eventos do coordinator
+
+/**
+ * Contadores de um worker (escrito uma vez, pelo próprio worker, no fim)
+ */
+typedef struct {
+    _Alignas(64)
+    int active;                 // Slot preenchido
+    long long batches;          // Chamadas aos kernels (lotes ou execuções incrementais)
+    long long prefilter;        // Candidatos que passaram do pré-filtro
+    double setup;               // Do início do worker ao primeiro chunk (s)
+    double idle;                // Entre chunks e depois do último (s)
+    long long cycles;           // Ciclos em modo usuário (-1 = indisponível)
+    long long instructions;     // Instruções em modo usuário (-1 = indisponível)
+} instr_worker_t;
+
+/**
+ * Estado local da instrumentação de um worker/thread
+ */
+typedef struct {
+    FILE *trace;                // Fragmento do trace (NULL = desligado)
+    int pid, tid;
+    int perf_fd[2];             // Ciclos, instruções (-1 = sem contador)
+    double origin;              // Início do worker (main do processo ou criação da thread)
+    double last;                // Fim do último chunk
+    long long chunks;
+    unsigned long long prefilter_start;
+    instr_worker_t *slot;       // Saída (NULL no coordinator)
+} instr_t;
+
+/**
+ * Começa a instrumentação de um worker (ou do coordinator, com
+ * worker_id = INSTR_COORDINATOR e slot = NULL)
+ *
+ * @param trace_path Arquivo do --trace (NULL = sem trace)
+ * @param perf Abrir os contadores de hardware (--perf)
+ * @param origin Instante (progress_now) do início do worker
+ */
+void instr_begin(instr_t *in, instr_worker_t *slot, const char *trace_path, int worker_id,
+                 int perf, double origin);
+
+/**
+ * Registra um chunk concluído (instantes do escalonador)
+ *
+ * @param first Primeiro índice (ou byte, no modo wordlist) do chunk
+ * @param count Tamanho do chunk
+ * @param checked Senhas verificadas no chunk
+ */
+void instr_chunk(instr_t *in, double start, double end, long long first, long long count,
+                 long long checked);
+
+/**
+ * Grava um evento de duração no trace (se ligado)
+ *
+ * @param args Objeto JSON com os argumentos do evento, ou NULL
+ */
+void instr_event(instr_t *in, const char *name, double start, double end, const char *args);
+
+/**
+ * Lê os contadores, preenche o slot e fecha o fragmento do trace
+ *
+ * @param batches Lotes entregues aos kernels pelo worker
+ */
+void instr_end(instr_t *in, long long batches);
+
+/**
+ * Testa se perf_event_open está disponível para este processo
+ *
+ * @return 0 se os contadores podem ser abertos, -1 caso contrário (errno)
+ */
+int instr_perf_available(void);
+
+/**
+ * Junta os fragmentos do coordinator e dos workers 0..num_workers-1 em
+ * trace_path (os fragmentos são removidos)
+ *
+ * @return Número de eventos gravados, ou -1 em caso de erro (errno)
+ */
+int instr_trace_merge(const char *trace_path, int num_workers);
+
+/**
+ * Imprime os contadores por worker (LOG_VERBOSE) e os totais (no nível level)
+ */
+void instr_report(const instr_worker_t *workers, const scheduler_t *sched, int level);
+
+#endif // INSTRUMENT_H
@@ -0,0 +1,270 @@
+#include <limits.h>
+#include "keyspace.h"
+
+// Classes da máscara (mesmos conjuntos do hashcat)
+#define CLASS_LOWER "abcdefghijklmnopqrstuvwxyz"
+#define CLASS_UPPER "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define CLASS_DIGIT "0123456789"
+#define CLASS_SPECIAL " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~"
+
+static const char *mask_class(char c) {
+    switch (c) {
+        case 'l': return CLASS_LOWER;
+        case 'u': return CLASS_UPPER;
+        case 'd': return CLASS_DIGIT;
+        case 's': return CLASS_SPECIAL;
+        case 'a': return CLASS_LOWER CLASS_UPPER CLASS_DIGIT CLASS_SPECIAL;
+        case '?': return "?";
+        default:  return NULL;
+    }
+}
+
+/**
+ * Calcula size/offset/total dos comprimentos min_len..max_len a partir de radix[]
+ */
+static int keyspace_finish(keyspace_t *ks) {
+    keyspace_index_t size = 1;
+
+    ks->total = 0;
+    for (int len = 1; len <= ks->max_len; len++) {
+        int radix = ks->radix[len - 1];
+        if (radix < 1 || size > KEYSPACE_INDEX_MAX / radix) {
+            return -1;
+        }
+        size *= radix;
+
+        if (len >= ks->min_len) {
+            if (ks->total > KEYSPACE_INDEX_MAX - size) {
+                return -1;
+            }
+            ks->size[len] = size;
+            ks->offset[len] = ks->total;
+            ks->total += size;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Expande uma especificação de charset ("?l?d_") no pool, sem repetições
+ *
+ * @param custom Charsets ?1..?4 aceitos na especificação (NULL = nenhum)
+ * @return Início do charset no pool (NULL se inválida ou o pool encheu)
+ */
+static const char *keyspace_expand(keyspace_t *ks, const char *spec, int spec_len,
+                                   const char *const *custom, int *len) {
+    unsigned char seen[256] = {0};
+    char *out = ks->pool + ks->pool_used;
+    int n = 0;
+
+    for (int i = 0; i < spec_len; i++) {
+        const char *chars = &spec[i];
+        int chars_len = 1;
+
+        if (spec[i] == '?') {
+            if (++i >= spec_len) {
+                return NULL;
+            }
+            int k = spec[i] - '1';
+            if (custom != NULL && k >= 0 && k < KEYSPACE_CUSTOM_CHARSETS) {
+                chars = custom[k];
+            } else {
+                chars = mask_class(spec[i]);
+            }
+            if (chars == NULL) {
+                return NULL;
+            }
+            chars_len = strlen(chars);
+        }
+
+        for (int j = 0; j < chars_len; j++) {
+            unsigned char c = chars[j];
+            if (seen[c]) {
+                continue;
+            }
+            if (ks->pool_used + n + 1 >= KEYSPACE_POOL_SIZE) {
+                return NULL;
+            }
+            seen[c] = 1;
+            out[n++] = c;
+        }
+    }
+    out[n] = '\0';
+    ks->pool_used += n + 1;
+    *len = n;
+    return out;
+}
+
+int keyspace_init(keyspace_t *ks, const char *charset, int charset_len, int min_len, int max_len) {
+    if (charset_len < 1 || min_len < 1 || max_len < min_len || max_len > MD5_SINGLE_BLOCK_MAX) {
+        return -1;
+    }
+
+    memset(ks, 0, sizeof(*ks));
+    ks->min_len = min_len;
+    ks->max_len = max_len;
+    ks->positions = max_len;
+    for (int i = 0; i < max_len; i++) {
+        ks->charset[i] = charset;
+        ks->radix[i] = charset_len;
+    }
+    return keyspace_finish(ks);
+}
+
+int keyspace_init_mask(keyspace_t *ks, const char *mask, const char *const custom[KEYSPACE_CUSTOM_CHARSETS],
+                       int min_len, int max_len) {
+    const char *expanded[KEYSPACE_CUSTOM_CHARSETS] = {NULL};
+
+    memset(ks, 0, sizeof(*ks));
+
+    // Charsets personalizados primeiro: podem usar as classes, mas não uns aos outros
+    for (int k = 0; k < KEYSPACE_CUSTOM_CHARSETS; k++) {
+        int len;
+        if (custom != NULL && custom[k] != NULL &&
+            (expanded[k] = keyspace_expand(ks, custom[k], strlen(custom[k]), NULL, &len)) == NULL) {
+            return -1;
+        }
+    }
+
+    // Uma posição por "?x" ou caractere literal
+    for (const char *p = mask; *p != '\0'; p++) {
+        int len = p[0] == '?' ? 2 : 1;
+        if (ks->positions == MD5_SINGLE_BLOCK_MAX ||
+            (ks->charset[ks->positions] = keyspace_expand(ks, p, len, expanded,
+                                                          &ks->radix[ks->positions])) == NULL ||
+            ks->radix[ks->positions] == 0) {
+            return -1;
+        }
+        ks->positions++;
+        p += len - 1;
+    }
+
+    ks->max_len = max_len > 0 ? max_len : ks->positions;
+    ks->min_len = min_len > 0 ? min_len : ks->max_len;
+    if (ks->positions == 0 || ks->min_len > ks->max_len || ks->max_len > ks->positions) {
+        return -1;
+    }
+    return keyspace_finish(ks);
+}
+
+int keyspace_locate(const keyspace_t *ks, keyspace_index_t index, keyspace_index_t *local) {
+    int len = ks->min_len;
+    while (len < ks->max_len && index >= ks->offset[len + 1]) {
+        len++;
+    }
+    *local = index - ks->offset[len];
+    return len;
+}
+
+/**
+ * Candidatos das posições [from, to) com posto <= m em todas (m < 0: nenhum,
+ * se o intervalo não é vazio)
+ */
+static keyspace_index_t keyspace_rank_count(const keyspace_t *ks, int from, int to, int m) {
+    keyspace_index_t n = 1;
+    for (int i = from; i < to; i++) {
+        n *= ks->radix[i] < m + 1 ? ks->radix[i] : (m + 1 > 0 ? m + 1 : 0);
+    }
+    return n;
+}
+
+void keyspace_segment(const keyspace_t *ks, keyspace_index_t index, keyspace_segment_t *seg,
+                      keyspace_index_t *local) {
+    int len = keyspace_locate(ks, index, local);
+
+    seg->len = len;
+    if (!ks->ordered) {
+        for (int i = 0; i < len; i++) {
+            seg->charset[i] = ks->charset[i];
+            seg->radix[i] = ks->radix[i];
+        }
+        seg->size = ks->size[len];
+        return;
+    }
+
+    // Faixa m: candidatos com pior posto <= m menos os com pior posto <= m - 1
+    int max_radix = 0;
+    for (int i = 0; i < len; i++) {
+        max_radix = ks->radix[i] > max_radix ? ks->radix[i] : max_radix;
+    }
+    int m = 0;
+    for (; m < max_radix - 1; m++) {
+        keyspace_index_t band = keyspace_rank_count(ks, 0, len, m) - keyspace_rank_count(ks, 0, len, m - 1);
+        if (*local < band) {
+            break;
+        }
+        *local -= band;
+    }
+
+    // Primeira posição com posto m: antes dela, postos < m; depois, <= m
+    int p = 0;
+    keyspace_index_t size = 0;
+    for (; p < len; p++) {
+        if (ks->radix[p] <= m) {
+            continue;
+        }
+        size = keyspace_rank_count(ks, 0, p, m - 1) * keyspace_rank_count(ks, p + 1, len, m);
+        if (*local < size) {
+            break;
+        }
+        *local -= size;
+    }
+
+    for (int i = 0; i < len; i++) {
+        int limit = i < p ? m : m + 1;
+        seg->charset[i] = i == p ? ks->charset[i] + m : ks->charset[i];
+        seg->radix[i] = i == p ? 1 : ks->radix[i] < limit ? ks->radix[i] : limit;
+    }
+    seg->size = size;
+}
+
+void keyspace_password(const keyspace_t *ks, keyspace_index_t index, char *output) {
+    keyspace_segment_t seg;
+    keyspace_index_t local;
+    keyspace_segment(ks, index, &seg, &local);
+
+    for (int i = seg.len - 1; i >= 0; i--) {
+        output[i] = seg.charset[i][local % seg.radix[i]];
+        local /= seg.radix[i];
+    }
+    output[seg.len] = '\0';
+}
+
+char *keyspace_index_format(keyspace_index_t value, char *buf) {
+    char digits[KEYSPACE_INDEX_DIGITS];
+    int n = 0;
+    int negative = value < 0;
+    unsigned __int128 v = negative ? -(unsigned __int128)value : (unsigned __int128)value;
+
+    do {
+        digits[n++] = (char)('0' + (int)(v % 10));
+        v /= 10;
+    } while (v > 0);
+
+    int pos = 0;
+    if (negative) {
+        buf[pos++] = '-';
+    }
+    while (n > 0) {
+        buf[pos++] = digits[--n];
+    }
+    buf[pos] = '\0';
+    return buf;
+}
+
+int keyspace_index_parse(const char *str, keyspace_index_t *value) {
+    keyspace_index_t v = 0;
+
+    if (*str == '\0') {
+        return -1;
+    }
+    for (; *str != '\0'; str++) {
+        int digit = *str - '0';
+        if (digit < 0 || digit > 9 || v > (KEYSPACE_INDEX_MAX - digit) / 10) {
+            return -1;
+        }
+        v = v * 10 + digit;
+    }
+    *value = v;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#ifndef KEYSPACE_H
+#define KEYSPACE_H
+
+#include "hash_utils.h"
+
+/**
+ * Espaço de busca combinado - Mini-Projeto 1
+ *
+ * Cada posição da senha tem o seu próprio charset (base mista): na força
+ * bruta todas as posições usam o mesmo charset; numa máscara (--mask) cada
+ * posição vem de uma classe (?l ?u ?d ?s ?a), de um charset personalizado
+ * (?1..?4) ou é um caractere literal.
+ *
+ * Todos os comprimentos de min_len a max_len formam um único espaço
+ * numerado: primeiro os candidatos de comprimento min_len (as min_len
+ * primeiras posições), depois os de min_len + 1, e assim por diante. Dentro
+ * de cada comprimento a numeração é a de um odômetro: o índice de cada
+ * posição é um dígito na base radix[pos], o último variando mais rápido.
+ *
+ * Os índices são de 128 bits (keyspace_index_t): 95 caracteres já passam
+ * de 2^63 no comprimento 10, e o total só é recusado acima de 2^127 - 1.
+ * O escalonador (scheduler.h) continua com um cursor atômico de 64 bits,
+ * contado a partir de um índice base (0, ou o watermark de um --resume): uma
+ * execução cobre no máximo KEYSPACE_WINDOW_MAX candidatos (keyspace_window,
+ * décadas a 10^10 senhas/s) e o restante fica para um --resume. Cada worker
+ * converte base + início do chunk em (comprimento, índice local) com
+ * keyspace_locate e continua usando o gerador e os kernels especializados
+ * por comprimento.
+ *
+ * Ordem por probabilidade (markov.h): com o charset de cada posição já
+ * ordenado do mais para o menos provável, cada comprimento é numerado em
+ * faixas m = 0, 1, 2...: a faixa m tem os candidatos cujo pior posto (índice
+ * no charset da posição) é exatamente m, então todos os candidatos que só
+ * usam os m + 1 primeiros caracteres de cada posição vêm antes de qualquer
+ * um que use o seguinte. Dentro da faixa, p é a primeira posição com posto
+ * m: as anteriores têm posto < m e as seguintes <= m. Cada par (m, p) é um
+ * odômetro comum (keyspace_segment_t), e a numeração continua uma
+ * bijeção sobre o mesmo espaço: total, divisão em chunks, checkpoint e
+ * nós não mudam.
+ */
+
+#define KEYSPACE_CUSTOM_CHARSETS 4      // ?1..?4
+#define KEYSPACE_POOL_SIZE 8192         // Charsets expandidos da máscara (e reordenados)
+#define KEYSPACE_INDEX_DIGITS 41        // Decimal de um keyspace_index_t (com sinal) + '\0'
+#define KEYSPACE_WINDOW_MAX (1LL << 62) // Posições do escalonador numa execução
+
+typedef __int128 keyspace_index_t;      // Índice global (com sinal: -1 = inválido)
+#define KEYSPACE_INDEX_MAX ((keyspace_index_t)(~(unsigned __int128)0 >> 1))
+
+typedef struct {
+    int min_len;
+    int max_len;
+    int positions;                                // Posições definidas (>= max_len)
+    const char *charset[MD5_SINGLE_BLOCK_MAX];    // Charset de cada posição
+    int radix[MD5_SINGLE_BLOCK_MAX];              // Tamanho do charset de cada posição
+    keyspace_index_t size[MD5_SINGLE_BLOCK_MAX + 1];     // Candidatos de cada comprimento
+    keyspace_index_t offset[MD5_SINGLE_BLOCK_MAX + 1];   // Índice global do primeiro de cada comprimento
+    keyspace_index_t total;                              // Soma de size[min_len..max_len]
+    int ordered;                                  // Numeração em faixas (markov_apply)
+
+    // Charsets expandidos da máscara (charset[] aponta para cá: não copiar a struct)
+    int pool_used;
+    char pool[KEYSPACE_POOL_SIZE];
+} keyspace_t;
+
+/**
+ * Força bruta: o mesmo charset em todas as posições, comprimentos min_len..max_len
+ *
+ * @return 0 em caso de sucesso, -1 se os parâmetros forem inválidos ou o
+ *         total passar de KEYSPACE_INDEX_MAX
+ */
+int keyspace_init(keyspace_t *ks, const char *charset, int charset_len, int min_len, int max_len);
+
+/**
+ * Máscara: uma posição por classe (?l ?u ?d ?s ?a), charset personalizado
+ * (?1..?4), "??" (o próprio '?') ou caractere literal. Os charsets
+ * personalizados podem conter classes ("?l?d_") e têm as repetições removidas.
+ *
+ * Com min_len/max_len, busca só os prefixos da máscara com esses comprimentos
+ * (0 = a máscara inteira).
+ *
+ * @param custom Charsets ?1..?4 (NULL = não definido)
+ * @return 0 em caso de sucesso, -1 se a máscara ou os comprimentos forem
+ *         inválidos ou o total passar de KEYSPACE_INDEX_MAX
+ */
+int keyspace_init_mask(keyspace_t *ks, const char *mask, const char *const custom[KEYSPACE_CUSTOM_CHARSETS],
+                       int min_len, int max_len);
+
+/**
+ * Converte um índice global no comprimento e no índice dentro dele
+ *
+ * @param index Índice global (0..total - 1)
+ * @param local Saída: índice dentro do comprimento devolvido
+ * @return Comprimento do candidato
+ */
+int keyspace_locate(const keyspace_t *ks, keyspace_index_t index, keyspace_index_t *local);
+
+/**
+ * Trecho contíguo da numeração enumerado por um único odômetro: todos os
+ * candidatos de um comprimento na ordem normal, ou uma faixa/posição (m, p)
+ * na ordem por probabilidade
+ */
+typedef struct {
+    int len;
+    const char *charset[MD5_SINGLE_BLOCK_MAX];    // Charset de cada posição no trecho
+    int radix[MD5_SINGLE_BLOCK_MAX];
+    keyspace_index_t size;                        // Candidatos no trecho
+} keyspace_segment_t;
+
+/**
+ * Converte um índice global no trecho que o contém
+ *
+ * @param local Saída: índice dentro do trecho (mesma decomposição de
+ *              candidate_gen_init sobre seg->charset/seg->radix)
+ */
+void keyspace_segment(const keyspace_t *ks, keyspace_index_t index, keyspace_segment_t *seg,
+                      keyspace_index_t *local);
+
+/**
+ * Converte um índice global na senha correspondente
+ *
+ * @param output Buffer com pelo menos max_len + 1 bytes
+ */
+void keyspace_password(const keyspace_t *ks, keyspace_index_t index, char *output);
+
+/**
+ * Escreve um índice em decimal
+ *
+ * @param buf Buffer com KEYSPACE_INDEX_DIGITS bytes
+ * @return buf (para usar direto num printf com %s)
+ */
+char *keyspace_index_format(keyspace_index_t value, char *buf);
+
+/**
+ * Lê um índice decimal não negativo (a string inteira)
+ *
+ * @return 0 em caso de sucesso, -1 se não é um número ou passa de KEYSPACE_INDEX_MAX
+ */
+int keyspace_index_parse(const char *str, keyspace_index_t *value);
+
+/**
+ * Posições do escalonador de uma execução que começa em base: o que falta
+ * do espaço, limitado a KEYSPACE_WINDOW_MAX
+ */
+static inline long long keyspace_window(keyspace_index_t total, keyspace_index_t base) {
+    keyspace_index_t left = total - base;
+    return left > KEYSPACE_WINDOW_MAX ? KEYSPACE_WINDOW_MAX : (long long)left;
+}
+
+#endif // KEYSPACE_H
@@ -0,0 +1,434 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "lookup_table.h"
+#include "candidate_gen.h"
+#include "progress.h"
+
+#define LOOKUP_BUCKETS 256      // Primeira passada da ordenação: byte alto da chave
+
+/**
+ * Trabalho de uma thread da construção
+ */
+typedef struct {
+    const keyspace_t *ks;
+    lookup_entry_t *entries;
+    long long start, count;         // Geração: índices [start, start + count)
+    atomic_int *next_bucket;        // Ordenação: próximo bucket livre
+    const long long *bucket_start;  // LOOKUP_BUCKETS + 1 posições
+    int failed;
+} lookup_worker_t;
+
+/**
+ * Gera as entradas do intervalo da thread, em ordem de índice
+ */
+static void *lookup_generate(void *arg) {
+    lookup_worker_t *w = arg;
+    const keyspace_t *ks = w->ks;
+    md5_block_batch_t batch;
+    uint32_t digests[4][MD5_BATCH_MAX];
+    long long index = w->start, end = w->start + w->count;
+
+    while (index < end) {
+        // Um trecho por comprimento: o gerador e o lote são de comprimento fixo
+        keyspace_index_t local;
+        int len = keyspace_locate(ks, index, &local);
+        long long count = ks->size[len] - local < end - index ? (long long)(ks->size[len] - local) : end - index;
+
+        candidate_gen_t gen;
+        candidate_gen_init(&gen, ks->charset, ks->radix, len, local, count);
+        md5_block_batch_init(&batch, len);
+        int n;
+        while ((n = candidate_gen_fill(&gen, &batch)) > 0) {
+            md5_block_batch_digests(&batch, digests);
+            for (int l = 0; l < n; l++) {
+                w->entries[index + l] = (lookup_entry_t){digests[0][l], (uint32_t)(index + l)};
+            }
+            index += n;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Ordena pelos 24 bits baixos da chave (radix LSD, 3 passadas de 8 bits);
+ * o byte alto já é o mesmo em todo o bucket
+ */
+static int lookup_sort_bucket(lookup_entry_t *entries, long long n) {
+    lookup_entry_t *tmp = malloc(n * sizeof(lookup_entry_t));
+    lookup_entry_t *src = entries, *dst = tmp;
+    if (tmp == NULL && n > 0) {
+        return -1;
+    }
+
+    for (int shift = 0; shift < 24; shift += 8) {
+        long long pos[256] = {0};
+        for (long long i = 0; i < n; i++) {
+            pos[(src[i].key >> shift) & 0xff]++;
+        }
+        long long sum = 0;
+        for (int b = 0; b < 256; b++) {
+            long long c = pos[b];
+            pos[b] = sum;
+            sum += c;
+        }
+        for (long long i = 0; i < n; i++) {
+            dst[pos[(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        lookup_entry_t *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    // Número ímpar de passadas: o resultado está em tmp
+    memcpy(entries, src, n * sizeof(lookup_entry_t));
+    free(tmp);
+    return 0;
+}
+
+static void *lookup_sort(void *arg) {
+    lookup_worker_t *w = arg;
+    int b;
+
+    while ((b = atomic_fetch_add(w->next_bucket, 1)) < LOOKUP_BUCKETS) {
+        long long first = w->bucket_start[b];
+        if (lookup_sort_bucket(w->entries + first, w->bucket_start[b + 1] - first) != 0) {
+            w->failed = 1;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Distribui as entradas pelos buckets do byte alto da chave, no lugar
+ * (American flag sort: cada troca leva uma entrada ao seu bucket)
+ */
+static void lookup_partition(lookup_entry_t *entries, long long count, long long bucket_start[]) {
+    long long next[LOOKUP_BUCKETS];
+
+    memset(bucket_start, 0, (LOOKUP_BUCKETS + 1) * sizeof(long long));
+    for (long long i = 0; i < count; i++) {
+        bucket_start[(entries[i].key >> 24) + 1]++;
+    }
+    for (int b = 0; b < LOOKUP_BUCKETS; b++) {
+        bucket_start[b + 1] += bucket_start[b];
+        next[b] = bucket_start[b];
+    }
+
+    for (int b = 0; b < LOOKUP_BUCKETS; b++) {
+        while (next[b] < bucket_start[b + 1]) {
+            lookup_entry_t e = entries[next[b]];
+            int d = e.key >> 24;
+            if (d == b) {
+                next[b]++;
+            } else {
+                entries[next[b]] = entries[next[d]];
+                entries[next[d]++] = e;
+            }
+        }
+    }
+}
+
+/**
+ * Roda fn numa thread por worker e espera todas
+ */
+static int lookup_run_threads(void *(*fn)(void *), lookup_worker_t *workers, int threads) {
+    pthread_t tids[threads];
+    int created[threads];
+    int failed = 0;
+
+    for (int i = 0; i < threads; i++) {
+        created[i] = pthread_create(&tids[i], NULL, fn, &workers[i]) == 0;
+        if (!created[i]) {
+            // Sem thread: o trabalho dela roda aqui mesmo
+            fn(&workers[i]);
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        if (created[i]) {
+            pthread_join(tids[i], NULL);
+        }
+        failed |= workers[i].failed;
+    }
+    return failed ? -1 : 0;
+}
+
+/**
+ * Gera e ordena todas as entradas do espaço
+ *
+ * @return 0 em caso de sucesso, -1 se faltou memória para a ordenação
+ */
+static int lookup_fill(lookup_entry_t *entries, const keyspace_t *ks, int threads) {
+    lookup_worker_t workers[threads];
+
+    // 1. Gerar: cada thread preenche um trecho contíguo de índices
+    // (lookup_table_build já limitou o total a LOOKUP_MAX_ENTRIES)
+    long long total = (long long)ks->total;
+    double start = progress_now();
+    for (int t = 0; t < threads; t++) {
+        long long first = total * t / threads;
+        workers[t] = (lookup_worker_t){.ks = ks, .entries = entries, .start = first,
+                                       .count = total * (t + 1) / threads - first};
+    }
+    lookup_run_threads(lookup_generate, workers, threads);
+    LOG(LOG_NORMAL, "Tabela: %lld entradas geradas em %.2f s\n", total, progress_now() - start);
+
+    // 2. Ordenar: buckets pelo byte alto, depois cada bucket numa thread
+    long long bucket_start[LOOKUP_BUCKETS + 1];
+    atomic_int next_bucket = 0;
+    start = progress_now();
+    lookup_partition(entries, total, bucket_start);
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (lookup_worker_t){.entries = entries, .next_bucket = &next_bucket,
+                                       .bucket_start = bucket_start};
+    }
+    if (lookup_run_threads(lookup_sort, workers, threads) != 0) {
+        return -1;
+    }
+    LOG(LOG_NORMAL, "Tabela: ordenada em %.2f s\n", progress_now() - start);
+    return 0;
+}
+
+/**
+ * Grava uma string do cabeçalho (tamanho, bytes e '\0') em p
+ *
+ * @return Bytes ocupados
+ */
+static size_t lookup_put_str(uint8_t *p, const char *str) {
+    uint32_t len = str != NULL ? strlen(str) : LOOKUP_STR_NULL;
+    if (p != NULL) {
+        memcpy(p, &len, sizeof(len));
+        if (str != NULL) {
+            memcpy(p + sizeof(len), str, len + 1);
+        }
+    }
+    return sizeof(len) + (str != NULL ? len + 1 : 0);
+}
+
+int lookup_table_build(const char *path, const keyspace_t *ks, const char *charset,
+                       const char *mask, const char *const custom[KEYSPACE_CUSTOM_CHARSETS],
+                       int threads) {
+    const char *strings[LOOKUP_STRINGS] = {charset, mask};
+    for (int k = 0; k < KEYSPACE_CUSTOM_CHARSETS; k++) {
+        strings[2 + k] = custom != NULL ? custom[k] : NULL;
+    }
+    if (ks->total > LOOKUP_MAX_ENTRIES) {
+        errno = EFBIG;
+        return -1;
+    }
+
+    size_t header_size = sizeof(lookup_header_t);
+    for (int k = 0; k < LOOKUP_STRINGS; k++) {
+        header_size += lookup_put_str(NULL, strings[k]);
+    }
+    header_size = (header_size + 63) & ~(size_t)63;
+    size_t file_size = header_size + (size_t)ks->total * sizeof(lookup_entry_t);
+
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return -1;
+    }
+    uint8_t *map = MAP_FAILED;
+    if (ftruncate(fd, file_size) != 0 ||
+        (map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        goto fail;
+    }
+
+    if (lookup_fill((lookup_entry_t*)(map + header_size), ks, threads) != 0) {
+        errno = ENOMEM;
+        goto fail;
+    }
+
+    // Cabeçalho por último e rename: um arquivo incompleto nunca tem o nome final
+    lookup_header_t header = {.version = LOOKUP_VERSION, .header_size = header_size,
+                              .min_len = ks->min_len, .max_len = ks->max_len, .count = (uint64_t)ks->total};
+    memcpy(header.magic, LOOKUP_MAGIC, sizeof(header.magic));
+    memcpy(map, &header, sizeof(header));
+    uint8_t *p = map + sizeof(header);
+    for (int k = 0; k < LOOKUP_STRINGS; k++) {
+        p += lookup_put_str(p, strings[k]);
+    }
+    if (msync(map, file_size, MS_SYNC) != 0 || munmap(map, file_size) != 0) {
+        map = MAP_FAILED;
+        goto fail;
+    }
+    map = MAP_FAILED;
+    if (fsync(fd) != 0 || close(fd) != 0) {
+        fd = -1;
+        goto fail;
+    }
+    fd = -1;
+    if (rename(tmp, path) != 0) {
+        goto fail;
+    }
+    return 0;
+
+fail:;
+    int saved = errno;
+    if (map != MAP_FAILED) {
+        munmap(map, file_size);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+    unlink(tmp);
+    errno = saved;
+    return -1;
+}
+
+/**
+ * Lê uma string do cabeçalho
+ *
+ * @return 0 em caso de sucesso, -1 se passa do fim do cabeçalho
+ */
+static int lookup_get_str(const uint8_t **p, const uint8_t *end, const char **str) {
+    uint32_t len;
+    if (end - *p < (long)sizeof(len)) {
+        return -1;
+    }
+    memcpy(&len, *p, sizeof(len));
+    *p += sizeof(len);
+    *str = NULL;
+    if (len == LOOKUP_STR_NULL) {
+        return 0;
+    }
+    if ((size_t)(end - *p) <= len || (*p)[len] != '\0') {
+        return -1;
+    }
+    *str = (const char*)*p;
+    *p += len + 1;
+    return 0;
+}
+
+int lookup_table_open(lookup_table_t *table, const char *path) {
+    struct stat st;
+    lookup_header_t header;
+
+    memset(table, 0, sizeof(*table));
+    table->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (table->fd == -1) {
+        return -1;
+    }
+    if (fstat(table->fd, &st) != 0) {
+        int saved = errno;
+        close(table->fd);
+        errno = saved;
+        return -1;
+    }
+    if ((size_t)st.st_size < sizeof(header)) {
+        close(table->fd);
+        return -2;
+    }
+    table->map_size = st.st_size;
+    table->map = mmap(NULL, table->map_size, PROT_READ, MAP_SHARED, table->fd, 0);
+    if (table->map == MAP_FAILED) {
+        int saved = errno;
+        close(table->fd);
+        errno = saved;
+        return -1;
+    }
+
+    // Cabeçalho, strings e tamanho do arquivo têm de bater com o espaço remontado
+    const uint8_t *base = table->map;
+    memcpy(&header, base, sizeof(header));
+    const uint8_t *p = base + sizeof(header), *end = base + header.header_size;
+    int valid = memcmp(header.magic, LOOKUP_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == LOOKUP_VERSION && header.header_size >= sizeof(header) &&
+                header.header_size <= table->map_size &&
+                header.count <= (table->map_size - header.header_size) / sizeof(lookup_entry_t);
+    const char *strings[LOOKUP_STRINGS];
+    for (int k = 0; valid && k < LOOKUP_STRINGS; k++) {
+        valid = lookup_get_str(&p, end, &strings[k]) == 0;
+    }
+    if (valid) {
+        table->charset = strings[0];
+        table->mask = strings[1];
+        memcpy(table->custom, strings + 2, sizeof(table->custom));
+        int rc = table->mask != NULL
+            ? keyspace_init_mask(&table->keyspace, table->mask, table->custom, header.min_len, header.max_len)
+            : table->charset != NULL
+            ? keyspace_init(&table->keyspace, table->charset, strlen(table->charset),
+                            header.min_len, header.max_len)
+            : -1;
+        valid = rc == 0 && table->keyspace.total == (keyspace_index_t)header.count;
+    }
+    if (!valid) {
+        lookup_table_close(table);
+        return -2;
+    }
+
+    table->entries = (const lookup_entry_t*)(base + header.header_size);
+    table->count = header.count;
+    // Consultas aleatórias: sem leitura antecipada de páginas vizinhas
+    madvise(table->map, table->map_size, MADV_RANDOM);
+    return 0;
+}
+
+int lookup_table_find(const lookup_table_t *table, const md5_target_t *target,
+                      char *password, int *probes) {
+    const lookup_entry_t *e = table->entries;
+    uint32_t key = target->words[0];
+    long long lo = 0, hi = table->count - 1, pos = -1;
+    int reads = 0;
+
+    // Interpolação: as chaves são uniformes, a posição esperada é proporcional à chave
+    while (lo <= hi && key >= e[lo].key && key <= e[hi].key) {
+        long long mid = lo;
+        if (e[hi].key != e[lo].key) {
+            mid = lo + (long long)((double)(key - e[lo].key) / (e[hi].key - e[lo].key) * (hi - lo));
+        }
+        reads++;
+        if (e[mid].key < key) {
+            lo = mid + 1;
+        } else if (e[mid].key > key) {
+            hi = mid - 1;
+        } else {
+            pos = mid;
+            break;
+        }
+    }
+
+    int found = 0;
+    if (pos >= 0) {
+        // Chaves de 32 bits colidem: conferir cada entrada com a mesma chave
+        while (pos > 0 && e[pos - 1].key == key) {
+            pos--;
+        }
+        for (; !found && pos < table->count && e[pos].key == key; pos++) {
+            const char *inputs[1] = {password};
+            uint8_t digest[1][MD5_DIGEST_LENGTH];
+            size_t len;
+            reads++;
+            keyspace_password(&table->keyspace, e[pos].index, password);
+            len = strlen(password);
+            md5_batch(inputs, &len, 1, digest);
+            found = memcmp(digest[0], target->digest, MD5_DIGEST_LENGTH) == 0;
+        }
+    }
+    if (probes != NULL) {
+        *probes = reads;
+    }
+    return found;
+}
+
+void lookup_table_close(lookup_table_t *table) {
+    if (table->map != NULL && table->map != MAP_FAILED) {
+        munmap(table->map, table->map_size);
+    }
+    if (table->fd > 0) {
+        close(table->fd);
+    }
+    memset(table, 0, sizeof(*table));
+}
@@ -0,0 +1,101 @@
+#ifndef LOOKUP_TABLE_H
+#define LOOKUP_TABLE_H
+
+#include <stdint.h>
+#include "hash_utils.h"
+#include "keyspace.h"
+
+/**
+ * Tabelas de consulta pré-computadas (--build-table / --table) - Mini-Projeto 1
+ *
+ * Para espaços pequenos consultados muitas vezes (PINs de 6 caracteres,
+ * por exemplo), o espaço é enumerado uma única vez e cada candidato vira
+ * uma entrada de 8 bytes: a palavra A do digest (32 bits, truncada) e o
+ * índice do candidato no espaço. As entradas são gravadas ordenadas pela
+ * palavra A; como os digests são uniformes, a consulta usa busca por
+ * interpolação (O(log log n) acessos ao arquivo mapeado em memória) e
+ * confere cada entrada com a mesma palavra A recalculando um único MD5.
+ *
+ * Formato:
+ *
+ *   lookup_header_t          magic, versão, comprimentos, total de entradas
+ *   6 strings                u32 tamanho + bytes + '\0' (LOOKUP_STR_NULL =
+ *                            ausente): charset, máscara, -1..-4
+ *   (preenchimento até header_size, múltiplo de 64)
+ *   lookup_entry_t[count]    ordenadas por key
+ *
+ * O arquivo guarda a definição do espaço: a consulta não precisa de
+ * <tamanho>/<charset>. A construção grava num arquivo temporário e o
+ * renomeia no fim (uma tabela interrompida nunca é usada).
+ */
+
+#define LOOKUP_MAGIC "QSLTAB\0\1"
+#define LOOKUP_VERSION 1
+#define LOOKUP_MAX_ENTRIES (1LL << 32)      // Índices de 32 bits
+#define LOOKUP_STR_NULL 0xffffffffu
+#define LOOKUP_STRINGS (2 + KEYSPACE_CUSTOM_CHARSETS)
+
+typedef struct {
+    uint32_t key;       // Palavra A do digest (md5_target_t.words[0])
+    uint32_t index;     // Índice global do candidato (keyspace_password)
+} lookup_entry_t;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;   // Bytes até a primeira entrada
+    int32_t min_len;
+    int32_t max_len;
+    uint64_t count;         // Entradas (= total do espaço)
+} lookup_header_t;
+
+/**
+ * Tabela aberta para consulta (contém um keyspace_t: não copiar)
+ */
+typedef struct {
+    int fd;
+    void *map;
+    size_t map_size;
+    const lookup_entry_t *entries;
+    long long count;
+    const char *charset;        // Strings dentro do mapeamento (NULL = ausente)
+    const char *mask;
+    const char *custom[KEYSPACE_CUSTOM_CHARSETS];
+    keyspace_t keyspace;
+} lookup_table_t;
+
+/**
+ * Enumera o espaço com threads e grava a tabela ordenada em path
+ *
+ * @param ks Espaço já montado a partir de charset ou mask/custom
+ * @param charset Charset da força bruta (NULL com máscara)
+ * @param mask Máscara (NULL na força bruta)
+ * @param threads Threads para gerar e ordenar as entradas
+ * @return 0 em caso de sucesso, -1 em caso de erro (errno preservado;
+ *         EFBIG se o espaço passa de LOOKUP_MAX_ENTRIES)
+ */
+int lookup_table_build(const char *path, const keyspace_t *ks, const char *charset,
+                       const char *mask, const char *const custom[KEYSPACE_CUSTOM_CHARSETS],
+                       int threads);
+
+/**
+ * Mapeia uma tabela e remonta o seu espaço de busca
+ *
+ * @return 0 em caso de sucesso, -1 se não pôde ser aberta (errno), -2 se
+ *         o arquivo não é uma tabela válida
+ */
+int lookup_table_open(lookup_table_t *table, const char *path);
+
+/**
+ * Procura a senha de um alvo
+ *
+ * @param password Saída com pelo menos keyspace.max_len + 1 bytes
+ * @param probes Saída opcional: entradas lidas na busca
+ * @return 1 se encontrou (senha conferida com o MD5 completo), 0 se não
+ */
+int lookup_table_find(const lookup_table_t *table, const md5_target_t *target,
+                      char *password, int *probes);
+
+void lookup_table_close(lookup_table_t *table);
+
+#endif // LOOKUP_TABLE_H
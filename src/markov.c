@@ -0,0 +1,137 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "markov.h"
+#include "wordlist.h"
+
+#define MARKOV_TRAIN_BATCH 1024         // Palavras por chamada a wordlist_next_batch
+
+/**
+ * Hash FNV-1a das contagens: identifica o modelo sem comparar o arquivo
+ */
+static unsigned long long markov_hash(const markov_model_t *model) {
+    const unsigned char *bytes = (const unsigned char*)model->count;
+    unsigned long long hash = 0xcbf29ce484222325ull;
+
+    for (size_t i = 0; i < sizeof(model->count); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash ^ model->words;
+}
+
+int markov_train(markov_model_t *model, const char *wordlist_path) {
+    wordlist_t wl;
+    const char *words[MARKOV_TRAIN_BATCH];
+    int lens[MARKOV_TRAIN_BATCH];
+    long long pos = 0;
+    int n;
+
+    if (wordlist_open(&wl, wordlist_path) != 0) {
+        return -1;
+    }
+    memset(model, 0, sizeof(*model));
+    while ((n = wordlist_next_batch(&wl, &pos, wl.size, words, lens, MARKOV_TRAIN_BATCH)) > 0) {
+        for (int w = 0; w < n; w++) {
+            const unsigned char *p = (const unsigned char*)words[w];
+            for (int i = 0; i < lens[w]; i++) {
+                if (i < MARKOV_POSITIONS && model->count[i][p[i]] < UINT32_MAX) {
+                    model->count[i][p[i]]++;
+                }
+                if (model->count[MARKOV_POSITIONS][p[i]] < UINT32_MAX) {
+                    model->count[MARKOV_POSITIONS][p[i]]++;
+                }
+            }
+            model->words += lens[w] > 0;
+        }
+    }
+    wordlist_close(&wl);
+    model->id = markov_hash(model);
+    return 0;
+}
+
+int markov_save(const markov_model_t *model, const char *path) {
+    markov_header_t header = {.version = MARKOV_VERSION, .positions = MARKOV_POSITIONS,
+                              .words = model->words};
+    memcpy(header.magic, MARKOV_MAGIC, sizeof(header.magic));
+
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return -1;
+    }
+    if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header) ||
+        write(fd, model->count, sizeof(model->count)) != (ssize_t)sizeof(model->count) ||
+        fsync(fd) != 0) {
+        int saved = errno != 0 ? errno : EIO;
+        close(fd);
+        unlink(tmp);
+        errno = saved;
+        return -1;
+    }
+    if (close(fd) != 0 || rename(tmp, path) != 0) {
+        int saved = errno;
+        unlink(tmp);
+        errno = saved;
+        return -1;
+    }
+    return 0;
+}
+
+int markov_load(markov_model_t *model, const char *path) {
+    markov_header_t header;
+    char extra;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    memset(model, 0, sizeof(*model));
+    int ok = read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+             memcmp(header.magic, MARKOV_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == MARKOV_VERSION && header.positions == MARKOV_POSITIONS &&
+             read(fd, model->count, sizeof(model->count)) == (ssize_t)sizeof(model->count) &&
+             read(fd, &extra, 1) == 0;
+    close(fd);
+    if (!ok) {
+        return -2;
+    }
+    model->words = header.words;
+    model->id = markov_hash(model);
+    return 0;
+}
+
+int markov_apply(const markov_model_t *model, keyspace_t *ks) {
+    for (int i = 0; i < ks->positions; i++) {
+        const uint32_t *count = model->count[i < MARKOV_POSITIONS ? i : MARKOV_POSITIONS];
+        int n = ks->radix[i];
+        char *out = ks->pool + ks->pool_used;
+
+        if (ks->pool_used + n + 1 > KEYSPACE_POOL_SIZE) {
+            return -1;
+        }
+        memcpy(out, ks->charset[i], n);
+        out[n] = '\0';
+
+        // Inserção estável, da maior contagem para a menor (charsets de até 256)
+        for (int j = 1; j < n; j++) {
+            char c = out[j];
+            int k = j;
+            while (k > 0 && count[(unsigned char)out[k - 1]] < count[(unsigned char)c]) {
+                out[k] = out[k - 1];
+                k--;
+            }
+            out[k] = c;
+        }
+        ks->charset[i] = out;
+        ks->pool_used += n + 1;
+    }
+    ks->ordered = 1;
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+#include "keyspace.h"
+
+/**
+ * Enumeração por probabilidade (--markov) - Mini-Projeto 1
+ *
+ * Senhas escolhidas por pessoas se concentram em poucos caracteres por
+ * posição (maiúscula no início, dígitos no fim...). O modelo guarda quantas
+ * vezes cada byte aparece em cada posição das palavras de uma wordlist,
+ * treinado offline uma única vez (coordinator --train-markov). Na busca,
+ * markov_apply reordena o charset de cada posição do mais para o menos
+ * frequente e liga a numeração em faixas de keyspace.h: os candidatos mais
+ * prováveis vêm primeiro, o que reduz o tempo mediano até achar a senha sem
+ * mudar o espaço coberto nem o custo de percorrê-lo inteiro.
+ *
+ * Formato do arquivo (little-endian):
+ *
+ *   markov_header_t                    magic, versão, posições, palavras
+ *   uint32_t count[positions + 1][256] ocorrências de cada byte por posição;
+ *                                      a última linha soma todas as posições
+ *                                      (usada a partir de MARKOV_POSITIONS)
+ */
+
+#define MARKOV_MAGIC "QSMKV\0\0\1"
+#define MARKOV_VERSION 1
+#define MARKOV_POSITIONS 16             // Posições com estatística própria
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t positions;     // MARKOV_POSITIONS
+    uint64_t words;         // Palavras da wordlist de treino
+} markov_header_t;
+
+typedef struct {
+    uint64_t words;
+    uint32_t count[MARKOV_POSITIONS + 1][256];
+    unsigned long long id;  // Hash do conteúdo (checkpoint e conferência nos nós)
+} markov_model_t;
+
+/**
+ * Conta os bytes de cada posição de todas as palavras da wordlist
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro (errno indica a causa)
+ */
+int markov_train(markov_model_t *model, const char *wordlist_path);
+
+/**
+ * Grava o modelo (arquivo temporário + rename)
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro (errno indica a causa)
+ */
+int markov_save(const markov_model_t *model, const char *path);
+
+/**
+ * Lê um modelo gravado por markov_save
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro de E/S (errno), -2 se o
+ *         arquivo não é um modelo válido
+ */
+int markov_load(markov_model_t *model, const char *path);
+
+/**
+ * Reordena o charset de cada posição pela frequência no modelo (empates
+ * mantêm a ordem original) e liga a numeração em faixas (ks->ordered)
+ *
+ * @return 0 em caso de sucesso, -1 se o pool do keyspace encheu
+ */
+int markov_apply(const markov_model_t *model, keyspace_t *ks);
+
+#endif // MARKOV_H
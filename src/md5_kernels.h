@@ -0,0 +1,309 @@
+#ifndef MD5_KERNELS_H
+#define MD5_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hash_utils.h"
+
+/**
+ * Definições internas compartilhadas pelos kernels MD5 (escalar e SIMD).
+ * NÃO faz parte da API pública - use hash_utils.h.
+ *
+ * As funções auxiliares e os passos do MD5 são macros de expressão pura,
+ * então funcionam tanto com uint32_t quanto com os tipos vetoriais do GCC
+ * (vector_size), o que permite escrever os 64 passos uma única vez.
+ */
+
+#define MD5_INIT_A 0x67452301u
+#define MD5_INIT_B 0xefcdab89u
+#define MD5_INIT_C 0x98badcfeu
+#define MD5_INIT_D 0x10325476u
+
+#define S11 7
+#define S12 12
+#define S13 17
+#define S14 22
+#define S21 5
+#define S22 9
+#define S23 14
+#define S24 20
+#define S31 4
+#define S32 11
+#define S33 16
+#define S34 23
+#define S41 6
+#define S42 10
+#define S43 15
+#define S44 21
+
+#define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
+#define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
+#define H(x, y, z) ((x) ^ (y) ^ (z))
+#define I(x, y, z) ((y) ^ ((x) | (~z)))
+
+#define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32-(n))))
+
+#define FF(a, b, c, d, x, s, ac) { \
+    (a) += F ((b), (c), (d)) + (x) + (uint32_t)(ac); \
+    (a) = ROTATE_LEFT ((a), (s)); \
+    (a) += (b); \
+}
+#define GG(a, b, c, d, x, s, ac) { \
+    (a) += G ((b), (c), (d)) + (x) + (uint32_t)(ac); \
+    (a) = ROTATE_LEFT ((a), (s)); \
+    (a) += (b); \
+}
+#define HH(a, b, c, d, x, s, ac) { \
+    (a) += H ((b), (c), (d)) + (x) + (uint32_t)(ac); \
+    (a) = ROTATE_LEFT ((a), (s)); \
+    (a) += (b); \
+}
+#define II(a, b, c, d, x, s, ac) { \
+    (a) += I ((b), (c), (d)) + (x) + (uint32_t)(ac); \
+    (a) = ROTATE_LEFT ((a), (s)); \
+    (a) += (b); \
+}
+
+/**
+ * Lista dos 64 passos do MD5 (RFC 1321) como X-macro.
+ *
+ * STEP(n, op, a, b, c, d, k, s, ac):
+ *   n  - número do passo (0..63)
+ *   op - FF/GG/HH/II
+ *   k  - índice da palavra da mensagem consumida no passo
+ *
+ * Quem expande a lista decide o que fazer com cada passo (executar,
+ * inserir um "case n:" para começar no meio, parar antes do fim...).
+ */
+#define MD5_STEPS(STEP) \
+    STEP( 0, FF, a, b, c, d,  0, S11, 0xd76aa478) \
+    STEP( 1, FF, d, a, b, c,  1, S12, 0xe8c7b756) \
+    STEP( 2, FF, c, d, a, b,  2, S13, 0x242070db) \
+    STEP( 3, FF, b, c, d, a,  3, S14, 0xc1bdceee) \
+    STEP( 4, FF, a, b, c, d,  4, S11, 0xf57c0faf) \
+    STEP( 5, FF, d, a, b, c,  5, S12, 0x4787c62a) \
+    STEP( 6, FF, c, d, a, b,  6, S13, 0xa8304613) \
+    STEP( 7, FF, b, c, d, a,  7, S14, 0xfd469501) \
+    STEP( 8, FF, a, b, c, d,  8, S11, 0x698098d8) \
+    STEP( 9, FF, d, a, b, c,  9, S12, 0x8b44f7af) \
+    STEP(10, FF, c, d, a, b, 10, S13, 0xffff5bb1) \
+    STEP(11, FF, b, c, d, a, 11, S14, 0x895cd7be) \
+    STEP(12, FF, a, b, c, d, 12, S11, 0x6b901122) \
+    STEP(13, FF, d, a, b, c, 13, S12, 0xfd987193) \
+    STEP(14, FF, c, d, a, b, 14, S13, 0xa679438e) \
+    STEP(15, FF, b, c, d, a, 15, S14, 0x49b40821) \
+    STEP(16, GG, a, b, c, d,  1, S21, 0xf61e2562) \
+    STEP(17, GG, d, a, b, c,  6, S22, 0xc040b340) \
+    STEP(18, GG, c, d, a, b, 11, S23, 0x265e5a51) \
+    STEP(19, GG, b, c, d, a,  0, S24, 0xe9b6c7aa) \
+    STEP(20, GG, a, b, c, d,  5, S21, 0xd62f105d) \
+    STEP(21, GG, d, a, b, c, 10, S22, 0x02441453) \
+    STEP(22, GG, c, d, a, b, 15, S23, 0xd8a1e681) \
+    STEP(23, GG, b, c, d, a,  4, S24, 0xe7d3fbc8) \
+    STEP(24, GG, a, b, c, d,  9, S21, 0x21e1cde6) \
+    STEP(25, GG, d, a, b, c, 14, S22, 0xc33707d6) \
+    STEP(26, GG, c, d, a, b,  3, S23, 0xf4d50d87) \
+    STEP(27, GG, b, c, d, a,  8, S24, 0x455a14ed) \
+    STEP(28, GG, a, b, c, d, 13, S21, 0xa9e3e905) \
+    STEP(29, GG, d, a, b, c,  2, S22, 0xfcefa3f8) \
+    STEP(30, GG, c, d, a, b,  7, S23, 0x676f02d9) \
+    STEP(31, GG, b, c, d, a, 12, S24, 0x8d2a4c8a) \
+    STEP(32, HH, a, b, c, d,  5, S31, 0xfffa3942) \
+    STEP(33, HH, d, a, b, c,  8, S32, 0x8771f681) \
+    STEP(34, HH, c, d, a, b, 11, S33, 0x6d9d6122) \
+    STEP(35, HH, b, c, d, a, 14, S34, 0xfde5380c) \
+    STEP(36, HH, a, b, c, d,  1, S31, 0xa4beea44) \
+    STEP(37, HH, d, a, b, c,  4, S32, 0x4bdecfa9) \
+    STEP(38, HH, c, d, a, b,  7, S33, 0xf6bb4b60) \
+    STEP(39, HH, b, c, d, a, 10, S34, 0xbebfbc70) \
+    STEP(40, HH, a, b, c, d, 13, S31, 0x289b7ec6) \
+    STEP(41, HH, d, a, b, c,  0, S32, 0xeaa127fa) \
+    STEP(42, HH, c, d, a, b,  3, S33, 0xd4ef3085) \
+    STEP(43, HH, b, c, d, a,  6, S34, 0x04881d05) \
+    STEP(44, HH, a, b, c, d,  9, S31, 0xd9d4d039) \
+    STEP(45, HH, d, a, b, c, 12, S32, 0xe6db99e5) \
+    STEP(46, HH, c, d, a, b, 15, S33, 0x1fa27cf8) \
+    STEP(47, HH, b, c, d, a,  2, S34, 0xc4ac5665) \
+    STEP(48, II, a, b, c, d,  0, S41, 0xf4292244) \
+    STEP(49, II, d, a, b, c,  7, S42, 0x432aff97) \
+    STEP(50, II, c, d, a, b, 14, S43, 0xab9423a7) \
+    STEP(51, II, b, c, d, a,  5, S44, 0xfc93a039) \
+    STEP(52, II, a, b, c, d, 12, S41, 0x655b59c3) \
+    STEP(53, II, d, a, b, c,  3, S42, 0x8f0ccc92) \
+    STEP(54, II, c, d, a, b, 10, S43, 0xffeff47d) \
+    STEP(55, II, b, c, d, a,  1, S44, 0x85845dd1) \
+    STEP(56, II, a, b, c, d,  8, S41, 0x6fa87e4f) \
+    STEP(57, II, d, a, b, c, 15, S42, 0xfe2ce6e0) \
+    STEP(58, II, c, d, a, b,  6, S43, 0xa3014314) \
+    STEP(59, II, b, c, d, a, 13, S44, 0x4e0811a1) \
+    STEP(60, II, a, b, c, d,  4, S41, 0xf7537e82) \
+    STEP(61, II, d, a, b, c, 11, S42, 0xbd3af235) \
+    STEP(62, II, c, d, a, b,  2, S43, 0x2ad7d2bb) \
+    STEP(63, II, b, c, d, a,  9, S44, 0xeb86d391)
+
+/* Expansão padrão: executa o passo sobre o vetor de palavras x[] */
+#define MD5_STEP_RUN(n, op, a, b, c, d, k, s, ac) op(a, b, c, d, x[k], s, ac)
+
+/* Executa até o passo last_step (>= 48) e salta para o rótulo "reached" */
+#define MD5_STEP_RUN_UNTIL(n, op, a, b, c, d, k, s, ac) \
+    op(a, b, c, d, x[k], s, ac) \
+    if ((n) >= 48 && (n) == last_step) goto reached;
+
+/* Igual, mas com um "case n:" antes de cada passo para retomar no meio */
+#define MD5_STEP_RESUME(n, op, a, b, c, d, k, s, ac) \
+    case n: MD5_STEP_RUN_UNTIL(n, op, a, b, c, d, k, s, ac)
+
+/**
+ * Palavras do bloco de um candidato de comprimento len (1..MD5_SPECIALIZED_MAX)
+ * conhecido em tempo de compilação; len = 0 é o caso genérico (todas lidas).
+ *
+ * Só as palavras com bytes do candidato variam; as outras são o 0x80 do
+ * padding (quando len é múltiplo de 4), o comprimento em bits (palavra 14)
+ * ou zero. Nos kernels especializados elas viram constantes, e o compilador
+ * as dobra nos passos: x[k] + ac vira uma constante só, e somar zero some.
+ */
+#define MD5_WORD_VARIES(j, len) ((len) == 0 || (j) < ((len) + 3) / 4)
+#define MD5_WORD_CONST(j, len) \
+    ((j) == (len) / 4 ? 0x80u : (j) == 14 ? (uint32_t)(len) << 3 : 0u)
+
+/* Concatenação com expansão dos argumentos (nomes das variantes geradas) */
+#define MD5_CAT(a, b) MD5_CAT_(a, b)
+#define MD5_CAT_(a, b) a##b
+
+/* Índice no estado (0..3) do registrador atualizado por um passo */
+#define MD5_REG_a 0
+#define MD5_REG_b 1
+#define MD5_REG_c 2
+#define MD5_REG_d 3
+
+/**
+ * Assinatura comum dos kernels multi-buffer.
+ *
+ * Cada chamada comprime `lanes` blocos de 64 bytes já com padding e
+ * comprimento, em layout transposto: words[j * stride + l] é a palavra j
+ * (little-endian) do bloco da lane l. O resultado já inclui a soma do
+ * estado inicial: state[i * state_stride + l] é a palavra i do digest.
+ */
+typedef void (*md5_kernel_fn)(const uint32_t *words, size_t stride,
+                              uint32_t *state, size_t state_stride);
+
+/**
+ * Variante de busca: executa os passos 0..last_step (last_step >= 48) sobre
+ * `lanes` blocos (mesmo layout acima), a partir do estado start (NULL = o IV
+ * do MD5; só as variantes genéricas aceitam outro, o dos blocos de um sal),
+ * e compara o estado (a, b, c, d) nesse ponto com expect. Com
+ * last_step = 63, expect é o digest alvo menos o estado inicial;
+ * com alvo revertido (md5_target_reverse), é o estado esperado no meio da
+ * rodada 4. A palavra A é testada primeiro; B, C e D só quando alguma bate.
+ *
+ * Com expect == NULL (vários alvos), não compara: grava o estado de cada
+ * lane em state_out[i * lanes + l] e devolve todas as lanes.
+ *
+ * @return Máscara de bits das lanes cujo estado é exatamente o esperado
+ */
+typedef uint32_t (*md5_match_fn)(const uint32_t *words, size_t stride, const uint32_t start[4],
+                                 const uint32_t expect[4], int last_step,
+                                 uint32_t *state_out);
+
+/**
+ * Variante incremental: todas as lanes compartilham as palavras words[] e o
+ * estado start[] já calculado até o passo first_step - 1; só a palavra
+ * var_word difere, com o valor de cada lane em var_values[0..lanes-1].
+ * Retoma em first_step (<= var_word) e compara (ou grava o estado, com
+ * expect == NULL) como md5_match_fn.
+ *
+ * @return Máscara de bits das lanes cujo estado é exatamente o esperado
+ */
+typedef uint32_t (*md5_resume_fn)(const uint32_t words[16], const uint32_t start[4],
+                                  int first_step, int var_word,
+                                  const uint32_t *var_values,
+                                  const uint32_t expect[4], int last_step,
+                                  uint32_t *state_out);
+
+typedef struct {
+    const char *name;     // "scalar", "sse2", "avx2", "avx512"
+    int lanes;            // blocos processados por chamada
+    md5_kernel_fn fn;
+    md5_match_fn match;
+    md5_resume_fn resume;
+    const char *cpu_feature;  // feature exigida (NULL = sempre disponível)
+    // Variantes especializadas por comprimento: [len], 1..MD5_SPECIALIZED_MAX
+    // (na resume, var_word tem de ser (len - 1) / 4, como em md5_incremental_t)
+    const md5_match_fn *match_len;
+    const md5_resume_fn *resume_len;
+} md5_kernel_t;
+
+extern int md5_specialized_enabled;
+
+/**
+ * Variante de busca para candidatos de comprimento len: a especializada,
+ * se houver (e não foi desativada), senão a genérica
+ */
+static inline md5_match_fn md5_kernel_match(const md5_kernel_t *kernel, int len) {
+    return md5_specialized_enabled && len <= MD5_SPECIALIZED_MAX ? kernel->match_len[len] : kernel->match;
+}
+
+static inline md5_resume_fn md5_kernel_resume(const md5_kernel_t *kernel, int len) {
+    return md5_specialized_enabled && len <= MD5_SPECIALIZED_MAX ? kernel->resume_len[len] : kernel->resume;
+}
+
+#define MD5_SET_HASH_MULT 0x9e3779b1u
+
+/**
+ * Monta o bloco único (mensagem + 0x80 + zeros + comprimento em bits) de
+ * uma entrada de até MD5_SINGLE_BLOCK_MAX bytes na coluna words[j * stride]
+ * do layout transposto (usado também por hash_algo.c)
+ */
+void md5_pad_lane(uint32_t *words, size_t stride, const uint8_t *input, size_t len);
+
+/**
+ * Aloca o conjunto (bitmap e tabela vazios) para count alvos; os alvos
+ * entram com md5_target_set_insert (usado também por hash_algo.c)
+ *
+ * @return 0 em caso de sucesso, -1 se faltar memória
+ */
+int md5_target_set_alloc(md5_target_set_t *set, int count, int len);
+
+/**
+ * Insere o alvo i com o estado esperado expect (a palavra A é a chave)
+ */
+void md5_target_set_insert(md5_target_set_t *set, int i, const uint32_t expect[4]);
+
+/**
+ * Procura o estado (a, b, c, d) no conjunto: bitmap, depois tabela
+ * 
+ * @return Índice do alvo, ou -1
+ */
+static inline int md5_target_set_lookup(const md5_target_set_t *set, uint32_t a, uint32_t b,
+                                        uint32_t c, uint32_t d) {
+    if (!((set->bitmap[(a & set->bitmap_mask) >> 6] >> (a & 63)) & 1)) {
+        return -1;
+    }
+    md5_prefilter_passes++;
+
+    uint32_t pos = (a * MD5_SET_HASH_MULT) >> set->table_shift;
+    for (uint32_t slot; (slot = set->table[pos]) != 0; pos = (pos + 1) & set->table_mask) {
+        const uint32_t *e = set->expect[slot - 1];
+        if (e[0] == a && e[1] == b && e[2] == c && e[3] == d) {
+            return (int)slot - 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Compressão MD5 de um bloco já decodificado em 16 palavras
+ */
+void md5_compress(uint32_t state[4], const uint32_t x[16]);
+
+/**
+ * Kernel selecionado para esta CPU (detectado via CPUID na primeira chamada)
+ */
+const md5_kernel_t *md5_kernel_active(void);
+
+/**
+ * Tabela de todos os kernels compilados, terminada por um item com name == NULL
+ */
+const md5_kernel_t *md5_kernel_table(void);
+
+#endif // MD5_KERNELS_H
@@ -0,0 +1,286 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include <string.h>
+#include "hash_utils.h"
+#include "md5_kernels.h"
+
+/**
+ * Kernels MD5 multi-buffer e seleção em tempo de execução
+ *
+ * Cada kernel x86 é gerado a partir de md5_simd_kernel.h com um
+ * __attribute__((target)) diferente, então o binário roda em qualquer
+ * x86-64 e só usa AVX2/AVX-512 quando a CPU (via CPUID) suporta.
+ *
+ * Cada kernel também tem variantes de busca/incremental especializadas por
+ * comprimento (1..MD5_SPECIALIZED_MAX), escolhidas por md5_kernel_match e
+ * md5_kernel_resume a partir do comprimento do lote.
+ */
+
+_Thread_local unsigned long long md5_prefilter_passes;
+
+/**
+ * Kernel escalar: 1 lane, usa a mesma compressão de md5_string
+ */
+static void md5_kernel_scalar(const uint32_t *words, size_t stride,
+                              uint32_t *state, size_t state_stride) {
+    uint32_t x[16];
+    uint32_t st[4] = {MD5_INIT_A, MD5_INIT_B, MD5_INIT_C, MD5_INIT_D};
+
+    for (int j = 0; j < 16; j++) {
+        x[j] = words[j * stride];
+    }
+    md5_compress(st, x);
+    for (int i = 0; i < 4; i++) {
+        state[i * state_stride] = st[i];
+    }
+}
+
+/**
+ * Corpos escalares das variantes de busca e incremental, com o comprimento
+ * constante (0 = genérico), como em md5_simd_kernel.h
+ */
+static inline __attribute__((always_inline))
+uint32_t md5_match_scalar_body(const uint32_t *words, size_t stride, const uint32_t start[4],
+                               const uint32_t expect[4], int last_step,
+                               uint32_t *state_out, const int len) {
+    uint32_t x[16];
+    uint32_t a = MD5_INIT_A, b = MD5_INIT_B, c = MD5_INIT_C, d = MD5_INIT_D;
+
+    if (len == 0 && start != NULL) {
+        a = start[0];
+        b = start[1];
+        c = start[2];
+        d = start[3];
+    }
+
+#pragma GCC unroll 16
+    for (int j = 0; j < 16; j++) {
+        x[j] = MD5_WORD_VARIES(j, len) ? words[j * stride] : MD5_WORD_CONST(j, len);
+    }
+
+    MD5_STEPS(MD5_STEP_RUN_UNTIL)
+reached:
+
+    if (expect == NULL) {
+        state_out[0] = a;
+        state_out[1] = b;
+        state_out[2] = c;
+        state_out[3] = d;
+        return 1;
+    }
+    if (a != expect[0]) {
+        return 0;
+    }
+    md5_prefilter_passes++;
+    return b == expect[1] && c == expect[2] && d == expect[3];
+}
+
+static inline __attribute__((always_inline))
+uint32_t md5_resume_scalar_body(const uint32_t words[16], const uint32_t start[4],
+                                int first_step, int var_word,
+                                const uint32_t *var_values,
+                                const uint32_t expect[4], int last_step,
+                                uint32_t *state_out, const int len) {
+    uint32_t x[16];
+    uint32_t a = start[0], b = start[1], c = start[2], d = start[3];
+
+#pragma GCC unroll 16
+    for (int j = 0; j < 16; j++) {
+        x[j] = MD5_WORD_VARIES(j, len) ? words[j] : MD5_WORD_CONST(j, len);
+    }
+    if (len != 0) {
+        var_word = (len - 1) / 4;
+    }
+    x[var_word] = var_values[0];
+
+    switch (first_step) {
+        MD5_STEPS(MD5_STEP_RESUME)
+    }
+reached:
+
+    if (expect == NULL) {
+        state_out[0] = a;
+        state_out[1] = b;
+        state_out[2] = c;
+        state_out[3] = d;
+        return 1;
+    }
+    if (a != expect[0]) {
+        return 0;
+    }
+    md5_prefilter_passes++;
+    return b == expect[1] && c == expect[2] && d == expect[3];
+}
+
+static uint32_t md5_match_scalar(const uint32_t *words, size_t stride, const uint32_t start[4],
+                                 const uint32_t expect[4], int last_step,
+                                 uint32_t *state_out) {
+    return md5_match_scalar_body(words, stride, start, expect, last_step, state_out, 0);
+}
+
+static uint32_t md5_resume_scalar(const uint32_t words[16], const uint32_t start[4],
+                                  int first_step, int var_word,
+                                  const uint32_t *var_values,
+                                  const uint32_t expect[4], int last_step,
+                                  uint32_t *state_out) {
+    return md5_resume_scalar_body(words, start, first_step, var_word, var_values,
+                                  expect, last_step, state_out, 0);
+}
+
+#define MD5_SCALAR_DEFINE_LEN(n) \
+    static uint32_t md5_match_scalar_len##n(const uint32_t *words, size_t stride, \
+            const uint32_t start[4], const uint32_t expect[4], int last_step, uint32_t *state_out) { \
+        return md5_match_scalar_body(words, stride, start, expect, last_step, state_out, n); \
+    } \
+    static uint32_t md5_resume_scalar_len##n(const uint32_t words[16], const uint32_t start[4], \
+            int first_step, int var_word, const uint32_t *var_values, \
+            const uint32_t expect[4], int last_step, uint32_t *state_out) { \
+        return md5_resume_scalar_body(words, start, first_step, var_word, var_values, \
+                                      expect, last_step, state_out, n); \
+    }
+#define MD5_SCALAR_MATCH_ENTRY(n) md5_match_scalar_len##n,
+#define MD5_SCALAR_RESUME_ENTRY(n) md5_resume_scalar_len##n,
+
+MD5_SPECIALIZED_LENS(MD5_SCALAR_DEFINE_LEN)
+
+static const md5_match_fn md5_match_scalar_len[MD5_SPECIALIZED_MAX + 1] = {
+    NULL, MD5_SPECIALIZED_LENS(MD5_SCALAR_MATCH_ENTRY)
+};
+static const md5_resume_fn md5_resume_scalar_len[MD5_SPECIALIZED_MAX + 1] = {
+    NULL, MD5_SPECIALIZED_LENS(MD5_SCALAR_RESUME_ENTRY)
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MD5_HAVE_X86_KERNELS 1
+
+#include <immintrin.h>
+
+typedef uint32_t md5_vec4 __attribute__((vector_size(16)));
+typedef uint32_t md5_vec8 __attribute__((vector_size(32)));
+typedef uint32_t md5_vec16 __attribute__((vector_size(64)));
+
+#define MD5_SIMD_NAME md5_kernel_sse2
+#define MD5_SIMD_MATCH md5_match_sse2
+#define MD5_SIMD_RESUME md5_resume_sse2
+#define MD5_SIMD_TARGET "sse2"
+#define MD5_SIMD_VEC md5_vec4
+#define MD5_SIMD_MASK(v) ((uint32_t)_mm_movemask_ps((__m128)(v)))
+#include "md5_simd_kernel.h"
+
+#define MD5_SIMD_NAME md5_kernel_avx2
+#define MD5_SIMD_MATCH md5_match_avx2
+#define MD5_SIMD_RESUME md5_resume_avx2
+#define MD5_SIMD_TARGET "avx2"
+#define MD5_SIMD_VEC md5_vec8
+#define MD5_SIMD_MASK(v) ((uint32_t)_mm256_movemask_ps((__m256)(v)))
+#include "md5_simd_kernel.h"
+
+#define MD5_SIMD_NAME md5_kernel_avx512
+#define MD5_SIMD_MATCH md5_match_avx512
+#define MD5_SIMD_RESUME md5_resume_avx512
+#define MD5_SIMD_TARGET "avx512f"
+#define MD5_SIMD_VEC md5_vec16
+#define MD5_SIMD_MASK(v) ((uint32_t)_mm512_test_epi32_mask((__m512i)(v), (__m512i)(v)))
+#include "md5_simd_kernel.h"
+#endif
+
+// Ordenada do mais largo para o mais estreito: o primeiro suportado vence
+static const md5_kernel_t kernels[] = {
+#ifdef MD5_HAVE_X86_KERNELS
+    {"avx512", 16, md5_kernel_avx512, md5_match_avx512, md5_resume_avx512, "avx512f",
+     md5_match_avx512_len, md5_resume_avx512_len},
+    {"avx2",    8, md5_kernel_avx2,   md5_match_avx2,   md5_resume_avx2,   "avx2",
+     md5_match_avx2_len,   md5_resume_avx2_len},
+    {"sse2",    4, md5_kernel_sse2,   md5_match_sse2,   md5_resume_sse2,   "sse2",
+     md5_match_sse2_len,   md5_resume_sse2_len},
+#endif
+    {"scalar",  1, md5_kernel_scalar, md5_match_scalar, md5_resume_scalar, NULL,
+     md5_match_scalar_len, md5_resume_scalar_len},
+    {NULL, 0, NULL, NULL, NULL, NULL, NULL, NULL}
+};
+
+static const md5_kernel_t *active_kernel = NULL;
+int md5_specialized_enabled = 1;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Verifica (via CPUID) se a CPU suporta o conjunto de instruções do kernel
+ */
+static int kernel_supported(const md5_kernel_t *kernel) {
+    if (kernel->cpu_feature == NULL) {
+        return 1;
+    }
+#ifdef MD5_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    // __builtin_cpu_supports só aceita literais, daí a comparação por nome
+    if (strcmp(kernel->cpu_feature, "avx512f") == 0) return __builtin_cpu_supports("avx512f");
+    if (strcmp(kernel->cpu_feature, "avx2") == 0) return __builtin_cpu_supports("avx2");
+    if (strcmp(kernel->cpu_feature, "sse2") == 0) return __builtin_cpu_supports("sse2");
+#endif
+    return 0;
+}
+
+const md5_kernel_t *md5_kernel_table(void) {
+    return kernels;
+}
+
+/**
+ * Procura o kernel pelo nome (sem passar pela escolha inicial)
+ */
+static int select_kernel(const char *name) {
+    for (const md5_kernel_t *k = kernels; k->name != NULL; k++) {
+        if (strcmp(k->name, name) == 0 && kernel_supported(k)) {
+            active_kernel = k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Escolha inicial (MD5_KERNEL, MD5_SPECIALIZED ou o melhor suportado): feita
+ * uma única vez, mesmo quando a primeira chamada vem de várias threads juntas
+ */
+static void kernel_init(void) {
+    const char *specialized = getenv("MD5_SPECIALIZED");
+    if (specialized != NULL && strcmp(specialized, "0") == 0) {
+        md5_specialized_enabled = 0;
+    }
+    const char *forced = getenv("MD5_KERNEL");
+    if (forced == NULL || select_kernel(forced) != 0) {
+        for (const md5_kernel_t *k = kernels; k->name != NULL; k++) {
+            if (kernel_supported(k)) {
+                active_kernel = k;
+                break;
+            }
+        }
+    }
+}
+
+const md5_kernel_t *md5_kernel_active(void) {
+    pthread_once(&kernel_once, kernel_init);
+    return active_kernel;
+}
+
+int md5_select_kernel(const char *name) {
+    pthread_once(&kernel_once, kernel_init);    // Depois da escolha inicial, para não ser sobrescrita
+    return select_kernel(name);
+}
+
+const char *md5_kernel_name(void) {
+    return md5_kernel_active()->name;
+}
+
+int md5_kernel_lanes(void) {
+    return md5_kernel_active()->lanes;
+}
+
+void md5_select_specialized(int enabled) {
+    md5_kernel_active();    // Lê MD5_SPECIALIZED antes, para não sobrescrever esta escolha
+    md5_specialized_enabled = enabled != 0;
+}
+
+int md5_kernel_specialized(int len) {
+    md5_kernel_active();
+    return md5_specialized_enabled && len >= 1 && len <= MD5_SPECIALIZED_MAX;
+}
@@ -0,0 +1,200 @@
+/**
+ * Template do kernel MD5 multi-buffer - incluído uma vez por conjunto de
+ * instruções em md5_simd.c (sem include guard de propósito).
+ *
+ * Antes de incluir, defina:
+ *   MD5_SIMD_NAME   - nome da função gerada
+ *   MD5_SIMD_TARGET - string para __attribute__((target(...)))
+ *   MD5_SIMD_MATCH  - nome da variante de busca (compara com o alvo)
+ *   MD5_SIMD_RESUME - nome da variante incremental (retoma no passo first_step)
+ *   MD5_SIMD_VEC    - tipo vetorial de 32 bits por lane (vector_size)
+ *   MD5_SIMD_MASK(v) - máscara de bits das lanes não nulas de v
+ *
+ * Cada lane do vetor processa um bloco independente; os 64 passos vêm de
+ * MD5_STEPS, os mesmos usados pela versão escalar.
+ *
+ * As variantes de busca e incremental também são geradas uma vez por
+ * comprimento 1..MD5_SPECIALIZED_MAX (MD5_SIMD_MATCH_len5...), com o
+ * comprimento constante nos corpos always_inline; MD5_SIMD_MATCH_len e
+ * MD5_SIMD_RESUME_len são as tabelas indexadas pelo comprimento.
+ */
+
+#ifndef MD5_SIMD_RETURN_MATCH
+/* Compara (a, b, c, d) com o estado esperado, testando A primeiro */
+#define MD5_SIMD_RETURN_MATCH(expect) \
+    mask = MD5_SIMD_MASK(a == (expect)[0]); \
+    if (mask == 0) { \
+        return 0; \
+    } \
+    md5_prefilter_passes += __builtin_popcount(mask); \
+    mask &= MD5_SIMD_MASK(b == (expect)[1]); \
+    mask &= MD5_SIMD_MASK(c == (expect)[2]); \
+    mask &= MD5_SIMD_MASK(d == (expect)[3]); \
+    return mask
+
+/* Sem alvo (multi-alvo): grava o estado de cada lane e devolve todas */
+#define MD5_SIMD_RETURN_STATE(out) \
+    do { \
+        const size_t lanes = sizeof(MD5_SIMD_VEC) / sizeof(uint32_t); \
+        memcpy((out) + 0 * lanes, &a, sizeof(MD5_SIMD_VEC)); \
+        memcpy((out) + 1 * lanes, &b, sizeof(MD5_SIMD_VEC)); \
+        memcpy((out) + 2 * lanes, &c, sizeof(MD5_SIMD_VEC)); \
+        memcpy((out) + 3 * lanes, &d, sizeof(MD5_SIMD_VEC)); \
+        return (uint32_t)((1ull << lanes) - 1); \
+    } while (0)
+
+/* Instancia as variantes de comprimento n a partir dos corpos */
+#define MD5_SIMD_DEFINE_LEN(n) \
+    __attribute__((target(MD5_SIMD_TARGET))) \
+    static uint32_t MD5_CAT(MD5_SIMD_MATCH, _len##n)(const uint32_t *words, size_t stride, \
+            const uint32_t start[4], const uint32_t expect[4], int last_step, uint32_t *state_out) { \
+        return MD5_CAT(MD5_SIMD_MATCH, _body)(words, stride, start, expect, last_step, state_out, n); \
+    } \
+    __attribute__((target(MD5_SIMD_TARGET))) \
+    static uint32_t MD5_CAT(MD5_SIMD_RESUME, _len##n)(const uint32_t words[16], \
+            const uint32_t start[4], int first_step, int var_word, const uint32_t *var_values, \
+            const uint32_t expect[4], int last_step, uint32_t *state_out) { \
+        return MD5_CAT(MD5_SIMD_RESUME, _body)(words, start, first_step, var_word, var_values, \
+                                               expect, last_step, state_out, n); \
+    }
+#define MD5_SIMD_MATCH_ENTRY(n) MD5_CAT(MD5_SIMD_MATCH, _len##n),
+#define MD5_SIMD_RESUME_ENTRY(n) MD5_CAT(MD5_SIMD_RESUME, _len##n),
+#endif
+
+__attribute__((target(MD5_SIMD_TARGET)))
+static void MD5_SIMD_NAME(const uint32_t *words, size_t stride,
+                          uint32_t *state, size_t state_stride) {
+    MD5_SIMD_VEC x[16];
+    MD5_SIMD_VEC a, b, c, d;
+
+    for (int j = 0; j < 16; j++) {
+        memcpy(&x[j], words + j * stride, sizeof(MD5_SIMD_VEC));
+    }
+
+    a = (MD5_SIMD_VEC){0} + MD5_INIT_A;
+    b = (MD5_SIMD_VEC){0} + MD5_INIT_B;
+    c = (MD5_SIMD_VEC){0} + MD5_INIT_C;
+    d = (MD5_SIMD_VEC){0} + MD5_INIT_D;
+
+    MD5_STEPS(MD5_STEP_RUN)
+
+    a += MD5_INIT_A;
+    b += MD5_INIT_B;
+    c += MD5_INIT_C;
+    d += MD5_INIT_D;
+
+    memcpy(state + 0 * state_stride, &a, sizeof(MD5_SIMD_VEC));
+    memcpy(state + 1 * state_stride, &b, sizeof(MD5_SIMD_VEC));
+    memcpy(state + 2 * state_stride, &c, sizeof(MD5_SIMD_VEC));
+    memcpy(state + 3 * state_stride, &d, sizeof(MD5_SIMD_VEC));
+}
+
+/* Corpo da variante de busca; len constante (0 = genérico, lê as 16 palavras) */
+__attribute__((target(MD5_SIMD_TARGET), always_inline))
+static inline uint32_t MD5_CAT(MD5_SIMD_MATCH, _body)(const uint32_t *words, size_t stride,
+                                                      const uint32_t start[4],
+                                                      const uint32_t expect[4], int last_step,
+                                                      uint32_t *state_out, const int len) {
+    MD5_SIMD_VEC x[16];
+    MD5_SIMD_VEC a, b, c, d;
+    uint32_t mask;
+
+#pragma GCC unroll 16
+    for (int j = 0; j < 16; j++) {
+        if (MD5_WORD_VARIES(j, len)) {
+            memcpy(&x[j], words + j * stride, sizeof(MD5_SIMD_VEC));
+        } else {
+            x[j] = (MD5_SIMD_VEC){0} + MD5_WORD_CONST(j, len);
+        }
+    }
+
+    // Especializadas: sempre o IV (constante dobrada nos primeiros passos)
+    if (len == 0 && start != NULL) {
+        a = (MD5_SIMD_VEC){0} + start[0];
+        b = (MD5_SIMD_VEC){0} + start[1];
+        c = (MD5_SIMD_VEC){0} + start[2];
+        d = (MD5_SIMD_VEC){0} + start[3];
+    } else {
+        a = (MD5_SIMD_VEC){0} + MD5_INIT_A;
+        b = (MD5_SIMD_VEC){0} + MD5_INIT_B;
+        c = (MD5_SIMD_VEC){0} + MD5_INIT_C;
+        d = (MD5_SIMD_VEC){0} + MD5_INIT_D;
+    }
+
+    MD5_STEPS(MD5_STEP_RUN_UNTIL)
+reached:
+    if (expect == NULL) {
+        MD5_SIMD_RETURN_STATE(state_out);
+    }
+    // Rejeição antecipada: quase sempre nenhuma lane passa da palavra A
+    MD5_SIMD_RETURN_MATCH(expect);
+}
+
+/* Corpo da variante incremental; com len constante, var_word também é */
+__attribute__((target(MD5_SIMD_TARGET), always_inline))
+static inline uint32_t MD5_CAT(MD5_SIMD_RESUME, _body)(const uint32_t words[16], const uint32_t start[4],
+                                                       int first_step, int var_word,
+                                                       const uint32_t *var_values,
+                                                       const uint32_t expect[4], int last_step,
+                                                       uint32_t *state_out, const int len) {
+    MD5_SIMD_VEC x[16];
+    MD5_SIMD_VEC a, b, c, d;
+    uint32_t mask;
+
+    // Palavras constantes replicadas em todas as lanes; só x[var_word] varia
+#pragma GCC unroll 16
+    for (int j = 0; j < 16; j++) {
+        x[j] = (MD5_SIMD_VEC){0} + (MD5_WORD_VARIES(j, len) ? words[j] : MD5_WORD_CONST(j, len));
+    }
+    if (len != 0) {
+        var_word = (len - 1) / 4;
+    }
+    memcpy(&x[var_word], var_values, sizeof(MD5_SIMD_VEC));
+
+    a = (MD5_SIMD_VEC){0} + start[0];
+    b = (MD5_SIMD_VEC){0} + start[1];
+    c = (MD5_SIMD_VEC){0} + start[2];
+    d = (MD5_SIMD_VEC){0} + start[3];
+
+    switch (first_step) {
+        MD5_STEPS(MD5_STEP_RESUME)
+    }
+reached:
+    if (expect == NULL) {
+        MD5_SIMD_RETURN_STATE(state_out);
+    }
+    MD5_SIMD_RETURN_MATCH(expect);
+}
+
+__attribute__((target(MD5_SIMD_TARGET)))
+static uint32_t MD5_SIMD_MATCH(const uint32_t *words, size_t stride, const uint32_t start[4],
+                               const uint32_t expect[4], int last_step,
+                               uint32_t *state_out) {
+    return MD5_CAT(MD5_SIMD_MATCH, _body)(words, stride, start, expect, last_step, state_out, 0);
+}
+
+__attribute__((target(MD5_SIMD_TARGET)))
+static uint32_t MD5_SIMD_RESUME(const uint32_t words[16], const uint32_t start[4],
+                                int first_step, int var_word,
+                                const uint32_t *var_values,
+                                const uint32_t expect[4], int last_step,
+                                uint32_t *state_out) {
+    return MD5_CAT(MD5_SIMD_RESUME, _body)(words, start, first_step, var_word, var_values,
+                                           expect, last_step, state_out, 0);
+}
+
+MD5_SPECIALIZED_LENS(MD5_SIMD_DEFINE_LEN)
+
+static const md5_match_fn MD5_CAT(MD5_SIMD_MATCH, _len)[MD5_SPECIALIZED_MAX + 1] = {
+    NULL, MD5_SPECIALIZED_LENS(MD5_SIMD_MATCH_ENTRY)
+};
+static const md5_resume_fn MD5_CAT(MD5_SIMD_RESUME, _len)[MD5_SPECIALIZED_MAX + 1] = {
+    NULL, MD5_SPECIALIZED_LENS(MD5_SIMD_RESUME_ENTRY)
+};
+
+#undef MD5_SIMD_NAME
+#undef MD5_SIMD_MATCH
+#undef MD5_SIMD_RESUME
+#undef MD5_SIMD_TARGET
+#undef MD5_SIMD_VEC
+#undef MD5_SIMD_MASK
@@ -0,0 +1,390 @@
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "net_proto.h"
+
+void net_msg_begin(net_msg_t *msg, uint32_t type) {
+    msg->type = type;
+    msg->len = 0;
+    msg->pos = 0;
+    msg->error = 0;
+}
+
+void net_msg_free(net_msg_t *msg) {
+    free(msg->data);
+    memset(msg, 0, sizeof(*msg));
+}
+
+/**
+ * Garante espaço para mais len bytes no payload
+ */
+static int net_reserve(net_msg_t *msg, uint32_t len) {
+    if (msg->error || len > NET_MAX_PAYLOAD - msg->len) {
+        msg->error = 1;
+        return -1;
+    }
+    if (msg->len + len <= msg->cap) {
+        return 0;
+    }
+    uint32_t cap = msg->cap > 0 ? msg->cap : 256;
+    while (cap < msg->len + len) {
+        cap *= 2;
+    }
+    uint8_t *data = realloc(msg->data, cap);
+    if (data == NULL) {
+        msg->error = 1;
+        return -1;
+    }
+    msg->data = data;
+    msg->cap = cap;
+    return 0;
+}
+
+void net_put_bytes(net_msg_t *msg, const void *data, uint32_t len) {
+    if (net_reserve(msg, len) == 0) {
+        memcpy(msg->data + msg->len, data, len);
+        msg->len += len;
+    }
+}
+
+void net_put_u32(net_msg_t *msg, uint32_t value) {
+    uint8_t bytes[4] = {value >> 24, value >> 16, value >> 8, value};
+    net_put_bytes(msg, bytes, sizeof(bytes));
+}
+
+void net_put_u64(net_msg_t *msg, uint64_t value) {
+    net_put_u32(msg, (uint32_t)(value >> 32));
+    net_put_u32(msg, (uint32_t)value);
+}
+
+void net_put_u128(net_msg_t *msg, keyspace_index_t value) {
+    net_put_u64(msg, (uint64_t)((unsigned __int128)value >> 64));
+    net_put_u64(msg, (uint64_t)value);
+}
+
+void net_put_str(net_msg_t *msg, const char *str) {
+    if (str == NULL) {
+        net_put_u32(msg, NET_STR_NULL);
+        return;
+    }
+    uint32_t len = strlen(str);
+    net_put_u32(msg, len);
+    net_put_bytes(msg, str, len);
+}
+
+void net_get_bytes(net_msg_t *msg, void *out, uint32_t len) {
+    if (msg->error || len > msg->len - msg->pos) {
+        msg->error = 1;
+        memset(out, 0, len);
+        return;
+    }
+    memcpy(out, msg->data + msg->pos, len);
+    msg->pos += len;
+}
+
+uint32_t net_get_u32(net_msg_t *msg) {
+    uint8_t b[4];
+    net_get_bytes(msg, b, sizeof(b));
+    return (uint32_t)b[0] << 24 | (uint32_t)b[1] << 16 | (uint32_t)b[2] << 8 | b[3];
+}
+
+uint64_t net_get_u64(net_msg_t *msg) {
+    uint64_t high = net_get_u32(msg);
+    return high << 32 | net_get_u32(msg);
+}
+
+keyspace_index_t net_get_u128(net_msg_t *msg) {
+    unsigned __int128 high = net_get_u64(msg);
+    return (keyspace_index_t)(high << 64 | net_get_u64(msg));
+}
+
+const char *net_get_str(net_msg_t *msg) {
+    uint32_t len = net_get_u32(msg);
+    if (msg->error || len == NET_STR_NULL) {
+        return NULL;
+    }
+    if (len > msg->len - msg->pos) {
+        msg->error = 1;
+        return NULL;
+    }
+
+    // A string volta 4 bytes, sobre o seu próprio prefixo de tamanho: sobra
+    // lugar para o '\0' sem tocar no campo seguinte
+    char *str = (char*)msg->data + msg->pos - 4;
+    memmove(str, msg->data + msg->pos, len);
+    str[len] = '\0';
+    msg->pos += len;
+    return str;
+}
+
+/**
+ * send/recv até completar len bytes
+ */
+static int net_io(int fd, void *buf, size_t len, int sending) {
+    uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = sending ? send(fd, p, len, MSG_NOSIGNAL) : recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int net_send(int fd, const net_msg_t *msg) {
+    if (msg->error) {
+        return -1;
+    }
+    uint8_t header[NET_HEADER_SIZE] = {
+        msg->type >> 24, msg->type >> 16, msg->type >> 8, msg->type,
+        msg->len >> 24, msg->len >> 16, msg->len >> 8, msg->len
+    };
+    if (net_io(fd, header, sizeof(header), 1) != 0) {
+        return -1;
+    }
+    return msg->len > 0 ? net_io(fd, msg->data, msg->len, 1) : 0;
+}
+
+int net_recv(int fd, net_msg_t *msg) {
+    uint8_t h[NET_HEADER_SIZE];
+    if (net_io(fd, h, sizeof(h), 0) != 0) {
+        return -1;
+    }
+    uint32_t type = (uint32_t)h[0] << 24 | (uint32_t)h[1] << 16 | (uint32_t)h[2] << 8 | h[3];
+    uint32_t len = (uint32_t)h[4] << 24 | (uint32_t)h[5] << 16 | (uint32_t)h[6] << 8 | h[7];
+
+    net_msg_begin(msg, type);
+    if (net_reserve(msg, len) != 0 || net_io(fd, msg->data, len, 0) != 0) {
+        return -1;
+    }
+    msg->len = len;
+    return 0;
+}
+
+void net_configure(int fd) {
+    int one = 1;
+    struct timeval timeout = {NET_IO_TIMEOUT, 0};
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));    // Detecta o outro lado morto quando ocioso
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+int net_connect(const char *host, const char *port) {
+    struct addrinfo hints, *list;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    int rc = getaddrinfo(host, port, &hints, &list);
+    if (rc != 0) {
+        errno = rc == EAI_SYSTEM ? errno : EHOSTUNREACH;
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *ai = list; ai != NULL && fd == -1; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd != -1 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            int saved = errno;
+            close(fd);
+            fd = -1;
+            errno = saved;
+        }
+    }
+    freeaddrinfo(list);
+    if (fd != -1) {
+        net_configure(fd);
+    }
+    return fd;
+}
+
+int net_listen(int port) {
+    int fd = socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1, zero = 0;
+    if (fd == -1) {
+        return -1;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));     // Aceita IPv4 também
+
+    struct sockaddr_in6 addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_any;
+    addr.sin6_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Monta o endereço de um socket Unix
+ *
+ * @return 0, ou -1 se o caminho não cabe em sun_path (ENAMETOOLONG)
+ */
+static int net_unix_addr(const char *path, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+int net_connect_unix(const char *path) {
+    struct sockaddr_un addr;
+    if (net_unix_addr(path, &addr) != 0) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    net_configure(fd);
+    return fd;
+}
+
+int net_listen_unix(const char *path) {
+    struct sockaddr_un addr;
+    if (net_unix_addr(path, &addr) != 0) {
+        return -1;
+    }
+
+    // Socket de um daemon que já terminou: ninguém atende, pode ser removido
+    int probe = net_connect_unix(path);
+    if (probe != -1) {
+        close(probe);
+        errno = EADDRINUSE;
+        return -1;
+    }
+    if (errno == ECONNREFUSED) {
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+void net_job_encode(net_msg_t *msg, const net_job_t *job) {
+    net_msg_begin(msg, NET_MSG_JOB);
+    net_put_u32(msg, job->min_len);
+    net_put_u32(msg, job->max_len);
+    net_put_u32(msg, job->threads);
+    net_put_u32(msg, (uint32_t)job->priority);
+    net_put_u32(msg, job->multi);
+    net_put_u128(msg, job->total);
+    net_put_u128(msg, job->base);
+    net_put_str(msg, job->charset);
+    net_put_str(msg, job->mask);
+    for (int k = 0; k < 4; k++) {
+        net_put_str(msg, job->custom[k]);
+    }
+    net_put_str(msg, job->wordlist);
+    net_put_str(msg, job->rules);
+    net_put_str(msg, job->markov);
+    net_put_u64(msg, job->markov_id);
+    net_put_u32(msg, job->spec);
+    net_put_u32(msg, job->algo);
+    net_put_u32(msg, job->num_targets);
+    for (int i = 0; i < job->num_targets; i++) {
+        net_put_bytes(msg, job->targets[i].digest, hash_algo_get(job->algo)->digest_len);
+        if (job->spec != MD5_SPEC_PLAIN) {
+            net_put_u32(msg, job->targets[i].salt_len);
+            net_put_bytes(msg, job->targets[i].salt, job->targets[i].salt_len);
+        }
+    }
+}
+
+int net_job_decode(net_msg_t *msg, net_job_t *job) {
+    memset(job, 0, sizeof(*job));
+    if (msg->type != NET_MSG_JOB) {
+        return -1;
+    }
+    job->min_len = net_get_u32(msg);
+    job->max_len = net_get_u32(msg);
+    job->threads = net_get_u32(msg);
+    job->priority = (int32_t)net_get_u32(msg);
+    job->multi = net_get_u32(msg);
+    job->total = net_get_u128(msg);
+    job->base = net_get_u128(msg);
+    job->charset = net_get_str(msg);
+    job->mask = net_get_str(msg);
+    for (int k = 0; k < 4; k++) {
+        job->custom[k] = net_get_str(msg);
+    }
+    job->wordlist = net_get_str(msg);
+    job->rules = net_get_str(msg);
+    job->markov = net_get_str(msg);
+    job->markov_id = net_get_u64(msg);
+    job->spec = net_get_u32(msg);
+    job->algo = net_get_u32(msg);
+    uint32_t num_targets = net_get_u32(msg);
+    if (msg->error || job->spec < MD5_SPEC_PLAIN || job->spec > MD5_SPEC_PASS_SALT ||
+        job->algo < HASH_MD5 || job->algo >= HASH_ALGO_COUNT ||
+        (job->algo != HASH_MD5 && job->spec != MD5_SPEC_PLAIN)) {
+        return -1;
+    }
+    uint32_t digest_len = hash_algo_get(job->algo)->digest_len;
+    if (num_targets < 1 || num_targets > (msg->len - msg->pos) / digest_len) {
+        return -1;
+    }
+
+    job->targets = malloc(num_targets * sizeof(md5_target_t));
+    if (job->targets == NULL) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < num_targets; i++) {
+        uint8_t digest[HASH_DIGEST_MAX];
+        net_get_bytes(msg, digest, digest_len);
+        hash_target_from_digest(job->algo, digest, &job->targets[i]);
+        if (job->spec != MD5_SPEC_PLAIN) {
+            uint32_t salt_len = net_get_u32(msg);
+            if (salt_len > MD5_SALT_MAX) {
+                msg->error = 1;
+                break;
+            }
+            job->targets[i].salt_len = (int)salt_len;
+            net_get_bytes(msg, job->targets[i].salt, salt_len);
+        }
+    }
+    if (msg->error) {
+        free(job->targets);
+        job->targets = NULL;
+        return -1;
+    }
+    job->num_targets = num_targets;
+    return 0;
+}
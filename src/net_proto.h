@@ -0,0 +1,172 @@
+#ifndef NET_PROTO_H
+#define NET_PROTO_H
+
+#include <stdint.h>
+#include "hash_utils.h"
+#include "hash_algo.h"
+#include "keyspace.h"
+
+/**
+ * Protocolo do modo distribuído (--nodes / worker --listen) - Mini-Projeto 1
+ *
+ * Cada mensagem é um cabeçalho de 8 bytes (tipo e tamanho do payload, u32
+ * big-endian) seguido do payload. Inteiros vão em big-endian; strings como
+ * u32 de tamanho + bytes (NET_STR_NULL = ausente). Índices do espaço
+ * (keyspace_index_t) vão como u128 (dois u64, o mais significativo antes);
+ * os intervalos de RANGE são posições de 64 bits a partir da base do job.
+ *
+ *   coordinator -> nó                  nó -> coordinator
+ *   JOB      parâmetros e alvos        READY     threads, espaço calculado
+ *   RANGE    início, quantidade        PROGRESS  entregue, taxa (heartbeat)
+ *   FOUND    alvo, worker, senha       DONE      verificadas, taxa
+ *   STOP                               FOUND     alvo, worker, senha
+ *                                      ERROR     mensagem
+ *
+ * O coordinator envia um RANGE por vez a cada nó e o próximo ao receber
+ * DONE; o FOUND de um nó é repassado aos outros, que param quando o último
+ * alvo é encontrado.
+ *
+ * O daemon (coordinator --daemon, daemon.h) usa as mesmas mensagens num
+ * socket Unix, uma conexão por job:
+ *
+ *   cliente -> daemon                  daemon -> cliente
+ *   JOB      parâmetros e prioridade   READY     id do job, espaço
+ *   STOP     cancela o próprio job     FOUND     alvo, worker, senha
+ *   CANCEL   id (outra conexão)        DONE      verificadas, tempo (us)
+ *                                      ERROR     mensagem
+ */
+
+#define NET_HEADER_SIZE 8
+#define NET_MAX_PAYLOAD (64u << 20)
+#define NET_STR_NULL 0xffffffffu
+#define NET_IO_TIMEOUT 10               // Segundos sem progresso numa leitura/escrita
+
+typedef enum {
+    NET_MSG_JOB = 1,
+    NET_MSG_READY,
+    NET_MSG_RANGE,
+    NET_MSG_PROGRESS,
+    NET_MSG_DONE,
+    NET_MSG_FOUND,
+    NET_MSG_STOP,
+    NET_MSG_ERROR,
+    NET_MSG_CANCEL
+} net_msg_type_t;
+
+/**
+ * Mensagem em montagem ou já recebida (o buffer é reaproveitado)
+ */
+typedef struct {
+    uint32_t type;
+    uint8_t *data;
+    uint32_t len;       // Bytes do payload
+    uint32_t cap;
+    uint32_t pos;       // Cursor de leitura
+    int error;          // Leitura além do fim ou falta de memória
+} net_msg_t;
+
+/**
+ * Parâmetros de um job, na forma enviada aos nós
+ */
+typedef struct {
+    int min_len, max_len;
+    int threads;                        // Threads por nó (daemon: máximo do pool; 0 = todas)
+    int priority;                       // Prioridade no daemon (maior primeiro)
+    int multi;                          // Conjunto de alvos (--hash-file)
+    keyspace_index_t total;             // Espaço (ou bytes da wordlist) calculado pelo coordinator
+    keyspace_index_t base;              // Posição 0 dos intervalos (keyspace_window)
+    const char *charset;                // NULL com --mask/--wordlist
+    const char *mask;
+    const char *custom[4];              // -1..-4 (KEYSPACE_CUSTOM_CHARSETS)
+    const char *wordlist;               // Caminho no nó
+    const char *rules;
+    const char *markov;                 // Modelo da ordem por probabilidade (caminho no nó)
+    unsigned long long markov_id;       // markov_model_t.id no coordinator
+    int spec;                           // md5_spec_t (--hash-spec): com sal, cada alvo leva o seu
+    int algo;                           // hash_algo_id_t (--algo): digests de digest_len bytes
+    int num_targets;
+    md5_target_t *targets;              // No nó: alocado por net_job_decode (liberar com free)
+} net_job_t;
+
+void net_msg_begin(net_msg_t *msg, uint32_t type);
+void net_msg_free(net_msg_t *msg);
+
+void net_put_u32(net_msg_t *msg, uint32_t value);
+void net_put_u64(net_msg_t *msg, uint64_t value);
+void net_put_u128(net_msg_t *msg, keyspace_index_t value);
+void net_put_str(net_msg_t *msg, const char *str);
+void net_put_bytes(net_msg_t *msg, const void *data, uint32_t len);
+
+uint32_t net_get_u32(net_msg_t *msg);
+uint64_t net_get_u64(net_msg_t *msg);
+keyspace_index_t net_get_u128(net_msg_t *msg);
+/**
+ * @return String terminada em '\0' dentro do buffer da mensagem (válida até
+ *         o próximo net_recv), ou NULL se ausente
+ */
+const char *net_get_str(net_msg_t *msg);
+void net_get_bytes(net_msg_t *msg, void *out, uint32_t len);
+
+/**
+ * Envia a mensagem inteira (sem SIGPIPE se o outro lado fechou)
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int net_send(int fd, const net_msg_t *msg);
+
+/**
+ * Recebe uma mensagem inteira
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro, conexão fechada ou
+ *         mensagem grande demais
+ */
+int net_recv(int fd, net_msg_t *msg);
+
+/**
+ * Conecta a host:port (TCP_NODELAY e timeout de NET_IO_TIMEOUT)
+ *
+ * @return Descritor conectado, ou -1 (errno preservado)
+ */
+int net_connect(const char *host, const char *port);
+
+/**
+ * Abre um socket TCP escutando em todas as interfaces
+ *
+ * @return Descritor, ou -1 (errno preservado)
+ */
+int net_listen(int port);
+
+/**
+ * Conecta ao socket Unix em path (timeout de NET_IO_TIMEOUT)
+ *
+ * @return Descritor conectado, ou -1 (errno preservado)
+ */
+int net_connect_unix(const char *path);
+
+/**
+ * Cria o socket Unix em path, escutando (um socket antigo no mesmo caminho
+ * é removido se ninguém mais o atende)
+ *
+ * @return Descritor, ou -1 (errno preservado; EADDRINUSE se outro processo
+ *         já atende em path)
+ */
+int net_listen_unix(const char *path);
+
+/**
+ * Prepara um socket (TCP_NODELAY, keepalive e timeout de NET_IO_TIMEOUT)
+ */
+void net_configure(int fd);
+
+/**
+ * Monta a mensagem JOB
+ */
+void net_job_encode(net_msg_t *msg, const net_job_t *job);
+
+/**
+ * Lê uma mensagem JOB (as strings apontam para o buffer de msg)
+ *
+ * @return 0 em caso de sucesso, -1 se a mensagem é inválida
+ */
+int net_job_decode(net_msg_t *msg, net_job_t *job);
+
+#endif // NET_PROTO_H
@@ -0,0 +1,291 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "node.h"
+#include "net_proto.h"
+#include "thread_engine.h"
+#include "remote_job.h"
+
+/**
+ * Estado de uma conexão com o coordinator (uma por vez: keyspace_t não
+ * pode ser copiado, então a sessão é estática)
+ */
+typedef struct {
+    remote_job_t rj;            // Job, espaço de busca e região local
+    int wake_fd;                // eventfd: as threads terminaram o intervalo
+    int threads;
+    unsigned char *sent;        // Senhas já enviadas ao coordinator (por alvo)
+} node_session_t;
+
+static node_session_t session;
+
+/**
+ * Envia ERROR ao coordinator e registra localmente
+ */
+static void node_error(int fd, const char *message) {
+    net_msg_t msg = {0};
+    fprintf(stderr, "Nó: %s\n", message);
+    net_msg_begin(&msg, NET_MSG_ERROR);
+    net_put_str(&msg, message);
+    net_send(fd, &msg);
+    net_msg_free(&msg);
+}
+
+/**
+ * Recebe o job e monta espaço de busca, alvos e região local
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro (já avisado ao coordinator)
+ */
+static int node_setup(node_session_t *s, int fd) {
+    remote_job_t *rj = &s->rj;
+    net_job_t *p = &rj->params;
+    char message[256];
+
+    if (net_recv(fd, &rj->msg) != 0) {
+        node_error(fd, "job inválido");
+        return -1;
+    }
+    if (remote_job_open(rj, message, sizeof(message)) != 0) {
+        node_error(fd, message);
+        return -1;
+    }
+
+    s->threads = p->threads > 0 ? p->threads : thread_engine_online_cpus();
+    if (s->threads > THREAD_ENGINE_MAX_THREADS) {
+        s->threads = THREAD_ENGINE_MAX_THREADS;
+    }
+    s->sent = calloc(p->num_targets, 1);
+    s->wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (s->sent == NULL || s->wake_fd == -1) {
+        node_error(fd, "sem memória para o estado do job");
+        return -1;
+    }
+
+    net_msg_t ready = {0};
+    net_msg_begin(&ready, NET_MSG_READY);
+    net_put_u32(&ready, s->threads);
+    net_put_u128(&ready, rj->space);
+    int rc = net_send(fd, &ready);
+    net_msg_free(&ready);
+    char space_str[KEYSPACE_INDEX_DIGITS];
+    LOG(LOG_NORMAL, "Nó: job recebido (%d alvo(s), espaço %s, %d threads)\n",
+        p->num_targets, keyspace_index_format(rj->space, space_str), s->threads);
+    return rc;
+}
+
+static void node_teardown(node_session_t *s) {
+    remote_job_close(&s->rj);
+    if (s->wake_fd > 0) {
+        close(s->wake_fd);
+    }
+    free(s->sent);
+    memset(s, 0, sizeof(*s));
+}
+
+/**
+ * Envia as senhas encontradas localmente que o coordinator ainda não conhece
+ */
+static int node_report_cracks(node_session_t *s, int fd, net_msg_t *msg) {
+    for (int i = 0; i < s->rj.params.num_targets; i++) {
+        const shared_crack_t *crack = &s->rj.shared->cracks[i];
+        if (s->sent[i] || !atomic_load_explicit(&crack->ready, memory_order_acquire)) {
+            continue;
+        }
+        s->sent[i] = 1;
+        net_msg_begin(msg, NET_MSG_FOUND);
+        net_put_u32(msg, i);
+        net_put_u32(msg, crack->worker_id);
+        net_put_str(msg, crack->password);
+        if (net_send(fd, msg) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Senha encontrada por outro nó: publicada aqui (sem reenviar) para que a
+ * busca pare quando não restar alvo
+ */
+static void node_accept_crack(node_session_t *s, net_msg_t *msg) {
+    int target = remote_job_accept_crack(&s->rj, msg);
+    if (target >= 0) {
+        s->sent[target] = 1;
+    }
+}
+
+typedef struct {
+    const search_job_t *job;
+    int threads;
+    int wake_fd;
+    atomic_int finished;
+} node_runner_t;
+
+static void *node_runner_main(void *arg) {
+    node_runner_t *runner = arg;
+    uint64_t one = 1;
+    thread_engine_run(runner->job, runner->threads);
+    atomic_store(&runner->finished, 1);
+    // Acorda o poll da thread principal: o DONE sai sem esperar NODE_POLL_MS
+    if (write(runner->wake_fd, &one, sizeof(one)) != sizeof(one)) {
+        perror("Erro ao sinalizar fim do intervalo");
+    }
+    return NULL;
+}
+
+/**
+ * Percorre um intervalo com as threads enquanto atende o socket
+ *
+ * @return 0 para seguir na sessão, -1 se o coordinator mandou parar ou caiu
+ */
+static int node_run_range(node_session_t *s, int fd, net_msg_t *msg, long long start, long long count) {
+    scheduler_t *sched = &s->rj.shared->sched;
+    node_runner_t runner = {.job = &s->rj.job, .threads = s->threads, .wake_fd = s->wake_fd};
+    pthread_t tid;
+    int status = 0;
+
+    scheduler_init(sched, start, count, s->threads);
+    double begin = progress_now();
+    double next_heartbeat = begin + NODE_HEARTBEAT;
+    if (pthread_create(&tid, NULL, node_runner_main, &runner) != 0) {
+        node_error(fd, "não foi possível criar as threads");
+        return -1;
+    }
+
+    while (!atomic_load(&runner.finished)) {
+        struct pollfd pfd[2] = {{.fd = fd, .events = POLLIN}, {.fd = s->wake_fd, .events = POLLIN}};
+        if (poll(pfd, 2, NODE_POLL_MS) > 0 && pfd[0].revents != 0) {
+            if (net_recv(fd, msg) != 0 || msg->type == NET_MSG_STOP) {
+                status = -1;
+                break;
+            }
+            if (msg->type == NET_MSG_FOUND) {
+                node_accept_crack(s, msg);
+            }
+        }
+        if (node_report_cracks(s, fd, msg) != 0) {
+            status = -1;
+            break;
+        }
+
+        // Heartbeat: o que já foi entregue às threads e a taxa medida até agora
+        double now = progress_now();
+        if (now >= next_heartbeat) {
+            long long claimed = atomic_load(&sched->cursor) - start;
+            net_msg_begin(msg, NET_MSG_PROGRESS);
+            net_put_u64(msg, claimed);
+            net_put_u64(msg, (uint64_t)(claimed / (now - begin)));
+            if (net_send(fd, msg) != 0) {
+                status = -1;
+                break;
+            }
+            next_heartbeat = now + NODE_HEARTBEAT;
+        }
+    }
+
+    if (status != 0) {
+        atomic_store(&s->rj.shared->done, 1);
+    }
+    pthread_join(tid, NULL);
+    uint64_t wakes;
+    if (read(s->wake_fd, &wakes, sizeof(wakes)) != sizeof(wakes)) {
+        perror("Erro ao ler fim do intervalo");
+    }
+    if (status != 0) {
+        return -1;
+    }
+
+    // Depois do join, as estatísticas das threads podem ser lidas sem corrida
+    long long checked = 0;
+    for (int i = 0; i < s->threads; i++) {
+        checked += sched->workers[i].checked;
+    }
+    double elapsed = progress_now() - begin;
+    if (node_report_cracks(s, fd, msg) != 0) {
+        return -1;
+    }
+    net_msg_begin(msg, NET_MSG_DONE);
+    net_put_u64(msg, checked);
+    net_put_u64(msg, elapsed > 0 ? (uint64_t)(checked / elapsed) : 0);
+    LOG(LOG_VERBOSE, "Nó: intervalo %lld + %lld concluído em %.2f s\n", start, count, elapsed);
+    return net_send(fd, msg);
+}
+
+/**
+ * Atende um coordinator até STOP ou até a conexão cair
+ */
+static void node_session(int fd) {
+    node_session_t *s = &session;
+    net_msg_t msg = {0};
+
+    if (node_setup(s, fd) == 0) {
+        for (;;) {
+            // Ocioso entre intervalos: espera sem timeout (o de leitura vale só
+            // dentro de uma mensagem)
+            struct pollfd pfd = {.fd = fd, .events = POLLIN};
+            if (poll(&pfd, 1, -1) < 0 && errno == EINTR) {
+                continue;
+            }
+            if (net_recv(fd, &msg) != 0 || msg.type == NET_MSG_STOP) {
+                break;
+            }
+            if (msg.type == NET_MSG_FOUND) {
+                node_accept_crack(s, &msg);
+            } else if (msg.type == NET_MSG_RANGE) {
+                long long start = net_get_u64(&msg);
+                long long count = net_get_u64(&msg);
+                if (msg.error || start < 0 || count < 1 || count > s->rj.window - start) {
+                    node_error(fd, "intervalo inválido");
+                    break;
+                }
+                if (node_run_range(s, fd, &msg, start, count) != 0) {
+                    break;
+                }
+            }
+        }
+    }
+    net_msg_free(&msg);
+    node_teardown(s);
+}
+
+int node_serve(int port) {
+    int listen_fd = net_listen(port);
+    if (listen_fd == -1) {
+        perror("Erro ao abrir a porta do nó");
+        return 1;
+    }
+    LOG(LOG_NORMAL, "Nó escutando na porta %d (kernel %s)\n", port, md5_kernel_name());
+    fflush(stdout);
+
+    for (;;) {
+        struct sockaddr_storage peer;
+        socklen_t peer_len = sizeof(peer);
+        int fd = accept4(listen_fd, (struct sockaddr*)&peer, &peer_len, SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno != EINTR) {
+                perror("Erro ao aceitar conexão");
+            }
+            continue;
+        }
+        net_configure(fd);
+
+        char host[INET6_ADDRSTRLEN] = "?";
+        if (peer.ss_family == AF_INET6) {
+            inet_ntop(AF_INET6, &((struct sockaddr_in6*)&peer)->sin6_addr, host, sizeof(host));
+        }
+        LOG(LOG_NORMAL, "Nó: coordinator conectado (%s)\n", host);
+        fflush(stdout);
+        node_session(fd);
+        close(fd);
+        LOG(LOG_NORMAL, "Nó: conexão encerrada\n");
+        fflush(stdout);
+    }
+}
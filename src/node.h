@@ -0,0 +1,31 @@
+#ifndef NODE_H
+#define NODE_H
+
+/**
+ * Nó do modo distribuído (worker --listen <porta>) - Mini-Projeto 1
+ *
+ * Daemon que atende um coordinator por vez (coordinator --nodes). Para cada
+ * conexão: recebe o job (net_proto.h), monta o espaço de busca localmente
+ * (a wordlist, se houver, deve existir no mesmo caminho no nó) e confere
+ * que o total bate com o do coordinator. Cada RANGE recebido é percorrido
+ * pelo motor de threads (thread_engine.h) com o escalonador dinâmico local
+ * carregado nesse intervalo.
+ *
+ * Enquanto as threads trabalham, a thread principal atende o socket: envia
+ * um heartbeat (PROGRESS, com a taxa medida) a cada NODE_HEARTBEAT segundos
+ * e cada senha assim que aparece; um FOUND repassado pelo coordinator é
+ * publicado na região local (e para a busca se era o último alvo), e STOP ou
+ * a queda da conexão param as threads.
+ */
+
+#define NODE_HEARTBEAT 1.0          // Segundos entre heartbeats
+#define NODE_POLL_MS 100            // Latência de envio das senhas encontradas
+
+/**
+ * Atende coordinators na porta indicada, um de cada vez, indefinidamente
+ *
+ * @return 1 se a porta não pôde ser aberta (só retorna em caso de erro)
+ */
+int node_serve(int port);
+
+#endif // NODE_H
@@ -0,0 +1,511 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "potfile.h"
+#include "hash_algo.h"
+
+#define POTFILE_LINE_MAX 1024       // Formato + digest + sal + senha em $HEX[], com folga
+
+/**
+ * Campos de uma linha do log
+ */
+typedef struct {
+    const char *format;
+    size_t format_len;
+    uint8_t digest[HASH_DIGEST_MAX];
+    int digest_len;
+    uint8_t salt[MD5_SALT_MAX];
+    int salt_len;
+    char password[MD5_SINGLE_BLOCK_MAX + 1];
+} potfile_line_t;
+
+/**
+ * Nome do formato na primeira coluna: o do --hash-spec com sal, senão o do --algo
+ */
+static const char *potfile_format(int algo, int spec) {
+    return spec != MD5_SPEC_PLAIN ? md5_spec_name(spec) : hash_algo_get(algo)->name;
+}
+
+/**
+ * Chave do índice: 8 primeiros bytes do digest, em big-endian (mesma ordem dos bytes)
+ */
+static uint64_t potfile_key(const uint8_t *digest) {
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++) {
+        key = key << 8 | digest[i];
+    }
+    return key;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * Decodifica len caracteres hexadecimais
+ *
+ * @return Número de bytes, ou -1 se o texto é inválido ou passa de max bytes
+ */
+static int decode_hex(const char *hex, size_t len, uint8_t *out, size_t max) {
+    if (len % 2 != 0 || len / 2 > max) {
+        return -1;
+    }
+    for (size_t i = 0; i < len / 2; i++) {
+        int hi = hex_value(hex[2 * i]), lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return -1;
+        }
+        out[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return (int)(len / 2);
+}
+
+static void encode_hex(const uint8_t *data, size_t len, char *out) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0xf];
+    }
+}
+
+/**
+ * Separa os campos de uma linha do log (sem o '\n')
+ *
+ * @return 0 em caso de sucesso, -1 se a linha não é válida
+ */
+static int potfile_parse_line(const char *line, size_t len, potfile_line_t *out) {
+    const char *end = line + len;
+    const char *digest_hex = memchr(line, ':', len);
+    if (digest_hex == NULL) {
+        return -1;
+    }
+    out->format = line;
+    out->format_len = digest_hex - line;
+    digest_hex++;
+
+    const char *salt_hex = memchr(digest_hex, ':', end - digest_hex);
+    if (salt_hex == NULL) {
+        return -1;
+    }
+    out->digest_len = decode_hex(digest_hex, salt_hex - digest_hex, out->digest, HASH_DIGEST_MAX);
+    salt_hex++;
+
+    const char *password = memchr(salt_hex, ':', end - salt_hex);
+    if (password == NULL || out->digest_len < 8) {
+        return -1;
+    }
+    out->salt_len = decode_hex(salt_hex, password - salt_hex, out->salt, MD5_SALT_MAX);
+    password++;
+
+    // Senha até o fim da linha, ou $HEX[...] para os caracteres que o log não guarda
+    size_t password_len = end - password;
+    if (password_len >= 6 && memcmp(password, "$HEX[", 5) == 0 && end[-1] == ']') {
+        int n = decode_hex(password + 5, password_len - 6, (uint8_t*)out->password, MD5_SINGLE_BLOCK_MAX);
+        if (n < 0) {
+            return -1;
+        }
+        password_len = n;
+    } else if (password_len <= MD5_SINGLE_BLOCK_MAX) {
+        memcpy(out->password, password, password_len);
+    } else {
+        return -1;
+    }
+    out->password[password_len] = '\0';
+    return out->salt_len < 0 ? -1 : 0;
+}
+
+/**
+ * Confere a senha de uma linha recalculando o hash do alvo: uma linha com a
+ * senha errada (editada à mão, de outra ferramenta) nunca vale como resposta
+ */
+static int potfile_verify(int algo, int spec, const md5_target_t *target, const char *password) {
+    if (spec != MD5_SPEC_PLAIN) {
+        char computed[33], expected[33];
+        md5_spec_string(spec, target, password, computed);
+        md5_digest_to_hex(target->digest, expected);
+        return strcmp(computed, expected) == 0;
+    }
+    uint8_t digest[HASH_DIGEST_MAX];
+    hash_digest(algo, password, strlen(password), digest);
+    return memcmp(digest, target->digest, hash_algo_get(algo)->digest_len) == 0;
+}
+
+static int entry_compare(const void *a, const void *b) {
+    const potfile_entry_t *x = a, *y = b;
+    if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    return x->offset < y->offset ? -1 : x->offset > y->offset;
+}
+
+/**
+ * Mapeia o índice se ele é deste log (mesmo inode, até no máximo log_size)
+ *
+ * @return 0 se mapeou (header preenchido), -1 se não existe ou não vale
+ */
+static int potfile_map_index(potfile_t *pot, const char *idx_path, uint64_t ino,
+                             potfile_header_t *header) {
+    struct stat st;
+    int fd = open(idx_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*header) ||
+        pread(fd, header, sizeof(*header), 0) != (ssize_t)sizeof(*header) ||
+        memcmp(header->magic, POTFILE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != POTFILE_VERSION || header->log_ino != ino ||
+        header->log_size > pot->log_size ||
+        header->count != (st.st_size - sizeof(*header)) / sizeof(potfile_entry_t)) {
+        close(fd);
+        return -1;
+    }
+    pot->map_size = st.st_size;
+    pot->map = mmap(NULL, pot->map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pot->map == MAP_FAILED) {
+        pot->map = NULL;
+        return -1;
+    }
+    pot->entries = (const potfile_entry_t*)((const char*)pot->map + sizeof(*header));
+    pot->count = header->count;
+    // Consultas aleatórias: sem leitura antecipada de páginas vizinhas
+    madvise(pot->map, pot->map_size, MADV_RANDOM);
+    return 0;
+}
+
+/**
+ * Indexa as linhas completas do log a partir de from (ordenadas por chave)
+ *
+ * @param end Saída: fim da última linha completa
+ * @return Número de entradas em *fresh, ou -1 se faltar memória
+ */
+static long long potfile_scan(const potfile_t *pot, size_t from, size_t *end,
+                              potfile_entry_t **fresh) {
+    long long count = 0, capacity = 0;
+    size_t pos = from;
+
+    *fresh = NULL;
+    while (pos < pot->log_size) {
+        const char *line = pot->log + pos;
+        const char *nl = memchr(line, '\n', pot->log_size - pos);
+        if (nl == NULL) {
+            break;      // Linha ainda sendo escrita (ou interrompida): fica para a próxima
+        }
+        potfile_line_t parsed;
+        if (potfile_parse_line(line, nl - line, &parsed) == 0) {
+            if (count == capacity) {
+                capacity = capacity == 0 ? 1024 : 2 * capacity;
+                potfile_entry_t *grown = realloc(*fresh, capacity * sizeof(potfile_entry_t));
+                if (grown == NULL) {
+                    free(*fresh);
+                    *fresh = NULL;
+                    return -1;
+                }
+                *fresh = grown;
+            }
+            (*fresh)[count++] = (potfile_entry_t){potfile_key(parsed.digest), pos};
+        }
+        pos = nl + 1 - pot->log;
+    }
+    *end = pos;
+    if (count > 0) {
+        qsort(*fresh, count, sizeof(potfile_entry_t), entry_compare);
+    }
+    return count;
+}
+
+static int write_all(int fd, const void *data, size_t len) {
+    const char *p = data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/**
+ * Grava o índice: entradas antigas (mapeadas) intercaladas com as novas
+ *
+ * O índice é só um cache do log: sem fsync, e um índice perdido numa queda
+ * é refeito na próxima abertura.
+ */
+static int potfile_write_index(const potfile_t *pot, const char *idx_path, uint64_t ino,
+                               size_t log_end, const potfile_entry_t *fresh, long long fresh_count) {
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", idx_path) >= (int)sizeof(tmp)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    long long total = pot->count + fresh_count;
+    potfile_entry_t *merged = malloc((total > 0 ? total : 1) * sizeof(potfile_entry_t));
+    if (merged == NULL) {
+        return -1;
+    }
+    long long i = 0, j = 0, k = 0;
+    while (i < pot->count || j < fresh_count) {
+        if (j == fresh_count || (i < pot->count && entry_compare(&pot->entries[i], &fresh[j]) <= 0)) {
+            merged[k++] = pot->entries[i++];
+        } else {
+            merged[k++] = fresh[j++];
+        }
+    }
+
+    potfile_header_t header = {.version = POTFILE_VERSION, .log_ino = ino, .log_size = log_end,
+                               .count = (uint64_t)total};
+    memcpy(header.magic, POTFILE_MAGIC, sizeof(header.magic));
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    int failed = fd == -1 ||
+                 write_all(fd, &header, sizeof(header)) != 0 ||
+                 write_all(fd, merged, total * sizeof(potfile_entry_t)) != 0;
+    int saved = errno;
+    free(merged);
+    if (fd != -1 && close(fd) != 0 && !failed) {
+        failed = 1;
+        saved = errno;
+    }
+    if (failed || rename(tmp, idx_path) != 0) {
+        saved = failed ? saved : errno;
+        unlink(tmp);
+        errno = saved;
+        return -1;
+    }
+    return 0;
+}
+
+int potfile_open(potfile_t *pot, const char *path) {
+    struct stat st;
+    char idx_path[4096];
+
+    memset(pot, 0, sizeof(*pot));
+    if (snprintf(idx_path, sizeof(idx_path), "%s.idx", path) >= (int)sizeof(idx_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    pot->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (pot->fd == -1) {
+        return -1;
+    }
+
+    // Um coordinator por vez atualiza o índice (os acréscimos também esperam)
+    while (flock(pot->fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            goto fail;
+        }
+    }
+    if (fstat(pot->fd, &st) != 0) {
+        goto fail;
+    }
+    pot->log_size = st.st_size;
+    if (pot->log_size > 0) {
+        pot->log = mmap(NULL, pot->log_size, PROT_READ, MAP_SHARED, pot->fd, 0);
+        if (pot->log == MAP_FAILED) {
+            pot->log = NULL;
+            goto fail;
+        }
+    }
+
+    // Índice do mesmo log: só o trecho acrescentado depois dele é lido
+    potfile_header_t header;
+    size_t from = 0;
+    if (potfile_map_index(pot, idx_path, st.st_ino, &header) == 0) {
+        from = header.log_size;
+    }
+    potfile_entry_t *fresh;
+    size_t log_end;
+    long long fresh_count = potfile_scan(pot, from, &log_end, &fresh);
+    if (fresh_count < 0) {
+        errno = ENOMEM;
+        goto fail;
+    }
+    if (pot->map == NULL || log_end != from) {
+        int rc = potfile_write_index(pot, idx_path, st.st_ino, log_end, fresh, fresh_count);
+        free(fresh);
+        if (rc != 0) {
+            goto fail;
+        }
+        if (pot->map != NULL) {
+            munmap(pot->map, pot->map_size);
+            pot->map = NULL;
+        }
+        if (potfile_map_index(pot, idx_path, st.st_ino, &header) != 0) {
+            errno = EIO;
+            goto fail;
+        }
+        pot->indexed = fresh_count;
+    } else {
+        free(fresh);
+    }
+    flock(pot->fd, LOCK_UN);
+    return 0;
+
+fail:;
+    int saved = errno;
+    potfile_close(pot);
+    errno = saved;
+    return -1;
+}
+
+int potfile_find(const potfile_t *pot, int algo, int spec, const md5_target_t *target,
+                 char password[MD5_SINGLE_BLOCK_MAX + 1]) {
+    const char *format = potfile_format(algo, spec);
+    size_t format_len = strlen(format);
+    int digest_len = hash_algo_get(algo)->digest_len;
+    uint64_t key = potfile_key(target->digest);
+    long long lo = 0, hi = pot->count;
+
+    // Primeira entrada com a chave; as seguintes com a mesma chave vêm em sequência
+    while (lo < hi) {
+        long long mid = lo + (hi - lo) / 2;
+        if (pot->entries[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    // A chave tem só 8 bytes e não inclui formato nem sal: conferir a linha inteira
+    // e a senha (se não confere, as outras entradas com a mesma chave ainda valem)
+    for (long long i = lo; i < pot->count && pot->entries[i].key == key; i++) {
+        size_t offset = pot->entries[i].offset;
+        const char *nl = offset < pot->log_size ? memchr(pot->log + offset, '\n', pot->log_size - offset)
+                                                 : NULL;
+        potfile_line_t line;
+        if (nl == NULL || potfile_parse_line(pot->log + offset, nl - (pot->log + offset), &line) != 0) {
+            continue;
+        }
+        if (line.format_len == format_len && memcmp(line.format, format, format_len) == 0 &&
+            line.digest_len == digest_len && memcmp(line.digest, target->digest, digest_len) == 0 &&
+            line.salt_len == target->salt_len && memcmp(line.salt, target->salt, line.salt_len) == 0 &&
+            potfile_verify(algo, spec, target, line.password)) {
+            strcpy(password, line.password);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int potfile_filter(const potfile_t *pot, int algo, int spec, md5_target_t *targets, int *count,
+                   potfile_hit_t **known) {
+    int found = 0, kept = 0;
+
+    *known = NULL;
+    for (int i = 0; i < *count; i++) {
+        char password[MD5_SINGLE_BLOCK_MAX + 1];
+        if (!potfile_find(pot, algo, spec, &targets[i], password)) {
+            targets[kept++] = targets[i];
+            continue;
+        }
+        if (*known == NULL && (*known = malloc(*count * sizeof(potfile_hit_t))) == NULL) {
+            return -1;
+        }
+        (*known)[found].target = targets[i];
+        strcpy((*known)[found].password, password);
+        found++;
+    }
+    *count = kept;
+    return found;
+}
+
+/**
+ * Descarta os bytes depois do último '\n' do log (uma linha interrompida por
+ * uma queda no meio do write): completada, ela viraria uma linha válida com
+ * a senha truncada. Chamada sob flock, quando nenhuma linha está sendo escrita.
+ */
+static int potfile_drop_torn(int fd) {
+    struct stat st;
+    char buf[POTFILE_LINE_MAX];
+
+    if (fstat(fd, &st) != 0) {
+        return -1;
+    }
+    off_t end = st.st_size;
+    while (end > 0) {
+        size_t n = end < (off_t)sizeof(buf) ? (size_t)end : sizeof(buf);
+        if (pread(fd, buf, n, end - n) != (ssize_t)n) {
+            return -1;
+        }
+        const char *nl = memrchr(buf, '\n', n);
+        if (nl != NULL) {
+            end = end - n + (nl - buf) + 1;
+            break;
+        }
+        end -= n;
+    }
+    return end == st.st_size ? 0 : ftruncate(fd, end);
+}
+
+int potfile_append(potfile_t *pot, int algo, int spec, const md5_target_t *target,
+                   const char *password) {
+    char line[POTFILE_LINE_MAX];
+    const char *format = potfile_format(algo, spec);
+    size_t password_len = strlen(password);
+    int n = snprintf(line, sizeof(line), "%s:", format);
+
+    encode_hex(target->digest, hash_algo_get(algo)->digest_len, line + n);
+    n += 2 * hash_algo_get(algo)->digest_len;
+    line[n++] = ':';
+    encode_hex(target->salt, target->salt_len, line + n);
+    n += 2 * target->salt_len;
+    line[n++] = ':';
+    if (strpbrk(password, "\n\r") != NULL || strncmp(password, "$HEX[", 5) == 0) {
+        memcpy(line + n, "$HEX[", 5);
+        encode_hex((const uint8_t*)password, password_len, line + n + 5);
+        n += 5 + 2 * password_len;
+        line[n++] = ']';
+    } else {
+        memcpy(line + n, password, password_len);
+        n += password_len;
+    }
+    line[n++] = '\n';
+
+    while (flock(pot->fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+    // O_APPEND: a linha inteira vai para o fim atual do arquivo num único write()
+    int rc = potfile_drop_torn(pot->fd);
+    if (rc == 0) {
+        rc = write_all(pot->fd, line, n);
+    }
+    int saved = errno;
+    flock(pot->fd, LOCK_UN);
+    errno = saved;
+    return rc;
+}
+
+void potfile_close(potfile_t *pot) {
+    if (pot->map != NULL) {
+        munmap(pot->map, pot->map_size);
+    }
+    if (pot->log != NULL) {
+        munmap((void*)pot->log, pot->log_size);
+    }
+    if (pot->fd != -1) {
+        close(pot->fd);
+    }
+    memset(pot, 0, sizeof(*pot));
+    pot->fd = -1;
+}
@@ -0,0 +1,113 @@
+#ifndef POTFILE_H
+#define POTFILE_H
+
+#include <stdint.h>
+#include "hash_utils.h"
+
+/**
+ * Potfile: senhas já quebradas em execuções anteriores (--potfile) - Mini-Projeto 1
+ *
+ * O log é um arquivo de texto só de acréscimos, uma senha por linha:
+ *
+ *   <formato>:<hash em hex>:<sal em hex>:<senha>
+ *
+ * O formato é o nome do --algo ("md5", "sha1"...) ou, com sal, o do
+ * --hash-spec ("md5(salt.pass)"); o sal fica vazio quando não há. A senha
+ * vai até o fim da linha (pode conter ':'); uma senha com '\n', '\r' ou que
+ * comece com "$HEX[" é gravada como $HEX[<bytes em hex>].
+ *
+ * Ao lado do log, <potfile>.idx é um índice ordenado pelos 8 primeiros
+ * bytes do digest, mapeado em memória e consultado por busca binária; cada
+ * entrada aponta para a sua linha no log, que é relida e conferida inteira
+ * (formato, digest e sal), e a senha é recalculada antes de ser aceita.
+ * Formato do índice:
+ *
+ *   potfile_header_t          magic, versão, bytes do log já indexados
+ *   potfile_entry_t[count]    ordenadas por key
+ *
+ * Novas senhas são acrescentadas ao log com O_APPEND, uma linha por write()
+ * e sob flock: vários coordinators podem gravar no mesmo potfile. Bytes sem
+ * '\n' no fim do log (uma linha interrompida por uma queda) são descartados
+ * com ftruncate antes do acréscimo, nunca completados. O índice
+ * não muda a cada acréscimo; ao abrir o potfile, as linhas depois do trecho
+ * indexado são lidas, ordenadas e intercaladas com as entradas antigas, e o
+ * novo índice substitui o anterior por rename. Se o log encolheu ou foi
+ * trocado, o índice é refeito do zero.
+ */
+
+#define POTFILE_MAGIC "QSPOTX\0\1"
+#define POTFILE_VERSION 1
+
+typedef struct {
+    uint64_t key;       // 8 primeiros bytes do digest (big-endian)
+    uint64_t offset;    // Início da linha no log
+} potfile_entry_t;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t log_ino;   // Inode do log indexado (log trocado = índice inválido)
+    uint64_t log_size;  // Bytes do log cobertos (sempre fim de uma linha)
+    uint64_t count;     // Entradas
+} potfile_header_t;
+
+/**
+ * Potfile aberto: log para acréscimos e consulta, índice mapeado
+ */
+typedef struct {
+    int fd;                     // Log (O_APPEND)
+    const char *log;            // Log mapeado até log_size (NULL se vazio)
+    size_t log_size;
+    void *map;                  // Índice mapeado (NULL se vazio)
+    size_t map_size;
+    const potfile_entry_t *entries;
+    long long count;
+    long long indexed;          // Linhas novas indexadas nesta abertura
+} potfile_t;
+
+/**
+ * Um alvo encontrado no potfile
+ */
+typedef struct {
+    md5_target_t target;
+    char password[MD5_SINGLE_BLOCK_MAX + 1];
+} potfile_hit_t;
+
+/**
+ * Abre (ou cria) o log em path e atualiza o índice path.idx
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro (errno preservado)
+ */
+int potfile_open(potfile_t *pot, const char *path);
+
+/**
+ * Procura a senha de um alvo do algoritmo (hash_algo_id_t) e formato
+ * (md5_spec_t); só vale uma linha cuja senha gera de fato o hash do alvo
+ *
+ * @return 1 se encontrou (senha conferida), 0 se não
+ */
+int potfile_find(const potfile_t *pot, int algo, int spec, const md5_target_t *target,
+                 char password[MD5_SINGLE_BLOCK_MAX + 1]);
+
+/**
+ * Tira de targets os alvos que já estão no potfile (os demais mantêm a
+ * ordem e *count diminui) e os devolve em *known, com a senha
+ *
+ * @return Número de alvos encontrados, ou -1 se faltar memória
+ */
+int potfile_filter(const potfile_t *pot, int algo, int spec, md5_target_t *targets, int *count,
+                   potfile_hit_t **known);
+
+/**
+ * Acrescenta uma senha ao log (uma linha, num único write() sob flock,
+ * depois de descartar uma linha interrompida no fim do log)
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro (errno preservado)
+ */
+int potfile_append(potfile_t *pot, int algo, int spec, const md5_target_t *target,
+                   const char *password);
+
+void potfile_close(potfile_t *pot);
+
+#endif // POTFILE_H
@@ -0,0 +1,69 @@
+#include <string.h>
+#include <time.h>
+#include "progress.h"
+
+#define PROGRESS_NORMAL_SECONDS 10.0
+#define PROGRESS_VERBOSE_SECONDS 1.0
+
+log_level_t log_level = LOG_NORMAL;
+
+int log_parse_option(const char *arg) {
+    if (strcmp(arg, "-q") == 0) {
+        log_level = LOG_QUIET;
+    } else if (strcmp(arg, "-v") == 0) {
+        log_level = LOG_VERBOSE;
+    } else if (strcmp(arg, "--trace-candidates") == 0) {
+#ifndef TRACE_CANDIDATES
+        fprintf(stderr, "Aviso: --trace-candidates só existe no build de depuração (make debug)\n");
+#endif
+        log_level = LOG_TRACE;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+const char *log_level_option(void) {
+    switch (log_level) {
+        case LOG_QUIET:   return "-q";
+        case LOG_VERBOSE: return "-v";
+        case LOG_TRACE:   return "--trace-candidates";
+        default:          return NULL;
+    }
+}
+
+double progress_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void progress_init(progress_t *progress) {
+    progress->start = progress_now();
+    progress->interval = 0;
+    if (log_level >= LOG_VERBOSE) {
+        progress->interval = PROGRESS_VERBOSE_SECONDS;
+    } else if (log_level == LOG_NORMAL) {
+        progress->interval = PROGRESS_NORMAL_SECONDS;
+    }
+    progress->next = progress->start + progress->interval;
+}
+
+void progress_update(progress_t *progress, int worker_id, long long checked,
+                     long long total, const char *current) {
+    if (progress->interval == 0) {
+        return;
+    }
+
+    double now = progress_now();
+    if (now < progress->next) {
+        return;
+    }
+    progress->next = now + progress->interval;
+
+    double elapsed = now - progress->start;
+    printf("[Worker %d] Progresso: %lld senhas verificadas (%.0f/s, %.1f%%) - atual: %s\n",
+           worker_id, checked, elapsed > 0 ? checked / elapsed : 0.0,
+           total > 0 ? 100.0 * checked / total : 100.0, current);
+    fflush(stdout);
+}
@@ -0,0 +1,86 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <stdio.h>
+
+/**
+ * Níveis de verbosidade e relatório de progresso - Mini-Projeto 1
+ *
+ * O nível é escolhido no coordinator (-q, padrão, -v, --trace-candidates)
+ * e repassado a cada worker. O progresso dos workers é limitado por tempo
+ * decorrido, não por número de senhas: o custo de saída fica constante
+ * mesmo quando a taxa de hashes cresce.
+ */
+
+typedef enum {
+    LOG_QUIET = 0,      // -q: só o resultado final e erros
+    LOG_NORMAL = 1,     // padrão: início/fim de cada worker, progresso a cada 10 s
+    LOG_VERBOSE = 2,    // -v: progresso a cada 1 s e detalhes de configuração
+    LOG_TRACE = 3       // --trace-candidates: uma linha por senha testada
+} log_level_t;
+
+extern log_level_t log_level;
+
+// Imprime só se o nível atual for pelo menos `level`
+#define LOG(level, ...) do { \
+    if (log_level >= (level)) { \
+        printf(__VA_ARGS__); \
+    } \
+} while (0)
+
+/*
+ * O trace por candidato só existe em builds de depuração (make debug),
+ * para que o laço principal do build otimizado não tenha nem o teste.
+ */
+#ifdef TRACE_CANDIDATES
+#define TRACE_ENABLED() (log_level >= LOG_TRACE)
+#else
+#define TRACE_ENABLED() 0
+#endif
+
+/**
+ * Interpreta uma opção de verbosidade (-q, -v, --trace-candidates)
+ *
+ * @return 1 se a opção foi reconhecida e aplicada, 0 caso contrário
+ */
+int log_parse_option(const char *arg);
+
+/**
+ * Opção equivalente ao nível atual, para repassar ao worker
+ *
+ * @return "-q", "-v", "--trace-candidates" ou NULL no nível padrão
+ */
+const char *log_level_option(void);
+
+/**
+ * Estado do relatório de progresso de um worker
+ */
+typedef struct {
+    double start;           // Instante de início (segundos, relógio monotônico)
+    double next;            // Próximo instante em que um relatório é devido
+    double interval;        // Intervalo entre relatórios (0 = desativado)
+} progress_t;
+
+/**
+ * Relógio monotônico em segundos (alta resolução)
+ */
+double progress_now(void);
+
+/**
+ * Inicializa o relatório com o intervalo correspondente ao nível atual
+ */
+void progress_init(progress_t *progress);
+
+/**
+ * Imprime uma linha de progresso se o intervalo de tempo já passou
+ *
+ * Deve ser chamada uma vez por lote; só consulta o relógio.
+ *
+ * @param checked Senhas verificadas até agora
+ * @param total Senhas do intervalo do worker
+ * @param current Candidato atual (para referência)
+ */
+void progress_update(progress_t *progress, int worker_id, long long checked,
+                     long long total, const char *current);
+
+#endif // PROGRESS_H
@@ -0,0 +1,122 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "markov.h"
+#include "remote_job.h"
+
+int remote_job_open(remote_job_t *rj, char *error, size_t error_size) {
+    net_job_t *p = &rj->params;
+
+    if (net_job_decode(&rj->msg, p) != 0) {
+        snprintf(error, error_size, "job inválido");
+        return -1;
+    }
+    if (p->min_len < 1 || p->max_len < p->min_len || p->max_len > hash_algo_get(p->algo)->max_len) {
+        snprintf(error, error_size, "faixa de comprimentos inválida");
+        return -1;
+    }
+
+    if (p->wordlist != NULL) {
+        if (wordlist_open(&rj->wordlist, p->wordlist) != 0) {
+            snprintf(error, error_size, "%s: %s", p->wordlist, strerror(errno));
+            return -1;
+        }
+        rj->has_wordlist = 1;
+        if (rule_set_load(&rj->rules, p->rules, 0) < 1) {
+            snprintf(error, error_size, "nenhuma regra válida em %s", p->rules);
+            return -1;
+        }
+        rj->has_rules = 1;
+        rj->space = rj->wordlist.size;
+    } else {
+        int rc = p->mask != NULL
+            ? keyspace_init_mask(&rj->keyspace, p->mask, p->custom, p->min_len, p->max_len)
+            : p->charset != NULL
+            ? keyspace_init(&rj->keyspace, p->charset, strlen(p->charset), p->min_len, p->max_len)
+            : -1;
+        rj->space = rc == 0 ? rj->keyspace.total : -1;
+        if (rc == 0 && p->markov != NULL) {
+            markov_model_t model;
+            int status = markov_load(&model, p->markov);
+            if (status != 0 || model.id != p->markov_id) {
+                snprintf(error, error_size, "%s: %s", p->markov,
+                         status == -1 ? strerror(errno) : "modelo Markov diferente do coordinator");
+                return -1;
+            }
+            if (markov_apply(&model, &rj->keyspace) != 0) {
+                snprintf(error, error_size, "charsets grandes demais para a ordem Markov");
+                return -1;
+            }
+        }
+    }
+    for (int i = 0; i < p->num_targets && p->spec != MD5_SPEC_PLAIN; i++) {
+        if (p->max_len > md5_spec_max_len(p->spec, p->targets[i].salt_len)) {
+            snprintf(error, error_size, "sal longo demais para o tamanho de senha");
+            return -1;
+        }
+    }
+    if (rj->space != p->total) {
+        char space_str[KEYSPACE_INDEX_DIGITS], total_str[KEYSPACE_INDEX_DIGITS];
+        snprintf(error, error_size, "espaço de busca diferente do coordinator (%s, esperado %s)",
+                 keyspace_index_format(rj->space, space_str), keyspace_index_format(p->total, total_str));
+        return -1;
+    }
+    if (p->base < 0 || p->base > p->total) {
+        snprintf(error, error_size, "início do job fora do espaço de busca");
+        return -1;
+    }
+    rj->window = keyspace_window(rj->space, p->base);
+
+    rj->shared = shared_state_create(p->num_targets, &rj->shm_fd);
+    if (rj->shared == NULL) {
+        snprintf(error, error_size, "sem memória para o estado do job");
+        return -1;
+    }
+    for (int i = 0; i < p->num_targets; i++) {
+        shared_state_set_target(rj->shared, i, &p->targets[i]);
+    }
+    if (search_job_prepare(&rj->job, p->min_len, p->max_len, p->targets, p->num_targets,
+                           p->multi, p->algo, p->spec, rj->shared) != 0) {
+        snprintf(error, error_size, "sem memória para o conjunto de alvos");
+        return -1;
+    }
+    rj->has_job = 1;
+    rj->job.base = p->base;
+    if (rj->has_wordlist) {
+        rj->job.wordlist = &rj->wordlist;
+        rj->job.rules = &rj->rules;
+    } else {
+        rj->job.keyspace = &rj->keyspace;
+    }
+    return 0;
+}
+
+void remote_job_close(remote_job_t *rj) {
+    if (rj->has_job) {
+        search_job_free(&rj->job);
+    }
+    if (rj->has_rules) {
+        rule_set_free(&rj->rules);
+    }
+    if (rj->has_wordlist) {
+        wordlist_close(&rj->wordlist);
+    }
+    if (rj->shared != NULL) {
+        shared_state_destroy(rj->shared, rj->shm_fd);
+    }
+    free(rj->params.targets);
+    net_msg_free(&rj->msg);
+    memset(rj, 0, sizeof(*rj));
+}
+
+int remote_job_accept_crack(remote_job_t *rj, net_msg_t *msg) {
+    uint32_t target = net_get_u32(msg);
+    uint32_t worker_id = net_get_u32(msg);
+    const char *password = net_get_str(msg);
+    if (msg->error || password == NULL || target >= (uint32_t)rj->params.num_targets) {
+        return -1;
+    }
+    shared_state_publish(rj->shared, target, worker_id, password);
+    return (int)target;
+}
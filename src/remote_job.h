@@ -0,0 +1,55 @@
+#ifndef REMOTE_JOB_H
+#define REMOTE_JOB_H
+
+#include "net_proto.h"
+#include "search.h"
+
+/**
+ * Job recebido numa mensagem JOB e montado localmente - Mini-Projeto 1
+ *
+ * Usado pelos nós do modo distribuído (node.c) e pelo daemon (daemon.c):
+ * decodifica os parâmetros, monta o espaço de busca (a wordlist, se houver,
+ * deve existir no mesmo caminho), confere o total calculado pelo remetente,
+ * cria a região compartilhada com um slot por alvo e prepara os alvos.
+ * O escalonador (shared->sched) fica por conta do chamador.
+ *
+ * Contém um keyspace_t: não copiar (use uma instância estática ou alocada).
+ */
+
+typedef struct {
+    net_msg_t msg;              // As strings de params apontam para este buffer
+    net_job_t params;
+    keyspace_t keyspace;
+    wordlist_t wordlist;
+    rule_set_t rules;
+    int has_wordlist, has_rules, has_job;
+    search_job_t job;
+    shared_state_t *shared;
+    int shm_fd;
+    keyspace_index_t space;     // Espaço (ou bytes da wordlist) calculado aqui
+    long long window;           // Posições a partir de params.base (keyspace_window)
+} remote_job_t;
+
+/**
+ * Monta o job da mensagem JOB já recebida em rj->msg
+ *
+ * @param error Saída: motivo da falha, para a mensagem ERROR
+ * @return 0 em caso de sucesso, -1 em caso de erro (chamar remote_job_close
+ *         mesmo assim)
+ */
+int remote_job_open(remote_job_t *rj, char *error, size_t error_size);
+
+/**
+ * Libera tudo o que remote_job_open montou (e a mensagem) e zera rj
+ */
+void remote_job_close(remote_job_t *rj);
+
+/**
+ * Publica na região local uma senha encontrada por outro (mensagem FOUND:
+ * alvo, worker, senha)
+ *
+ * @return Índice do alvo, ou -1 se a mensagem é inválida
+ */
+int remote_job_accept_crack(remote_job_t *rj, net_msg_t *msg);
+
+#endif // REMOTE_JOB_H
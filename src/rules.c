@@ -0,0 +1,224 @@
+#include "rules.h"
+
+/*
+ * Maiúsculas/minúsculas só em ASCII, como no hashcat: sem as funções de
+ * ctype.h (chamadas de biblioteca dependentes de locale) no laço por caractere
+ */
+static inline char ascii_lower(char c) {
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+static inline char ascii_upper(char c) {
+    return c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c;
+}
+
+static inline char ascii_toggle(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ? c ^ 0x20 : c;
+}
+
+/**
+ * Posição no formato do hashcat: 0-9 e depois A-Z (10-35)
+ */
+static int rule_position(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+int rule_parse(const char *text, rule_t *rule) {
+    rule->num_ops = 0;
+
+    for (const char *p = text; *p != '\0'; p++) {
+        rule_op_t op = { .code = *p };
+        int args;
+
+        switch (*p) {
+            case ' ': case '\t':
+                continue;
+            case ':': case 'l': case 'u': case 'c': case 'C': case 't': case 'r': case 'd':
+                args = 0;
+                break;
+            case '$': case '^': case 'T':
+                args = 1;
+                break;
+            case 's':
+                args = 2;
+                break;
+            default:
+                return -1;
+        }
+
+        for (int i = 0; i < args; i++) {
+            if (*++p == '\0') {
+                return -1;
+            }
+            op.arg[i] = (unsigned char)*p;
+        }
+        if (op.code == 'T') {
+            int pos = rule_position(op.arg[0]);
+            if (pos < 0) {
+                return -1;
+            }
+            op.arg[0] = pos;
+        }
+        if (op.code == ':') {
+            continue;
+        }
+        if (rule->num_ops == RULES_MAX_OPS) {
+            return -1;
+        }
+        rule->ops[rule->num_ops++] = op;
+    }
+    return 0;
+}
+
+int rule_set_load(rule_set_t *set, const char *path, int warn) {
+    memset(set, 0, sizeof(*set));
+
+    if (path == NULL) {
+        set->rules = calloc(1, sizeof(rule_t));
+        if (set->rules == NULL) {
+            return -1;
+        }
+        set->count = 1;
+        return 1;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    int capacity = 0;
+    char line[256];
+    int line_number = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        if (set->count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            rule_t *grown = realloc(set->rules, capacity * sizeof(rule_t));
+            if (grown == NULL) {
+                rule_set_free(set);
+                fclose(file);
+                return -1;
+            }
+            set->rules = grown;
+        }
+        if (rule_parse(line, &set->rules[set->count]) != 0) {
+            if (warn) {
+                fprintf(stderr, "Aviso: %s:%d: regra inválida ignorada: %s\n", path, line_number, line);
+            }
+            continue;
+        }
+        set->count++;
+    }
+    fclose(file);
+    return set->count;
+}
+
+void rule_set_free(rule_set_t *set) {
+    free(set->rules);
+    memset(set, 0, sizeof(*set));
+}
+
+void rules_apply_batch(const rule_t *rule, const char *const *words, const int *lens, int count,
+                       rule_batch_t *out) {
+    out->count = count;
+    for (int i = 0; i < count; i++) {
+        if (lens[i] < RULES_WORD_MAX) {
+            memcpy(out->word[i], words[i], lens[i]);
+            out->len[i] = lens[i];
+        } else {
+            out->len[i] = -1;
+        }
+    }
+
+    // Uma operação por vez sobre o lote inteiro: o switch cai sempre no mesmo caso
+    for (int k = 0; k < rule->num_ops; k++) {
+        const rule_op_t *op = &rule->ops[k];
+
+        for (int i = 0; i < count; i++) {
+            char *w = out->word[i];
+            int len = out->len[i];
+            if (len < 0) {
+                continue;
+            }
+
+            switch (op->code) {
+                case 'l':
+                    for (int j = 0; j < len; j++) {
+                        w[j] = ascii_lower(w[j]);
+                    }
+                    break;
+                case 'u':
+                    for (int j = 0; j < len; j++) {
+                        w[j] = ascii_upper(w[j]);
+                    }
+                    break;
+                case 'c':
+                case 'C':
+                    for (int j = 0; j < len; j++) {
+                        int upper = (j == 0) == (op->code == 'c');
+                        w[j] = upper ? ascii_upper(w[j]) : ascii_lower(w[j]);
+                    }
+                    break;
+                case 't':
+                    for (int j = 0; j < len; j++) {
+                        w[j] = ascii_toggle(w[j]);
+                    }
+                    break;
+                case 'T':
+                    if (op->arg[0] < len) {
+                        w[op->arg[0]] = ascii_toggle(w[op->arg[0]]);
+                    }
+                    break;
+                case 'r':
+                    for (int j = 0; j < len / 2; j++) {
+                        char c = w[j];
+                        w[j] = w[len - 1 - j];
+                        w[len - 1 - j] = c;
+                    }
+                    break;
+                case 'd':
+                    if (2 * len >= RULES_WORD_MAX) {
+                        out->len[i] = -1;
+                    } else {
+                        memcpy(w + len, w, len);
+                        out->len[i] = 2 * len;
+                    }
+                    break;
+                case '$':
+                case '^':
+                    if (len + 1 >= RULES_WORD_MAX) {
+                        out->len[i] = -1;
+                        break;
+                    }
+                    if (op->code == '^') {
+                        memmove(w + 1, w, len);
+                        w[0] = op->arg[0];
+                    } else {
+                        w[len] = op->arg[0];
+                    }
+                    out->len[i] = len + 1;
+                    break;
+                case 's':
+                    for (int j = 0; j < len; j++) {
+                        if ((unsigned char)w[j] == op->arg[0]) {
+                            w[j] = op->arg[1];
+                        }
+                    }
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include "hash_utils.h"
+
+/**
+ * Regras de transformação de palavras (--rules) - Mini-Projeto 1
+ *
+ * Subconjunto da sintaxe de regras do hashcat/John, uma regra por linha,
+ * operações aplicadas da esquerda para a direita (espaços são ignorados):
+ *
+ *   :      nada (a própria palavra)
+ *   l / u  tudo minúsculo / tudo maiúsculo
+ *   c / C  primeira maiúscula e o resto minúsculo / o contrário
+ *   t      inverte maiúsculas e minúsculas
+ *   TN     inverte maiúscula/minúscula só na posição N (0-9, A-Z = 10-35)
+ *   r      inverte a palavra
+ *   d      duplica a palavra
+ *   $X     acrescenta X no fim (ex.: $1 $2 $3 -> "palavra123")
+ *   ^X     acrescenta X no início
+ *   sXY    troca todo X por Y (leetspeak: sa@ se3 so0)
+ *
+ * As regras são aplicadas a um lote inteiro de palavras de uma vez
+ * (rules_apply_batch): cada operação percorre o lote todo antes da próxima,
+ * então o desvio da operação é o mesmo em todo o laço sobre as palavras.
+ */
+
+#define RULES_MAX_OPS 32                // Operações por regra
+#define RULES_WORD_MAX 128              // Maior palavra intermediária (bytes)
+#define RULES_BATCH 256                 // Palavras por lote
+
+typedef struct {
+    char code;                  // Operação (letra da sintaxe)
+    unsigned char arg[2];       // Argumentos (caracteres ou posição)
+} rule_op_t;
+
+typedef struct {
+    int num_ops;
+    rule_op_t ops[RULES_MAX_OPS];
+} rule_t;
+
+typedef struct {
+    int count;
+    rule_t *rules;
+} rule_set_t;
+
+/**
+ * Lote de palavras transformadas: len[i] < 0 marca uma palavra descartada
+ * (grande demais para RULES_WORD_MAX)
+ */
+typedef struct {
+    int count;
+    int len[RULES_BATCH];
+    char word[RULES_BATCH][RULES_WORD_MAX];
+} rule_batch_t;
+
+/**
+ * Compila uma regra em texto ("c$1", "sa@ so0")
+ *
+ * @return 0 em caso de sucesso, -1 se a regra for inválida
+ */
+int rule_parse(const char *text, rule_t *rule);
+
+/**
+ * Carrega as regras de um arquivo (uma por linha; linhas vazias e
+ * comentários "#" são ignorados). Sem arquivo (path NULL), o conjunto tem
+ * só a regra ":" (cada palavra como está).
+ *
+ * @param warn 1 = avisa (stderr) cada regra inválida ignorada
+ * @return Número de regras, ou -1 em caso de erro de leitura/memória
+ */
+int rule_set_load(rule_set_t *set, const char *path, int warn);
+
+/**
+ * Libera as regras carregadas por rule_set_load
+ */
+void rule_set_free(rule_set_t *set);
+
+/**
+ * Aplica uma regra a um lote de palavras
+ *
+ * @param words Palavras de entrada (não precisam terminar em '\0')
+ * @param lens Tamanho de cada palavra
+ * @param count Número de palavras (até RULES_BATCH)
+ * @param out Saída: as palavras transformadas, na mesma ordem
+ */
+void rules_apply_batch(const rule_t *rule, const char *const *words, const int *lens, int count,
+                       rule_batch_t *out);
+
+#endif // RULES_H
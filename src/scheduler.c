@@ -0,0 +1,155 @@
+#include <limits.h>
+#include <string.h>
+#include "scheduler.h"
+#include "progress.h"
+
+#define SCHED_CHUNK_MAX (1LL << 40)
+
+void scheduler_init(scheduler_t *sched, long long start, long long count, int num_workers) {
+    memset(sched->workers, 0, sizeof(sched->workers));
+    for (int i = 0; i < SCHED_MAX_WORKERS; i++) {
+        atomic_store_explicit(&sched->workers[i].pending, LLONG_MAX, memory_order_relaxed);
+    }
+    sched->end = start + count;
+    sched->num_workers = num_workers;
+    sched->start = progress_now();
+    atomic_store_explicit(&sched->cursor, start, memory_order_relaxed);
+}
+
+void scheduler_local_init(sched_local_t *local, int worker_id) {
+    local->worker_id = worker_id;
+    local->chunk = SCHED_CHUNK_FIRST;
+    local->claimed = 0;
+    local->chunk_start = 0;
+}
+
+int scheduler_next(scheduler_t *sched, sched_local_t *local, long long *start, long long *count) {
+    long long cursor = atomic_load_explicit(&sched->cursor, memory_order_relaxed);
+    long long size;
+
+    // Antes do CAS: o chunk retirado começa em cursor ou depois (o cursor só avança)
+    if (local->worker_id >= 0 && local->worker_id < SCHED_MAX_WORKERS) {
+        atomic_store(&sched->workers[local->worker_id].pending, cursor);
+    }
+
+    do {
+        long long remaining = sched->end - cursor;
+        if (remaining <= 0) {
+            return 0;
+        }
+
+        // Guiado: o chunk nunca passa de uma fração do que resta por worker
+        long long guided = remaining / ((long long)SCHED_GUIDED_FACTOR * sched->num_workers);
+        size = local->chunk < guided ? local->chunk : guided;
+        if (size < SCHED_CHUNK_MIN) {
+            size = SCHED_CHUNK_MIN;
+        }
+        if (size > remaining) {
+            size = remaining;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&sched->cursor, &cursor, cursor + size,
+                                                    memory_order_seq_cst, memory_order_relaxed));
+
+    *start = cursor;
+    *count = size;
+    local->claimed = size;
+    local->chunk_start = progress_now();
+    return 1;
+}
+
+void scheduler_complete(scheduler_t *sched, sched_local_t *local, long long checked) {
+    double now = progress_now();
+    double elapsed = now - local->chunk_start;
+
+    if (local->worker_id >= 0 && local->worker_id < SCHED_MAX_WORKERS) {
+        sched_worker_stats_t *stats = &sched->workers[local->worker_id];
+        if (stats->chunks == 0 || elapsed < stats->min_chunk) {
+            stats->min_chunk = elapsed;
+        }
+        if (elapsed > stats->max_chunk) {
+            stats->max_chunk = elapsed;
+        }
+        stats->chunks++;
+        stats->checked += checked;
+        stats->busy += elapsed;
+        stats->finish = now;
+
+        // Só um chunk verificado por inteiro deixa de segurar o watermark
+        if (checked == local->claimed) {
+            atomic_store_explicit(&stats->pending, LLONG_MAX, memory_order_release);
+        }
+    }
+
+    // Só chunks completos dão uma taxa confiável para o próximo tamanho
+    if (checked == local->claimed && elapsed > 0) {
+        double want = checked / elapsed * SCHED_CHUNK_SECONDS;
+        local->chunk = want > SCHED_CHUNK_MAX ? SCHED_CHUNK_MAX : (long long)want;
+    }
+}
+
+void scheduler_reassign(scheduler_t *sched, sched_local_t *local, int from_worker,
+                        long long start, long long count) {
+    // Novo dono primeiro: em nenhum instante o chunk fica sem pending
+    if (local->worker_id >= 0 && local->worker_id < SCHED_MAX_WORKERS) {
+        atomic_store(&sched->workers[local->worker_id].pending, start);
+    }
+    if (from_worker >= 0 && from_worker < SCHED_MAX_WORKERS && from_worker != local->worker_id) {
+        atomic_store(&sched->workers[from_worker].pending, LLONG_MAX);
+    }
+    local->claimed = count;
+    local->chunk_start = progress_now();
+}
+
+long long scheduler_watermark(scheduler_t *sched) {
+    // Cursor antes dos pendentes: um chunk retirado antes desta leitura já
+    // tem o seu pending gravado (store antes do CAS, ambos seq_cst)
+    long long mark = atomic_load(&sched->cursor);
+
+    for (int i = 0; i < sched->num_workers && i < SCHED_MAX_WORKERS; i++) {
+        long long pending = atomic_load(&sched->workers[i].pending);
+        if (pending < mark) {
+            mark = pending;
+        }
+    }
+    return mark < sched->end ? mark : sched->end;
+}
+
+long long scheduler_checked(const scheduler_t *sched) {
+    int workers = sched->num_workers < SCHED_MAX_WORKERS ? sched->num_workers : SCHED_MAX_WORKERS;
+    long long checked = 0;
+
+    for (int i = 0; i < workers; i++) {
+        checked += sched->workers[i].checked;
+    }
+    return checked;
+}
+
+void scheduler_report(const scheduler_t *sched) {
+    int workers = sched->num_workers < SCHED_MAX_WORKERS ? sched->num_workers : SCHED_MAX_WORKERS;
+    double first = 0, last = 0;
+    long long chunks = 0;
+
+    for (int i = 0; i < workers; i++) {
+        const sched_worker_stats_t *stats = &sched->workers[i];
+        if (stats->chunks == 0) {
+            LOG(LOG_VERBOSE, "Worker %d: nenhum chunk\n", i);
+            continue;
+        }
+        double finish = stats->finish - sched->start;
+        if (chunks == 0 || finish < first) {
+            first = finish;
+        }
+        if (finish > last) {
+            last = finish;
+        }
+        chunks += stats->chunks;
+
+        LOG(LOG_VERBOSE, "Worker %d: %lld chunks, %lld senhas, %.2f s ocupado "
+            "(chunk %.3f-%.3f s), terminou em %.2f s\n", i, stats->chunks, stats->checked,
+            stats->busy, stats->min_chunk, stats->max_chunk, finish);
+    }
+
+    LOG(LOG_NORMAL, "Chunks distribuídos: %lld\n", chunks);
+    LOG(LOG_NORMAL, "Diferença entre o primeiro e o último worker a terminar: %.3f segundos\n",
+        last - first);
+}
@@ -0,0 +1,123 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdatomic.h>
+
+/**
+ * Escalonador dinâmico de chunks - Mini-Projeto 1
+ *
+ * Em vez de um intervalo fixo por worker, o espaço de busca é entregue em
+ * chunks retirados de um cursor atômico compartilhado (um fetch/CAS por
+ * chunk). Um worker mais lento (irmão SMT, vizinho barulhento, sem turbo)
+ * simplesmente pega menos chunks, e ninguém fica esperando o mais lento.
+ *
+ * O tamanho do chunk se adapta:
+ * - cada worker mede a própria taxa e mira chunks de SCHED_CHUNK_SECONDS
+ * - nunca mais que o restante / (SCHED_GUIDED_FACTOR * num_workers): perto
+ *   do fim os chunks encolhem e os workers terminam quase juntos
+ *
+ * Cada worker registra os chunks que concluiu no seu slot de estatísticas
+ * (uma linha de cache por worker), que o coordinator resume no final.
+ *
+ * Para checkpoints (checkpoint.h), cada slot também guarda em pending um
+ * limite inferior do chunk em andamento: gravado antes do CAS que retira o
+ * chunk e liberado só quando ele é concluído por inteiro. Tudo abaixo de
+ * scheduler_watermark já foi verificado.
+ */
+
+#define SCHED_MAX_WORKERS 1024
+#define SCHED_CHUNK_MIN 1024            // Senhas (múltiplo de MD5_BATCH_MAX)
+#define SCHED_CHUNK_FIRST 65536         // Antes de o worker conhecer a própria taxa
+#define SCHED_CHUNK_SECONDS 0.05        // Duração alvo de um chunk
+#define SCHED_GUIDED_FACTOR 4
+
+/**
+ * Chunks concluídos por um worker (escrito só pelo próprio worker)
+ */
+typedef struct {
+    _Alignas(64)
+    long long chunks;
+    long long checked;
+    double busy;            // Soma das durações dos chunks (s)
+    double min_chunk;       // Chunk mais rápido (s)
+    double max_chunk;       // Chunk mais lento (s)
+    double finish;          // Instante (progress_now) do último chunk concluído
+    atomic_llong pending;   // <= início do chunk em andamento (LLONG_MAX = nenhum)
+} sched_worker_stats_t;
+
+typedef struct {
+    // Disputado por todos os workers a cada chunk: sozinho na sua linha
+    _Alignas(64) atomic_llong cursor;   // Próximo índice ainda não entregue
+
+    _Alignas(64) long long end;         // Fim (exclusivo) do espaço
+    int num_workers;
+    double start;                       // Instante (progress_now) do início do job
+
+    sched_worker_stats_t workers[SCHED_MAX_WORKERS];
+} scheduler_t;
+
+/**
+ * Estado adaptativo de um worker (local, fora da memória compartilhada)
+ */
+typedef struct {
+    int worker_id;
+    long long chunk;        // Tamanho desejado do próximo chunk
+    long long claimed;      // Tamanho do chunk em andamento
+    double chunk_start;
+} sched_local_t;
+
+/**
+ * Prepara o escalonador para o intervalo [start, start + count)
+ * (no coordinator, antes de criar os workers)
+ */
+void scheduler_init(scheduler_t *sched, long long start, long long count, int num_workers);
+
+void scheduler_local_init(sched_local_t *local, int worker_id);
+
+/**
+ * Retira o próximo chunk do cursor compartilhado
+ *
+ * @param start Saída: índice inicial do chunk
+ * @param count Saída: número de senhas do chunk
+ * @return 1 se entregou um chunk, 0 se o espaço acabou
+ */
+int scheduler_next(scheduler_t *sched, sched_local_t *local, long long *start, long long *count);
+
+/**
+ * Registra a conclusão do chunk em andamento e ajusta o tamanho do próximo
+ *
+ * @param checked Senhas efetivamente verificadas (menos que o chunk se parou
+ *                cedo; nesse caso o chunk continua pendente para o checkpoint)
+ */
+void scheduler_complete(scheduler_t *sched, sched_local_t *local, long long checked);
+
+/**
+ * Entrega a local um chunk retirado antes por outro worker que não o
+ * concluiu (nó perdido, no modo distribuído): o pending passa do worker
+ * original para o novo, sem deixar o chunk descoberto no watermark
+ *
+ * @param from_worker Worker que tinha o chunk
+ */
+void scheduler_reassign(scheduler_t *sched, sched_local_t *local, int from_worker,
+                        long long start, long long count);
+
+/**
+ * Senhas (unidades do espaço) efetivamente verificadas por todos os
+ * workers: menos que o espaço total quando a busca para antes do fim
+ */
+long long scheduler_checked(const scheduler_t *sched);
+
+/**
+ * Índice abaixo do qual todo o espaço já foi verificado: o menor entre o
+ * cursor e os chunks ainda pendentes (pode ser lido a qualquer momento,
+ * por outra thread/processo)
+ */
+long long scheduler_watermark(scheduler_t *sched);
+
+/**
+ * Imprime o balanceamento: chunks por worker e a diferença entre o primeiro
+ * e o último a terminar (chamar depois de todos os workers terminarem)
+ */
+void scheduler_report(const scheduler_t *sched);
+
+#endif // SCHEDULER_H
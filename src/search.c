@@ -0,0 +1,584 @@
+#include "search.h"
+
+static int compare_salts(const md5_target_t *x, const md5_target_t *y) {
+    if (x->salt_len != y->salt_len) {
+        return x->salt_len < y->salt_len ? -1 : 1;
+    }
+    return memcmp(x->salt, y->salt, x->salt_len);
+}
+
+// Ordem dos alvos por sal; no mesmo sal, a ordem original
+static int compare_salt_order(const void *a, const void *b) {
+    const md5_target_t *x = *(const md5_target_t *const *)a, *y = *(const md5_target_t *const *)b;
+    int cmp = compare_salts(x, y);
+    return cmp != 0 ? cmp : (x > y) - (x < y);
+}
+
+/**
+ * Agrupa os alvos pelo sal e monta, para cada grupo com mais de um alvo, um
+ * conjunto por comprimento (os de um alvo só são revertidos a cada trecho)
+ */
+static int search_job_prepare_salts(search_job_t *job, const md5_target_t *targets, int num_targets) {
+    const md5_target_t **order = malloc(num_targets * sizeof(*order));
+    md5_target_t *group = malloc(num_targets * sizeof(*group));
+    job->salts = calloc(num_targets, sizeof(search_salt_t));
+    job->salt_index = malloc(num_targets * sizeof(int));
+    if (order == NULL || group == NULL || job->salts == NULL || job->salt_index == NULL) {
+        free(order);
+        free(group);
+        return -1;
+    }
+
+    for (int i = 0; i < num_targets; i++) {
+        order[i] = &targets[i];
+    }
+    qsort(order, num_targets, sizeof(*order), compare_salt_order);
+    for (int i = 0; i < num_targets; i++) {
+        job->salt_index[i] = (int)(order[i] - targets);
+        if (i == 0 || compare_salts(order[i - 1], order[i]) != 0) {
+            search_salt_t *salt = &job->salts[job->num_salts++];
+            salt->target = *order[i];
+            salt->index = &job->salt_index[i];
+        }
+        job->salts[job->num_salts - 1].count++;
+    }
+    free(order);
+
+    int rc = 0;
+    for (int s = 0; s < job->num_salts && rc == 0; s++) {
+        search_salt_t *salt = &job->salts[s];
+        if (salt->count == 1) {
+            continue;
+        }
+        salt->set = calloc(MD5_SINGLE_BLOCK_MAX + 1, sizeof(md5_target_set_t));
+        if (salt->set == NULL) {
+            rc = -1;
+            break;
+        }
+        for (int k = 0; k < salt->count; k++) {
+            group[k] = targets[salt->index[k]];
+        }
+        for (int len = job->min_len; len <= job->max_len && rc == 0; len++) {
+            md5_salted_t salted;
+            rc = md5_salted_init(&salted, job->spec, salt->target.salt, salt->target.salt_len, len);
+            if (rc == 0) {
+                rc = md5_target_set_init_salted(&salt->set[len], group, salt->count, &salted);
+            }
+        }
+    }
+    free(group);
+    return rc;
+}
+
+int search_job_prepare(search_job_t *job, int min_len, int max_len, const md5_target_t *targets,
+                       int num_targets, int multi, int algo, int spec, shared_state_t *shared) {
+    memset(job, 0, sizeof(*job));
+    job->min_len = min_len;
+    job->max_len = max_len;
+    job->multi = multi;
+    job->algo = algo;
+    job->spec = spec;
+    job->shared = shared;
+
+    if (spec != MD5_SPEC_PLAIN) {
+        if (search_job_prepare_salts(job, targets, num_targets) != 0) {
+            search_job_free(job);
+            return -1;
+        }
+        return 0;
+    }
+    for (int len = min_len; len <= max_len; len++) {
+        if (multi) {
+            if (hash_target_set_init(algo, &job->set[len], targets, num_targets, len) != 0) {
+                search_job_free(job);
+                return -1;
+            }
+        } else {
+            job->target[len] = targets[0];
+            if (algo == HASH_MD5) {
+                md5_target_reverse(&job->target[len], len);
+            }
+        }
+    }
+    return 0;
+}
+
+void search_job_free(search_job_t *job) {
+    for (int s = 0; s < job->num_salts; s++) {
+        if (job->salts[s].set != NULL) {
+            for (int len = job->min_len; len <= job->max_len; len++) {
+                md5_target_set_free(&job->salts[s].set[len]);
+            }
+            free(job->salts[s].set);
+        }
+    }
+    free(job->salts);
+    free(job->salt_index);
+    job->salts = NULL;
+    job->salt_index = NULL;
+    job->num_salts = 0;
+
+    if (!job->multi || job->spec != MD5_SPEC_PLAIN) {
+        return;
+    }
+    for (int len = job->min_len; len <= job->max_len; len++) {
+        md5_target_set_free(&job->set[len]);
+    }
+}
+
+void search_init(search_ctx_t *ctx, const search_job_t *job, int worker_id) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->job = job;
+    ctx->worker_id = worker_id;
+    progress_init(&ctx->progress);
+    ctx->origin = ctx->progress.start;
+}
+
+/**
+ * Publica uma senha encontrada no slot do seu alvo
+ */
+static void search_report(search_ctx_t *ctx, int target, const char *password) {
+    strcpy(ctx->password, password);
+    ctx->found++;
+    LOG(LOG_NORMAL, "[Worker %d] SENHA ENCONTRADA: %s\n", ctx->worker_id, password);
+    // Com sal, target é o índice no grupo
+    if (ctx->salt != NULL) {
+        target = ctx->salt->index[target];
+    }
+    shared_state_publish(ctx->job->shared, target, ctx->worker_id, password);
+}
+
+/**
+ * Testa um lote de blocos completos com os alvos de ctx e publica os acertos
+ *
+ * @return Número de senhas encontradas; com alvo único, a contagem de
+ *         verificadas para no acerto (o chamador deve parar)
+ */
+static int search_test_batch(search_ctx_t *ctx, const md5_block_batch_t *batch) {
+    char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+
+    if (TRACE_ENABLED()) {
+        for (int i = 0; i < batch->count; i++) {
+            md5_block_batch_get(batch, i, candidate);
+            printf("[Worker %d] testando senha: %s\n", ctx->worker_id, candidate);
+        }
+    }
+
+    ctx->batches++;
+    if (ctx->set != NULL) {
+        int hits = hash_block_batch_find_set(ctx->job->algo, batch, ctx->set, ctx->hits);
+        for (int i = 0; i < hits; i++) {
+            md5_block_batch_get(batch, ctx->hits[i].index, candidate);
+            search_report(ctx, ctx->hits[i].target, candidate);
+        }
+        ctx->checked += batch->count;
+        return hits;
+    }
+
+    int hit = hash_block_batch_find(ctx->job->algo, batch, ctx->target);
+    if (hit >= 0) {
+        md5_block_batch_get(batch, hit, candidate);
+        search_report(ctx, 0, candidate);
+        ctx->checked += hit + 1;
+        return 1;
+    }
+    ctx->checked += batch->count;
+    return 0;
+}
+
+/**
+ * Busca em lotes de blocos completos: o gerador grava cada candidato direto
+ * no lote (md5_block_batch_t) e o lote inteiro é testado pelo kernel SIMD
+ */
+static int search_batched(search_ctx_t *ctx, candidate_gen_t *gen, long long total) {
+    const search_job_t *job = ctx->job;
+    md5_block_batch_t *batch = &ctx->batch;
+    int found = 0;
+
+    if (ctx->salt != NULL) {
+        md5_block_batch_init_salted(batch, &ctx->salted);
+    } else {
+        md5_block_batch_init(batch, gen->len);
+    }
+
+    // Verificação de parada: um load da flag compartilhada por lote, sem syscall
+    while (!shared_state_done(job->shared)) {
+        if (candidate_gen_fill(gen, batch) == 0) {
+            break;
+        }
+        int hits = search_test_batch(ctx, batch);
+        found += hits;
+        if (hits > 0 && ctx->set == NULL) {
+            break;
+        }
+        progress_update(&ctx->progress, ctx->worker_id, ctx->checked, total, gen->current);
+    }
+    return found;
+}
+
+/**
+ * Busca incremental: para cada prefixo (len - 1 primeiros caracteres), o
+ * último caractere percorre o charset direto sobre o bloco MD5 em cache
+ * (md5_incremental_*), sem montar strings nem refazer os passos iniciais
+ */
+static int search_incremental(search_ctx_t *ctx, candidate_gen_t *gen, long long total) {
+    const search_job_t *job = ctx->job;
+    md5_incremental_t *inc = &ctx->inc;
+    char prefix[MD5_SINGLE_BLOCK_MAX + 1];
+    int last_pos = gen->len - 1;
+    const char *last_charset = gen->charset[last_pos];
+    int first, count;
+    int found = 0;
+
+    if (ctx->salt != NULL) {
+        md5_incremental_init_salted(inc, &ctx->salted);
+    } else {
+        md5_incremental_init(inc, gen->len);
+    }
+
+    while (!shared_state_done(job->shared) &&
+           candidate_gen_next_run(gen, prefix, &first, &count)) {
+        if (TRACE_ENABLED()) {
+            for (int i = 0; i < count; i++) {
+                printf("[Worker %d] testando senha: %.*s%c\n", ctx->worker_id, last_pos,
+                       prefix, last_charset[first + i]);
+            }
+        }
+
+        md5_incremental_set_prefix(inc, prefix);
+        if (ctx->set != NULL) {
+            // md5_incremental_find_set aceita no máximo MD5_BATCH_MAX por chamada
+            for (int off = 0; off < count; off += MD5_BATCH_MAX) {
+                int n = count - off < MD5_BATCH_MAX ? count - off : MD5_BATCH_MAX;
+                int hits = md5_incremental_find_set(inc, last_charset + first + off, n,
+                                                    ctx->set, ctx->hits);
+                ctx->batches++;
+                for (int i = 0; i < hits; i++) {
+                    prefix[last_pos] = last_charset[first + off + ctx->hits[i].index];
+                    search_report(ctx, ctx->hits[i].target, prefix);
+                }
+                found += hits;
+            }
+        } else {
+            int hit = md5_incremental_find(inc, last_charset + first, count, ctx->target);
+            ctx->batches++;
+            if (hit >= 0) {
+                prefix[last_pos] = last_charset[first + hit];
+                search_report(ctx, 0, prefix);
+                ctx->checked += hit + 1;
+                return 1;
+            }
+        }
+        ctx->checked += count;
+        progress_update(&ctx->progress, ctx->worker_id, ctx->checked, total, prefix);
+    }
+    return found;
+}
+
+int search_range(search_ctx_t *ctx, candidate_gen_t *gen) {
+    long long total = ctx->expected > 0 ? ctx->expected : ctx->checked + gen->remaining;
+
+    // Modo incremental só compensa se o charset da última posição enche as lanes do kernel SIMD
+    if (ctx->job->algo == HASH_MD5 && gen->radix[gen->len - 1] >= md5_kernel_lanes()) {
+        return search_incremental(ctx, gen, total);
+    }
+    return search_batched(ctx, gen, total);
+}
+
+/**
+ * Algum alvo do grupo ainda não foi encontrado?
+ */
+static int search_salt_pending(const search_ctx_t *ctx, const search_salt_t *salt) {
+    for (int k = 0; k < salt->count; k++) {
+        if (!atomic_load_explicit(&ctx->job->shared->cracks[salt->index[k]].claimed,
+                                  memory_order_relaxed)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Passa a testar os alvos do grupo salt em candidatos de comprimento len:
+ * monta o bloco final do sal e reverte o alvo sobre ele (o conjunto, com
+ * vários alvos, já foi montado em search_job_prepare)
+ */
+static void search_salt_select(search_ctx_t *ctx, const search_salt_t *salt, int len) {
+    ctx->salt = salt;
+    md5_salted_init(&ctx->salted, ctx->job->spec, salt->target.salt, salt->target.salt_len, len);
+    if (salt->set != NULL) {
+        ctx->target = NULL;
+        ctx->set = &salt->set[len];
+    } else {
+        ctx->salted_target = salt->target;
+        md5_target_reverse_salted(&ctx->salted_target, &ctx->salted);
+        ctx->target = &ctx->salted_target;
+        ctx->set = NULL;
+    }
+}
+
+/**
+ * Percorre o trecho [index, index + n) do segmento uma vez por sal pendente
+ *
+ * ctx->checked avança n (candidatos, como sem sal) só se todos os sais
+ * terminaram o trecho; se a busca parou no meio, não avança, e o chunk fica
+ * pendente para o checkpoint.
+ */
+static void search_salts(search_ctx_t *ctx, const keyspace_segment_t *seg, keyspace_index_t index,
+                         long long n) {
+    const search_job_t *job = ctx->job;
+    long long before = ctx->checked;
+    candidate_gen_t gen;
+    int s;
+
+    for (s = 0; s < job->num_salts && !shared_state_done(job->shared); s++) {
+        if (!search_salt_pending(ctx, &job->salts[s]) ||
+            candidate_gen_init(&gen, seg->charset, seg->radix, seg->len, index, n) != 0) {
+            continue;
+        }
+        search_salt_select(ctx, &job->salts[s], seg->len);
+        ctx->checked = before;
+        search_range(ctx, &gen);
+    }
+    ctx->checked = s == job->num_salts && !shared_state_done(job->shared) ? before + n : before;
+    ctx->salt = NULL;
+}
+
+/**
+ * Áreas de trabalho do modo wordlist (uma por worker/thread): as palavras
+ * do lote atual, o lote transformado por uma regra e um lote de blocos MD5
+ * por comprimento de candidato
+ */
+typedef struct {
+    const char *words[RULES_BATCH];
+    int lens[RULES_BATCH];
+    rule_batch_t out;
+    md5_block_batch_t bucket[MD5_SINGLE_BLOCK_MAX + 1];
+} search_wordlist_t;
+
+/**
+ * Testa o lote de um comprimento com cada sal pendente: os candidatos são
+ * copiados para o lote do bloco final de cada sal
+ */
+static int search_flush_salts(search_ctx_t *ctx, const md5_block_batch_t *bucket) {
+    const search_job_t *job = ctx->job;
+    char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+    long long before = ctx->checked;
+    int hits = 0;
+
+    for (int s = 0; s < job->num_salts && !shared_state_done(job->shared); s++) {
+        if (!search_salt_pending(ctx, &job->salts[s])) {
+            continue;
+        }
+        search_salt_select(ctx, &job->salts[s], bucket->len);
+        md5_block_batch_init_salted(&ctx->batch, &ctx->salted);
+        for (int i = 0; i < bucket->count; i++) {
+            md5_block_batch_get(bucket, i, candidate);
+            md5_block_batch_set(&ctx->batch, i, candidate);
+        }
+        ctx->batch.count = bucket->count;
+        hits += search_test_batch(ctx, &ctx->batch);
+    }
+    ctx->checked = before + bucket->count;
+    ctx->salt = NULL;
+    return hits;
+}
+
+/**
+ * Testa o lote de um comprimento (com os alvos desse comprimento) e o esvazia
+ */
+static int search_flush_bucket(search_ctx_t *ctx, md5_block_batch_t *bucket) {
+    const search_job_t *job = ctx->job;
+
+    if (bucket->count == 0) {
+        return 0;
+    }
+    if (job->spec != MD5_SPEC_PLAIN) {
+        int hits = search_flush_salts(ctx, bucket);
+        bucket->count = 0;
+        return hits;
+    }
+    ctx->target = &job->target[bucket->len];
+    ctx->set = job->multi ? &job->set[bucket->len] : NULL;
+    int hits = search_test_batch(ctx, bucket);
+    bucket->count = 0;
+    return hits;
+}
+
+/**
+ * Percorre as linhas que começam no intervalo de bytes [start, end) da
+ * wordlist, aplicando cada regra a lotes de RULES_BATCH palavras
+ */
+static int search_wordlist(search_ctx_t *ctx, search_wordlist_t *ws, long long start, long long end) {
+    const search_job_t *job = ctx->job;
+    const rule_set_t *rules = job->rules;
+    long long pos, limit;
+    int found = 0;
+
+    wordlist_align(job->wordlist, start, end, &pos, &limit);
+
+    while (pos < limit && !shared_state_done(job->shared)) {
+        long long batch_start = pos;
+        int n = wordlist_next_batch(job->wordlist, &pos, limit, ws->words, ws->lens, RULES_BATCH);
+
+        for (int r = 0; r < rules->count; r++) {
+            // A regra ":" usa as palavras direto do mapeamento, sem cópia
+            const rule_t *rule = &rules->rules[r];
+            if (rule->num_ops > 0) {
+                rules_apply_batch(rule, ws->words, ws->lens, n, &ws->out);
+            }
+
+            for (int i = 0; i < n; i++) {
+                int len = rule->num_ops > 0 ? ws->out.len[i] : ws->lens[i];
+                if (len < job->min_len || len > job->max_len) {
+                    continue;
+                }
+                // md5_block_batch_set só lê os len bytes do candidato (sem '\0')
+                md5_block_batch_t *bucket = &ws->bucket[len];
+                md5_block_batch_set(bucket, bucket->count++,
+                                    rule->num_ops > 0 ? ws->out.word[i] : ws->words[i]);
+                if (bucket->count == MD5_BATCH_MAX) {
+                    int hits = search_flush_bucket(ctx, bucket);
+                    found += hits;
+                    if (hits > 0 && shared_state_done(job->shared)) {
+                        return found;
+                    }
+                }
+            }
+        }
+
+        // Progresso em bytes da wordlist, mostrado como senhas estimadas
+        char current[RULES_WORD_MAX];
+        int current_len = n > 0 && ws->lens[0] < RULES_WORD_MAX ? ws->lens[0] : 0;
+        memcpy(current, ws->words[0], current_len);
+        current[current_len] = '\0';
+        ctx->consumed += pos - batch_start;
+        long long total = (long long)((double)ctx->checked / ctx->consumed * ctx->expected);
+        progress_update(&ctx->progress, ctx->worker_id, ctx->checked, total, current);
+    }
+
+    // Lotes incompletos: testados antes de devolver o chunk
+    for (int len = job->min_len; len <= job->max_len; len++) {
+        int hits = search_flush_bucket(ctx, &ws->bucket[len]);
+        found += hits;
+        if (hits > 0 && shared_state_done(job->shared)) {
+            break;
+        }
+    }
+    return found;
+}
+
+/**
+ * Devolver a thread ao pool do daemon antes do próximo chunk?
+ */
+static inline int search_yield(const search_ctx_t *ctx) {
+    const search_job_t *job = ctx->job;
+    return job->yield != NULL && job->yield(job->yield_arg, ctx->worker_id);
+}
+
+/**
+ * Registra na instrumentação o chunk que acabou de ser concluído, com os
+ * instantes tomados pelo escalonador (nenhuma leitura extra do relógio)
+ */
+static void search_instr_chunk(search_ctx_t *ctx, const sched_local_t *local, long long start,
+                               long long count, long long checked) {
+    const scheduler_t *sched = &ctx->job->shared->sched;
+    if (ctx->worker_id >= 0 && ctx->worker_id < SCHED_MAX_WORKERS) {
+        instr_chunk(&ctx->instr, local->chunk_start, sched->workers[ctx->worker_id].finish,
+                    start, count, checked);
+    }
+}
+
+/**
+ * Laço do modo wordlist: os chunks do escalonador são intervalos de bytes
+ */
+static int search_wordlist_run(search_ctx_t *ctx) {
+    const search_job_t *job = ctx->job;
+    scheduler_t *sched = &job->shared->sched;
+    sched_local_t local;
+    long long start, count;
+
+    search_wordlist_t *ws = aligned_alloc(SHARED_CACHE_LINE, sizeof(search_wordlist_t));
+    if (ws == NULL) {
+        perror("Erro ao alocar lotes da wordlist");
+        return ctx->found;
+    }
+    for (int len = job->min_len; len <= job->max_len; len++) {
+        md5_block_batch_init(&ws->bucket[len], len);
+    }
+
+    scheduler_local_init(&local, ctx->worker_id);
+    ctx->expected = (sched->end - atomic_load(&sched->cursor)) / sched->num_workers;
+
+    // Posições do escalonador contadas a partir de job->base (o byte de um --resume)
+    long long base = (long long)job->base;
+    while (!shared_state_done(job->shared) && !search_yield(ctx) &&
+           scheduler_next(sched, &local, &start, &count)) {
+        search_wordlist(ctx, ws, base + start, base + start + count);
+        long long done = shared_state_done(job->shared) ? 0 : count;
+        scheduler_complete(sched, &local, done);
+        search_instr_chunk(ctx, &local, start, count, done);
+    }
+    free(ws);
+    return ctx->found;
+}
+
+/**
+ * Laço da força bruta/máscara: os chunks são índices do espaço combinado
+ */
+static int search_keyspace_run(search_ctx_t *ctx) {
+    const search_job_t *job = ctx->job;
+    const keyspace_t *ks = job->keyspace;
+    scheduler_t *sched = &job->shared->sched;
+    sched_local_t local;
+    candidate_gen_t gen;
+    keyspace_segment_t seg;
+    long long start, count;
+
+    scheduler_local_init(&local, ctx->worker_id);
+    ctx->expected = (sched->end - atomic_load(&sched->cursor)) / sched->num_workers;
+
+    while (!shared_state_done(job->shared) && !search_yield(ctx) &&
+           scheduler_next(sched, &local, &start, &count)) {
+        long long before = ctx->checked;
+        long long claimed = count;
+
+        // Um trecho por comprimento (ou por faixa, na ordem por probabilidade): o
+        // chunk é dividido nas fronteiras de keyspace_segment (índices globais de
+        // 128 bits; os trechos cabem no chunk, de 64)
+        keyspace_index_t global = job->base + start;
+        while (count > 0 && !shared_state_done(job->shared)) {
+            keyspace_index_t index;
+            keyspace_segment(ks, global, &seg, &index);
+            long long n = seg.size - index < count ? (long long)(seg.size - index) : count;
+
+            if (job->spec != MD5_SPEC_PLAIN) {
+                search_salts(ctx, &seg, index, n);
+            } else {
+                if (candidate_gen_init(&gen, seg.charset, seg.radix, seg.len, index, n) != 0) {
+                    break;
+                }
+                ctx->target = &job->target[seg.len];
+                ctx->set = job->multi ? &job->set[seg.len] : NULL;
+                search_range(ctx, &gen);
+            }
+
+            global += n;
+            count -= n;
+        }
+        scheduler_complete(sched, &local, ctx->checked - before);
+        search_instr_chunk(ctx, &local, start, claimed, ctx->checked - before);
+    }
+    return ctx->found;
+}
+
+int search_job_run(search_ctx_t *ctx) {
+    const search_job_t *job = ctx->job;
+    instr_worker_t *slot = ctx->worker_id >= 0 && ctx->worker_id < SCHED_MAX_WORKERS ?
+                           &job->shared->instr[ctx->worker_id] : NULL;
+
+    instr_begin(&ctx->instr, slot, job->trace_path, ctx->worker_id, job->perf, ctx->origin);
+    int found = job->wordlist != NULL ? search_wordlist_run(ctx) : search_keyspace_run(ctx);
+    instr_end(&ctx->instr, ctx->batches);
+    return found;
+}
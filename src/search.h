@@ -0,0 +1,169 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "hash_utils.h"
+#include "hash_algo.h"
+#include "candidate_gen.h"
+#include "progress.h"
+#include "shared_state.h"
+#include "keyspace.h"
+#include "wordlist.h"
+#include "rules.h"
+
+/**
+ * Laço de busca - Mini-Projeto 1
+ *
+ * É o mesmo código para os dois modelos de execução: o processo worker
+ * (fork + execl) e as threads do coordinator (--threads). Todo o estado
+ * mutável fica em search_ctx_t, uma instância por worker/thread, alinhada
+ * em linha de cache para que threads vizinhas não disputem as mesmas linhas.
+ *
+ * Os intervalos vêm do escalonador dinâmico (scheduler.h) em shared->sched,
+ * em índices do espaço combinado (keyspace.h). Um chunk que cruza a fronteira
+ * entre dois comprimentos é percorrido em dois trechos, cada um com o
+ * gerador e os kernels do seu comprimento.
+ *
+ * No modo wordlist (--wordlist), os chunks são intervalos de bytes do
+ * arquivo mapeado: as palavras passam pelas regras em lotes e cada
+ * candidato vai para o lote de blocos MD5 do seu comprimento, testado pelo
+ * kernel SIMD quando enche (e no fim do chunk).
+ *
+ * Cada senha encontrada é publicada no slot do seu alvo assim que aparece;
+ * com vários alvos (--hash-file) a busca segue até o espaço acabar ou o
+ * último alvo ser encontrado.
+ *
+ * Cada chunk concluído é registrado na instrumentação (instrument.h) com os
+ * instantes que o escalonador já mede; o laço por candidato só conta lotes.
+ *
+ * Nos formatos com sal (--hash-spec), os alvos são agrupados pelo sal e
+ * cada trecho é percorrido uma vez por sal ainda pendente, com o bloco final
+ * daquele sal (md5_salted_t) montado uma vez por trecho; os sais de um
+ * mesmo chunk saem do mesmo escalonador, que conta candidatos (não pares
+ * candidato/sal).
+ *
+ * Com outro algoritmo (--algo, hash_algo.h), os candidatos vão pelos mesmos
+ * lotes de blocos, testados pelos kernels do algoritmo: sem modo
+ * incremental e sem reversão dos alvos.
+ */
+
+/**
+ * Alvos que compartilham um sal
+ */
+typedef struct {
+    md5_target_t target;        // Primeiro alvo do grupo (o único, com count == 1)
+    int count;                  // Alvos com este sal
+    const int *index;           // Slot (shared->cracks) de cada alvo do grupo
+    md5_target_set_t *set;      // Com count > 1: um conjunto por comprimento ([len])
+} search_salt_t;
+
+/**
+ * Parâmetros de um job, comuns a todos os workers/threads (só leitura)
+ */
+typedef struct {
+    const keyspace_t *keyspace;     // Charsets por posição (NULL no modo wordlist)
+    const wordlist_t *wordlist;     // Wordlist mapeada (--wordlist) ou NULL
+    const rule_set_t *rules;        // Regras aplicadas a cada palavra da wordlist
+    int min_len, max_len;           // Comprimentos dos candidatos com alvos preparados
+    int multi;                      // Vários alvos (--hash-file): usa set[] em vez de target[]
+    int algo;                       // hash_algo_id_t (--algo); fora do MD5, só lotes de blocos
+    int spec;                       // md5_spec_t: com sal, os alvos ficam em salts[]
+    int num_salts;
+    search_salt_t *salts;           // Alvos agrupados por sal (spec != MD5_SPEC_PLAIN)
+    int *salt_index;                // Slots de todos os grupos (search_salt_t.index)
+    keyspace_index_t base;          // Índice (ou byte) da posição 0 do escalonador (keyspace_window)
+    // Alvos revertidos para cada comprimento (a reversão depende do comprimento)
+    md5_target_t target[MD5_SINGLE_BLOCK_MAX + 1];
+    md5_target_set_t set[MD5_SINGLE_BLOCK_MAX + 1];
+    shared_state_t *shared;         // Flag de parada, resultados e escalonador
+    const char *trace_path;         // --trace: fragmentos do trace (NULL = desligado)
+    int perf;                       // --perf: contadores de hardware por worker
+    // Pool do daemon (daemon.h): consultado entre um chunk e o próximo; 1 = a
+    // thread volta ao pool e o restante do job continua no escalonador
+    int (*yield)(void *arg, int worker_id);
+    void *yield_arg;
+} search_job_t;
+
+typedef struct {
+    _Alignas(SHARED_CACHE_LINE)
+    // Entrada
+    const search_job_t *job;
+    int worker_id;
+
+    long long expected;         // Senhas (bytes, no modo wordlist) esperadas para este worker
+    long long consumed;         // Bytes da wordlist já percorridos (% do progresso)
+
+    // Alvos do comprimento do trecho atual (apontam para job->target/job->set)
+    const md5_target_t *target;
+    const md5_target_set_t *set;
+
+    // Sal do trecho atual (NULL = sem sal): bloco final e o alvo revertido sobre ele
+    const search_salt_t *salt;
+    md5_salted_t salted;
+    md5_target_t salted_target;
+
+    // Saída
+    long long checked;                          // Senhas verificadas
+    long long batches;                          // Chamadas aos kernels (instrument.h)
+    int found;                                  // Senhas encontradas
+    char password[MD5_SINGLE_BLOCK_MAX + 1];    // Última senha encontrada
+
+    double origin;              // Início do worker (padrão: search_init) para a instrumentação
+    instr_t instr;
+
+    // Estado interno do laço
+    progress_t progress;
+    md5_incremental_t inc;
+    md5_block_batch_t batch;
+    md5_hit_t hits[MD5_BATCH_MAX];
+} search_ctx_t;
+
+/**
+ * Prepara os alvos do job para cada comprimento de min_len a max_len (o
+ * chamador completa job->keyspace ou job->wordlist/job->rules)
+ *
+ * @param targets Alvos decodificados (hash_target_parse/hash_target_from_digest)
+ * @param num_targets Número de alvos
+ * @param multi 1 = conjunto de alvos (md5_target_set_t), 0 = só targets[0]
+ * @param algo hash_algo_id_t; max_len não pode passar do max_len do algoritmo
+ * @param spec md5_spec_t; com sal, max_len não pode passar de md5_spec_max_len
+ *             para nenhum dos alvos
+ * @return 0 em caso de sucesso, -1 se faltou memória para os conjuntos
+ */
+int search_job_prepare(search_job_t *job, int min_len, int max_len, const md5_target_t *targets,
+                       int num_targets, int multi, int algo, int spec, shared_state_t *shared);
+
+/**
+ * Libera os conjuntos de alvos criados por search_job_prepare
+ */
+void search_job_free(search_job_t *job);
+
+/**
+ * Prepara o contexto de um worker/thread (ctx->origin pode ser antecipado
+ * pelo chamador, para que a inicialização inclua o que veio antes)
+ */
+void search_init(search_ctx_t *ctx, const search_job_t *job, int worker_id);
+
+/**
+ * Percorre todo o intervalo do gerador (ou até a flag de parada ser ligada)
+ * com os alvos de ctx->target/ctx->set, que devem ser os do comprimento
+ * do gerador
+ *
+ * Usa o modo incremental (só no MD5) quando o charset da última posição enche as lanes do kernel SIMD e o
+ * modo de lotes de blocos completos caso contrário; com ctx->salt, os dois
+ * modos usam o bloco final ctx->salted.
+ *
+ * @return Número de senhas encontradas (e publicadas) neste intervalo
+ */
+int search_range(search_ctx_t *ctx, candidate_gen_t *gen);
+
+/**
+ * Laço de um worker: retira chunks do escalonador do job e percorre cada
+ * um com search_range (um trecho por comprimento), ou pelas palavras da
+ * wordlist, até o espaço acabar, todos os alvos serem achados ou job->yield
+ * pedir a thread de volta
+ *
+ * @return Número de senhas encontradas por este worker (ctx->found)
+ */
+int search_job_run(search_ctx_t *ctx);
+
+#endif // SEARCH_H
@@ -0,0 +1,79 @@
+#define _GNU_SOURCE
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shared_state.h"
+
+static size_t shared_state_size(int num_targets) {
+    return sizeof(shared_state_t) + (size_t)num_targets * sizeof(shared_crack_t);
+}
+
+shared_state_t *shared_state_create(int num_targets, int *fd_out) {
+    // Sem MFD_CLOEXEC: o descritor precisa sobreviver ao execl() dos workers
+    int fd = memfd_create("quebra-senhas-estado", 0);
+    if (fd == -1) {
+        return NULL;
+    }
+    if (ftruncate(fd, shared_state_size(num_targets)) == -1) {
+        close(fd);
+        return NULL;
+    }
+
+    shared_state_t *state = shared_state_attach(fd);
+    if (state == NULL) {
+        close(fd);
+        return NULL;
+    }
+    state->num_targets = num_targets;
+    atomic_store_explicit(&state->remaining, num_targets, memory_order_relaxed);
+    *fd_out = fd;
+    return state;
+}
+
+shared_state_t *shared_state_attach(int fd) {
+    // O tamanho (número de alvos) vem do próprio memfd
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(shared_state_t)) {
+        return NULL;
+    }
+    void *addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return addr == MAP_FAILED ? NULL : (shared_state_t*)addr;
+}
+
+void shared_state_destroy(shared_state_t *state, int fd) {
+    munmap(state, shared_state_size(state->num_targets));
+    close(fd);
+}
+
+void shared_state_set_target(shared_state_t *state, int i, const md5_target_t *target) {
+    shared_crack_t *crack = &state->cracks[i];
+    memcpy(crack->digest, target->digest, HASH_DIGEST_MAX);
+    crack->salt_len = target->salt_len;
+    memcpy(crack->salt, target->salt, target->salt_len);
+}
+
+void shared_state_get_target(const shared_state_t *state, int i, int algo, md5_target_t *target) {
+    const shared_crack_t *crack = &state->cracks[i];
+    hash_target_from_digest(algo, crack->digest, target);
+    target->salt_len = crack->salt_len;
+    memcpy(target->salt, crack->salt, crack->salt_len);
+}
+
+int shared_state_publish(shared_state_t *state, int target, int worker_id, const char *password) {
+    shared_crack_t *crack = &state->cracks[target];
+    int expected = 0;
+    int won = atomic_compare_exchange_strong(&crack->claimed, &expected, 1);
+
+    if (won) {
+        crack->worker_id = worker_id;
+        strncpy(crack->password, password, MD5_SINGLE_BLOCK_MAX);
+        crack->password[MD5_SINGLE_BLOCK_MAX] = '\0';
+        atomic_store_explicit(&crack->ready, 1, memory_order_release);
+
+        // Último alvo pendente: todos param
+        if (atomic_fetch_sub(&state->remaining, 1) == 1) {
+            atomic_store_explicit(&state->done, 1, memory_order_release);
+        }
+    }
+    return won;
+}
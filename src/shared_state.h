@@ -0,0 +1,108 @@
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <stdatomic.h>
+#include "hash_utils.h"
+#include "hash_algo.h"
+#include "scheduler.h"
+#include "instrument.h"
+
+/**
+ * Estado compartilhado entre coordinator e workers - Mini-Projeto 1
+ *
+ * O coordinator cria a região (MAP_SHARED) antes do fork(). Como o worker
+ * é carregado com execl(), um mmap anônimo não sobreviveria: a região é
+ * um memfd cujo descritor é herdado pelo exec e informado ao worker com
+ * --shm-fd=N, e o worker o mapeia de novo.
+ *
+ * - done: flag de parada, lida pelos workers com um load simples por lote;
+ *   ligada quando o último alvo é encontrado
+ * - cracks[]: um slot de resultado por alvo (1 no modo normal, N com
+ *   --hash-file), com o digest (e o sal) do alvo; compare-and-swap em claimed garante
+ *   que só um worker grava cada slot, e ready (release) só é ligado depois
+ *   da senha escrita
+ * - sched: cursor de chunks e estatísticas por worker (scheduler.h)
+ * - instr: contadores de cada worker, gravados no fim (instrument.h)
+ */
+
+#define SHARED_CACHE_LINE 64
+
+/**
+ * Slot de resultado de um alvo, escrito uma única vez
+ */
+typedef struct {
+    _Alignas(SHARED_CACHE_LINE) atomic_int claimed;
+    atomic_int ready;
+    int worker_id;
+    uint8_t digest[HASH_DIGEST_MAX];            // Alvo (preenchido pelo coordinator)
+    int salt_len;                               // Sal do alvo (--hash-spec com sal)
+    uint8_t salt[MD5_SALT_MAX];
+    char password[MD5_SINGLE_BLOCK_MAX + 1];
+} shared_crack_t;
+
+typedef struct {
+    // Lido por todos os workers a cada lote: fica sozinho na sua linha de cache
+    _Alignas(SHARED_CACHE_LINE) atomic_int done;
+
+    _Alignas(SHARED_CACHE_LINE) atomic_int remaining;   // Alvos ainda não encontrados
+    int num_targets;
+
+    // Distribuição dinâmica do espaço de busca
+    scheduler_t sched;
+
+    // Contadores de instrumentação por worker
+    instr_worker_t instr[SCHED_MAX_WORKERS];
+
+    shared_crack_t cracks[];
+} shared_state_t;
+
+/**
+ * Cria a região compartilhada (zerada) no coordinator
+ *
+ * @param num_targets Número de alvos (slots de resultado, >= 1); os digests
+ *                    são gravados depois em cracks[i].digest
+ * @param fd_out Saída: descritor a repassar aos workers (herdado pelo exec)
+ * @return Ponteiro para a região, ou NULL em caso de erro (errno preservado)
+ */
+shared_state_t *shared_state_create(int num_targets, int *fd_out);
+
+/**
+ * Mapeia no worker a região criada pelo coordinator
+ *
+ * @return Ponteiro para a região, ou NULL se o descritor for inválido
+ */
+shared_state_t *shared_state_attach(int fd);
+
+/**
+ * Desfaz o mapeamento e fecha o descritor (nó distribuído, entre um job e
+ * o próximo; coordinator e workers simplesmente terminam)
+ */
+void shared_state_destroy(shared_state_t *state, int fd);
+
+/**
+ * Grava o alvo (digest e sal) no slot i, no coordinator
+ */
+void shared_state_set_target(shared_state_t *state, int i, const md5_target_t *target);
+
+/**
+ * Decodifica o alvo do slot i (digest e sal), nos workers, como hash do
+ * algoritmo algo (hash_algo_id_t)
+ */
+void shared_state_get_target(const shared_state_t *state, int i, int algo, md5_target_t *target);
+
+/**
+ * Publica a senha encontrada para o alvo target; quando é o último alvo
+ * pendente, sinaliza parada para todos
+ *
+ * @return 1 se este worker foi o primeiro a publicar esse alvo, 0 caso contrário
+ */
+int shared_state_publish(shared_state_t *state, int target, int worker_id, const char *password);
+
+/**
+ * Verificação de parada do laço principal: um load relaxed, sem syscall
+ */
+static inline int shared_state_done(shared_state_t *state) {
+    return atomic_load_explicit(&state->done, memory_order_relaxed);
+}
+
+#endif // SHARED_STATE_H
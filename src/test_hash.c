@@ -1,13 +1,14 @@
 #include <stdio.h>
 #include <string.h>
 #include "hash_utils.h"
+#include "hash_algo.h"
 
 /**
  * Programa de teste para verificar a implementação MD5
  * 
  * Uso:
  *   ./test_hash           - Executa testes padrão
- *   ./test_hash "string"  - Calcula MD5 de uma string específica
+ *   ./test_hash "string"  - Calcula MD5 (e os outros algoritmos de hash_algo.h) de uma string
  */
 
 typedef struct {
@@ -15,6 +16,370 @@ typedef struct {
     const char *expected_hash;
 } TestCase;
 
+/**
+ * Testa o caminho rápido de bloco único (md5_block_batch_*) em todos os
+ * comprimentos de 1 a MD5_SINGLE_BLOCK_MAX: o alvo é colocado numa lane
+ * diferente a cada comprimento, cercado de candidatos que não batem.
+ * 
+ * @return Número de falhas
+ */
+static int test_block_batch(void) {
+    static md5_block_batch_t batch;
+    // 64 símbolos: o primeiro caractere já distingue todas as lanes
+    const char *alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789+/";
+    int failures = 0;
+    
+    for (int len = 1; len <= MD5_SINGLE_BLOCK_MAX; len++) {
+        char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+        char hash[33];
+        md5_target_t target;
+        int target_lane = (len * 7) % MD5_BATCH_MAX;
+        
+        md5_block_batch_init(&batch, len);
+        batch.count = MD5_BATCH_MAX;
+        for (int l = 0; l < MD5_BATCH_MAX; l++) {
+            for (int i = 0; i < len; i++) {
+                candidate[i] = alphabet[(i + l) % 64];
+            }
+            candidate[len] = '\0';
+            md5_block_batch_set(&batch, l, candidate);
+            if (l == target_lane) {
+                md5_string(candidate, hash);
+                md5_target_parse(hash, &target);
+            }
+        }
+        
+        // Digests do lote inteiro (md5_block_batch_digests): a lane do alvo tem as palavras dele
+        static uint32_t words[4][MD5_BATCH_MAX];
+        md5_block_batch_digests(&batch, words);
+        for (int w = 0; w < 4; w++) {
+            if (words[w][target_lane] != target.words[w]) {
+                printf("  Digests do lote, tamanho %d: palavra %d da lane %d diferente\n",
+                       len, w, target_lane);
+                failures++;
+                break;
+            }
+        }
+        
+        // Comprimentos ímpares usam o alvo revertido; pares, o estado final
+        if (len % 2 == 1) {
+            md5_target_reverse(&target, len);
+        }
+        
+        int found = md5_block_batch_find(&batch, &target);
+        md5_block_batch_get(&batch, target_lane, candidate);
+        md5_string(candidate, hash);
+        
+        // Candidato fora de batch->count nunca deve ser reportado
+        batch.count = target_lane;
+        if (found != target_lane || md5_block_batch_find(&batch, &target) != -1) {
+            printf("  Lote de bloco único, tamanho %d: esperado lane %d, obtido %d\n",
+                   len, target_lane, found);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * Testa o modo incremental (md5_incremental_*): prefixo fixo e o último
+ * caractere percorrendo um alfabeto, em todos os comprimentos de bloco único
+ * 
+ * @return Número de falhas
+ */
+static int test_incremental(void) {
+    const char *alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789+/";
+    md5_incremental_t inc;
+    int failures = 0;
+    
+    for (int len = 1; len <= MD5_SINGLE_BLOCK_MAX; len++) {
+        char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+        char hash[33];
+        md5_target_t target;
+        int target_index = (len * 5) % 64;
+        // Contagem variável para exercitar lotes parciais
+        int count = target_index + 1 + len % 3;
+        
+        for (int i = 0; i < len; i++) {
+            candidate[i] = alphabet[(i * 3) % 64];
+        }
+        candidate[len - 1] = alphabet[target_index];
+        candidate[len] = '\0';
+        md5_string(candidate, hash);
+        md5_target_parse(hash, &target);
+        if (len % 2 == 0) {
+            md5_target_reverse(&target, len);
+        }
+        
+        md5_incremental_init(&inc, len);
+        md5_incremental_set_prefix(&inc, candidate);
+        int found = md5_incremental_find(&inc, alphabet, count, &target);
+        int missing = md5_incremental_find(&inc, alphabet, target_index, &target);
+        
+        if (found != target_index || missing != -1) {
+            printf("  Incremental, tamanho %d: esperado %d, obtido %d (sem o alvo: %d)\n",
+                   len, target_index, found, missing);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * Testa os formatos com sal (md5_salted_*): sal antes e depois da senha,
+ * curto (no bloco final) e longo (blocos inteiros comprimidos no iv), pelo
+ * modo incremental e pelo lote de blocos
+ * 
+ * @return Número de falhas
+ */
+static int test_salted(void) {
+    static md5_block_batch_t batch;
+    const char *alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789+/";
+    const int salt_lens[] = {0, 3, 20, 64, 70, 128};
+    md5_incremental_t inc;
+    md5_salted_t salted;
+    int failures = 0;
+    
+    for (int spec = MD5_SPEC_SALT_PASS; spec <= MD5_SPEC_PASS_SALT; spec++) {
+        for (int s = 0; s < (int)(sizeof(salt_lens) / sizeof(salt_lens[0])); s++) {
+            for (int len = 1; len <= md5_spec_max_len(spec, salt_lens[s]); len += 3) {
+                char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+                char hash[33];
+                md5_target_t target;
+                int target_index = (len * 5 + s) % 64;
+                
+                for (int i = 0; i < len; i++) {
+                    candidate[i] = alphabet[(i * 3 + s) % 64];
+                }
+                candidate[len - 1] = alphabet[target_index];
+                candidate[len] = '\0';
+                target.salt_len = salt_lens[s];
+                for (int i = 0; i < salt_lens[s]; i++) {
+                    target.salt[i] = (uint8_t)('!' + (i * 7) % 90);
+                }
+                md5_spec_string(spec, &target, candidate, hash);
+                int salt_len = target.salt_len;
+                md5_target_parse(hash, &target);
+                
+                md5_salted_init(&salted, spec, target.salt, salt_len, len);
+                md5_target_reverse_salted(&target, &salted);
+                md5_incremental_init_salted(&inc, &salted);
+                md5_incremental_set_prefix(&inc, candidate);
+                int found = md5_incremental_find(&inc, alphabet, 64, &target);
+                int missing = md5_incremental_find(&inc, alphabet, target_index, &target);
+                
+                md5_block_batch_init_salted(&batch, &salted);
+                batch.count = MD5_BATCH_MAX;
+                for (int l = 0; l < MD5_BATCH_MAX; l++) {
+                    candidate[len - 1] = alphabet[l];
+                    md5_block_batch_set(&batch, l, candidate);
+                }
+                int lane = md5_block_batch_find(&batch, &target);
+                md5_block_batch_get(&batch, target_index, candidate);
+                if (candidate[len - 1] != alphabet[target_index]) {
+                    lane = -2;
+                }
+                
+                if (found != target_index || missing != -1 || lane != target_index) {
+                    printf("  Com sal (%s, sal de %d bytes), tamanho %d: esperado %d, obtido %d/%d "
+                           "(sem o alvo: %d)\n", md5_spec_name(spec), salt_len, len, target_index,
+                           found, lane, missing);
+                    failures++;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+/**
+ * Testa o conjunto de alvos (md5_target_set_*): alguns alvos presentes no
+ * lote/no alfabeto, misturados a alvos que não batem com nenhum candidato;
+ * todos os acertos, e só eles, devem ser reportados com o alvo certo
+ * 
+ * @return Número de falhas
+ */
+static int test_target_set(void) {
+    static md5_block_batch_t batch;
+    const char *alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789+/";
+    enum { NUM_DECOYS = 100, NUM_TARGETS = NUM_DECOYS + 3 };
+    md5_target_t targets[NUM_TARGETS];
+    md5_hit_t hits[MD5_BATCH_MAX];
+    int failures = 0;
+    
+    for (int len = 1; len <= MD5_SINGLE_BLOCK_MAX; len++) {
+        char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+        char hash[33];
+        int lanes[3] = {len % MD5_BATCH_MAX, (len * 7 + 1) % MD5_BATCH_MAX, MD5_BATCH_MAX - 1};
+        if (lanes[1] == lanes[0] || lanes[1] == lanes[2]) {
+            lanes[1] = (lanes[1] + 2) % (MD5_BATCH_MAX - 1);
+        }
+        
+        // Alvos que não batem: MD5 de "#<i>" (fora do alfabeto)
+        for (int i = 0; i < NUM_DECOYS; i++) {
+            snprintf(candidate, sizeof(candidate), "#%d", i);
+            md5_string(candidate, hash);
+            md5_target_parse(hash, &targets[i]);
+        }
+        
+        md5_block_batch_init(&batch, len);
+        batch.count = MD5_BATCH_MAX;
+        for (int l = 0; l < MD5_BATCH_MAX; l++) {
+            for (int i = 0; i < len; i++) {
+                candidate[i] = alphabet[(i + l) % 64];
+            }
+            candidate[len] = '\0';
+            md5_block_batch_set(&batch, l, candidate);
+            for (int t = 0; t < 3; t++) {
+                if (l == lanes[t]) {
+                    md5_string(candidate, hash);
+                    md5_target_parse(hash, &targets[NUM_DECOYS + t]);
+                }
+            }
+        }
+        
+        md5_target_set_t set;
+        if (md5_target_set_init(&set, targets, NUM_TARGETS, len) != 0) {
+            printf("  Conjunto de alvos, tamanho %d: falta de memória\n", len);
+            return failures + 1;
+        }
+        
+        int found = md5_block_batch_find_set(&batch, &set, hits);
+        int wrong = found != 3;
+        for (int h = 0; h < found && !wrong; h++) {
+            int t = hits[h].target - NUM_DECOYS;
+            wrong = t < 0 || t > 2 || hits[h].index != lanes[t];
+        }
+        
+        // Incremental: o último caractere de cada alvo de lane percorre o alfabeto
+        md5_incremental_t inc;
+        md5_block_batch_get(&batch, lanes[0], candidate);
+        md5_incremental_init(&inc, len);
+        md5_incremental_set_prefix(&inc, candidate);
+        int inc_found = md5_incremental_find_set(&inc, alphabet, 64, &set, hits);
+        int expected_char = (len - 1 + lanes[0]) % 64;
+        int inc_ok = 0;
+        for (int h = 0; h < inc_found; h++) {
+            inc_ok |= hits[h].target == NUM_DECOYS && hits[h].index == expected_char;
+        }
+        wrong |= !inc_ok;
+        md5_target_set_free(&set);
+        
+        if (wrong) {
+            printf("  Conjunto de alvos, tamanho %d: %d acertos no lote, %d no incremental\n",
+                   len, found, inc_found);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * Vetores conhecidos dos outros algoritmos (RFC 1320, FIPS 180); os de
+ * mais de max_len bytes passam pelo caminho escalar de hash_batch
+ */
+typedef struct {
+    int algo;
+    const char *input;
+    const char *expected_hash;
+} AlgoCase;
+
+static const AlgoCase algo_tests[] = {
+    {HASH_MD4, "", "31d6cfe0d16ae931b73c59d7e0c089c0"},
+    {HASH_MD4, "abc", "a448017aaf21d8525fc10ae87aa6729d"},
+    {HASH_MD4, "message digest", "d9130a8164549fe818874806e1c7014b"},
+    {HASH_MD4, "12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+     "e33b4ddc9c38f2199c3e7b164fcc0536"},
+    {HASH_NTLM, "", "31d6cfe0d16ae931b73c59d7e0c089c0"},
+    {HASH_NTLM, "password", "8846f7eaee8fb117ad06bdd830b7586c"},
+    {HASH_SHA1, "abc", "a9993e364706816aba3e25717850c26c9cd0d89d"},
+    {HASH_SHA1, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+     "84983e441c3bd26ebaae4aa1f95129e5e54670f1"},
+    {HASH_SHA256, "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+    {HASH_SHA256, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+     "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+};
+
+/**
+ * Testa os algoritmos de hash_algo.h no kernel ativo: os vetores conhecidos
+ * (referência e hash_batch) e, em todos os comprimentos até max_len, a busca
+ * com alvo único e com conjunto de alvos, como test_block_batch e
+ * test_target_set
+ * 
+ * @return Número de falhas
+ */
+static int test_algorithms(void) {
+    static md5_block_batch_t batch;
+    const char *alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789+/";
+    enum { NUM_DECOYS = 20, NUM_TARGETS = NUM_DECOYS + 1 };
+    md5_target_t targets[NUM_TARGETS];
+    md5_hit_t hits[MD5_BATCH_MAX];
+    int num_cases = sizeof(algo_tests) / sizeof(algo_tests[0]);
+    int failures = 0;
+    
+    for (int i = 0; i < num_cases; i++) {
+        const char *input = algo_tests[i].input;
+        size_t len = strlen(input);
+        uint8_t digest[1][HASH_DIGEST_MAX];
+        char hash[HASH_HEX_MAX], batch_hash[HASH_HEX_MAX];
+        
+        hash_string(algo_tests[i].algo, input, hash);
+        hash_batch(algo_tests[i].algo, &input, &len, 1, digest);
+        hash_digest_to_hex(algo_tests[i].algo, digest[0], batch_hash);
+        if (strcmp(hash, algo_tests[i].expected_hash) != 0 ||
+            strcmp(batch_hash, algo_tests[i].expected_hash) != 0) {
+            printf("  %s(\"%s\"): %s / lote %s (esperado %s)\n", hash_algo_get(algo_tests[i].algo)->label,
+                   input, hash, batch_hash, algo_tests[i].expected_hash);
+            failures++;
+        }
+    }
+    
+    for (int algo = HASH_MD4; algo < HASH_ALGO_COUNT; algo++) {
+        const hash_algo_t *info = hash_algo_get(algo);
+        for (int len = 1; len <= info->max_len; len++) {
+            char candidate[MD5_SINGLE_BLOCK_MAX + 1];
+            char hash[HASH_HEX_MAX];
+            int target_lane = (len * 7) % MD5_BATCH_MAX;
+            
+            // Alvos que não batem: hash de "#<i>" (fora do alfabeto)
+            for (int i = 0; i < NUM_DECOYS; i++) {
+                snprintf(candidate, sizeof(candidate), "#%d", i);
+                hash_string(algo, candidate, hash);
+                hash_target_parse(algo, hash, &targets[i]);
+            }
+            
+            md5_block_batch_init(&batch, len);
+            batch.count = MD5_BATCH_MAX;
+            for (int l = 0; l < MD5_BATCH_MAX; l++) {
+                for (int i = 0; i < len; i++) {
+                    candidate[i] = alphabet[(i + l) % 64];
+                }
+                candidate[len] = '\0';
+                md5_block_batch_set(&batch, l, candidate);
+                if (l == target_lane) {
+                    hash_string(algo, candidate, hash);
+                    hash_target_parse(algo, hash, &targets[NUM_DECOYS]);
+                }
+            }
+            
+            int hit = hash_block_batch_find(algo, &batch, &targets[NUM_DECOYS]);
+            int found = -1;
+            md5_target_set_t set;
+            if (hash_target_set_init(algo, &set, targets, NUM_TARGETS, len) == 0) {
+                found = hash_block_batch_find_set(algo, &batch, &set, hits);
+                md5_target_set_free(&set);
+            }
+            if (hit != target_lane || found != 1 || hits[0].index != target_lane ||
+                hits[0].target != NUM_DECOYS) {
+                printf("  %s, tamanho %d: alvo na lane %d, achado na %d (%d no conjunto)\n",
+                       info->label, len, target_lane, hit, found);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
 int main(int argc, char *argv[]) {
     // Se argumentos fornecidos, calcula hash da string
     if (argc > 1) {
@@ -22,6 +387,12 @@ int main(int argc, char *argv[]) {
         md5_string(argv[1], hash);
         printf("Input: %s\n", argv[1]);
         printf("MD5:   %s\n", hash);
+        for (int algo = HASH_MD4; algo < HASH_ALGO_COUNT; algo++) {
+            char algo_hash[HASH_HEX_MAX];
+            hash_string(algo, argv[1], algo_hash);
+            const char *label = hash_algo_get(algo)->label;
+            printf("%s:%*s%s\n", label, 6 - (int)strlen(label), "", algo_hash);   // Alinhado com "MD5:"
+        }
         return 0;
     }
     
@@ -66,6 +437,54 @@ int main(int argc, char *argv[]) {
         printf("\n");
     }
     
+    // Mesmos casos via md5_batch, em cada kernel SIMD suportado por esta CPU
+    const char *kernel_names[] = {"scalar", "sse2", "avx2", "avx512"};
+    int num_cases = num_tests;
+    const char *inputs[sizeof(tests) / sizeof(TestCase)];
+    size_t lengths[sizeof(tests) / sizeof(TestCase)];
+    uint8_t digests[sizeof(tests) / sizeof(TestCase)][MD5_DIGEST_LENGTH];
+    
+    for (int i = 0; i < num_cases; i++) {
+        inputs[i] = tests[i].input;
+        lengths[i] = strlen(tests[i].input);
+    }
+    
+    printf("=== Teste do MD5 em Lote (multi-buffer) ===\n\n");
+    for (int k = 0; k < 4; k++) {
+        if (md5_select_kernel(kernel_names[k]) != 0) {
+            printf("Kernel %-7s não suportado nesta CPU (ignorado)\n", kernel_names[k]);
+            continue;
+        }
+        
+        md5_batch(inputs, lengths, num_cases, digests);
+        
+        int kernel_failed = test_block_batch() + test_incremental() + test_target_set() +
+                            test_salted() + test_algorithms();
+        // Mesmos testes no caminho genérico (sem as variantes por comprimento)
+        md5_select_specialized(0);
+        kernel_failed += test_block_batch() + test_incremental() + test_target_set();
+        md5_select_specialized(1);
+        for (int i = 0; i < num_cases; i++) {
+            char hash[33];
+            md5_digest_to_hex(digests[i], hash);
+            if (strcmp(hash, tests[i].expected_hash) != 0) {
+                printf("  Kernel %s: \"%s\" -> %s (esperado %s)\n",
+                       kernel_names[k], tests[i].input, hash, tests[i].expected_hash);
+                kernel_failed++;
+            }
+        }
+        
+        printf("Kernel %-7s (%2d lanes): %s\n", kernel_names[k], md5_kernel_lanes(),
+               kernel_failed == 0 ? "✓ PASSOU" : "✗ FALHOU");
+        if (kernel_failed == 0) {
+            passed++;
+        } else {
+            failed++;
+        }
+        num_tests++;
+    }
+    printf("\n");
+    
     printf("=== Resumo dos Testes ===\n");
     printf("Total:   %d\n", num_tests);
     printf("Passou:  %d\n", passed);
@@ -0,0 +1,165 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "thread_engine.h"
+
+#define MAX_NUMA_NODES 64
+
+/**
+ * Parâmetros de uma thread: uma linha de cache por thread, para que
+ * threads vizinhas não disputem as mesmas linhas
+ */
+typedef struct {
+    _Alignas(SHARED_CACHE_LINE)
+    pthread_t tid;
+    const search_job_t *job;
+    int id;
+    int cpu;            // CPU fixada (-1 = sem afinidade)
+    int node;           // Nó NUMA da CPU
+} thread_slot_t;
+
+int thread_engine_online_cpus(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+/**
+ * Acrescenta as CPUs de uma cpulist do /sys ("0-3,8-11") que o processo
+ * pode usar e que ainda não estão na lista
+ */
+static int add_cpulist(FILE *f, int node, const cpu_set_t *allowed, cpu_set_t *added,
+                       int *cpus, int *nodes, int n) {
+    int lo, hi;
+    while (fscanf(f, "%d", &lo) == 1) {
+        hi = lo;
+        int c = fgetc(f);
+        if (c == '-') {
+            if (fscanf(f, "%d", &hi) != 1) {
+                break;
+            }
+            c = fgetc(f);
+        }
+        for (int cpu = lo; cpu <= hi && cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, allowed) && !CPU_ISSET(cpu, added)) {
+                CPU_SET(cpu, added);
+                cpus[n] = cpu;
+                nodes[n] = node;
+                n++;
+            }
+        }
+        if (c != ',') {
+            break;
+        }
+    }
+    return n;
+}
+
+int thread_engine_cpu_order(int *cpus, int *nodes) {
+    cpu_set_t allowed, added;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return 0;
+    }
+    CPU_ZERO(&added);
+
+    int n = 0;
+    for (int node = 0; node < MAX_NUMA_NODES; node++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *f = fopen(path, "r");
+        if (f == NULL) {
+            continue;
+        }
+        n = add_cpulist(f, node, &allowed, &added, cpus, nodes, n);
+        fclose(f);
+    }
+
+    // Sem informação de NUMA (ou CPUs fora dos nós listados): ordem natural
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && !CPU_ISSET(cpu, &added)) {
+            cpus[n] = cpu;
+            nodes[n] = 0;
+            n++;
+        }
+    }
+    return n;
+}
+
+static void *thread_main(void *arg) {
+    thread_slot_t *slot = arg;
+    const search_job_t *job = slot->job;
+
+    /*
+     * Contexto (e o gerador, dentro de search_job_run) na pilha da própria
+     * thread: a thread já nasce na sua CPU, então as páginas são tocadas
+     * (e alocadas) no nó local
+     */
+    search_ctx_t ctx;
+    search_init(&ctx, job, slot->id);
+
+    LOG(LOG_NORMAL, "[Worker %d] Iniciado (chunks dinâmicos)\n", slot->id);
+    if (slot->cpu >= 0) {
+        LOG(LOG_VERBOSE, "[Worker %d] CPU %d, nó NUMA %d\n", slot->id, slot->cpu, slot->node);
+    }
+
+    search_job_run(&ctx);
+
+    double total_time = progress_now() - ctx.progress.start;
+    if (log_level >= LOG_NORMAL) {
+        printf("[Worker %d] Finalizado. Total: %lld senhas em %.2f segundos",
+               slot->id, ctx.checked, total_time);
+        if (total_time > 0) {
+            printf(" (%.0f senhas/s)", ctx.checked / total_time);
+        }
+        printf("\n");
+    }
+    return NULL;
+}
+
+int thread_engine_run(const search_job_t *job, int num_threads) {
+    static int cpus[CPU_SETSIZE], nodes[CPU_SETSIZE];
+    int num_cpus = thread_engine_cpu_order(cpus, nodes);
+
+    // Com mais threads que CPUs, fixar só empilharia threads: o escalonador decide
+    int pin = num_cpus > 0 && num_threads <= num_cpus;
+    LOG(LOG_VERBOSE, "Threads: %d em %d CPUs disponíveis (%s)\n", num_threads, num_cpus,
+        pin ? "fixadas por nó NUMA" : "sem afinidade");
+
+    thread_slot_t *slots = aligned_alloc(SHARED_CACHE_LINE, num_threads * sizeof(thread_slot_t));
+    if (slots == NULL) {
+        perror("Erro ao alocar threads");
+        return -1;
+    }
+
+    int started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        thread_slot_t *slot = &slots[i];
+        slot->job = job;
+        slot->id = i;
+        slot->cpu = pin ? cpus[i] : -1;
+        slot->node = pin ? nodes[i] : -1;
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (pin) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(slot->cpu, &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+        int rc = pthread_create(&slot->tid, &attr, thread_main, slot);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            // Os chunks são dinâmicos: as threads já criadas cobrem o espaço todo
+            fprintf(stderr, "Erro ao criar thread %d: %s (seguindo com %d)\n", i, strerror(rc), started);
+            break;
+        }
+        started++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(slots[i].tid, NULL);
+    }
+    free(slots);
+    return started > 0 ? 0 : -1;
+}
@@ -0,0 +1,52 @@
+#ifndef THREAD_ENGINE_H
+#define THREAD_ENGINE_H
+
+#include "search.h"
+
+/**
+ * Motor de threads (--threads) - Mini-Projeto 1
+ *
+ * Alternativa ao modelo fork() + execl(): o laço de search.c roda num pool
+ * de pthreads dentro do próprio coordinator, sem reprocessar argv nem o
+ * hash alvo por worker. O modelo de processos continua sendo o padrão
+ * (isolamento: um worker que cai não derruba os outros).
+ *
+ * - Cada thread é fixada numa CPU (pthread_setaffinity_np); as CPUs são
+ *   ordenadas por nó NUMA (/sys/devices/system/node), então threads
+ *   consecutivas ficam no mesmo soquete
+ * - O estado de cada thread (search_ctx_t + gerador) é alocado pela própria
+ *   thread depois de fixada: pela política first-touch do kernel, as
+ *   páginas ficam no nó local
+ * - Os chunks e o resultado passam pelo mesmo shared_state_t dos processos
+ * - Também é o motor dos nós do modo distribuído (node.c), uma rodada por
+ *   intervalo recebido
+ */
+
+#define THREAD_ENGINE_MAX_THREADS SCHED_MAX_WORKERS
+
+/**
+ * Número de CPUs online (padrão de --threads com num_workers = 0)
+ */
+int thread_engine_online_cpus(void);
+
+/**
+ * Lista as CPUs permitidas ao processo, agrupadas por nó NUMA (a ordem em
+ * que as threads são fixadas; também usada pelo pool do daemon)
+ *
+ * @param cpus Saída: até CPU_SETSIZE CPUs na ordem de fixação das threads
+ * @param nodes Saída: nó NUMA de cada CPU
+ * @return Número de CPUs (0 se a afinidade não pôde ser lida)
+ */
+int thread_engine_cpu_order(int *cpus, int *nodes);
+
+/**
+ * Executa o job em num_threads threads e aguarda todas terminarem
+ *
+ * @param job Parâmetros do job (escalonador já carregado em job->shared->sched;
+ *            o resultado vai para job->shared)
+ * @param num_threads Número de threads (1..THREAD_ENGINE_MAX_THREADS)
+ * @return 0 em caso de sucesso, -1 se nenhuma thread pôde ser criada
+ */
+int thread_engine_run(const search_job_t *job, int num_threads);
+
+#endif // THREAD_ENGINE_H
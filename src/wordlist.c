@@ -0,0 +1,86 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "wordlist.h"
+
+int wordlist_open(wordlist_t *wl, const char *path) {
+    struct stat st;
+
+    memset(wl, 0, sizeof(*wl));
+    wl->fd = open(path, O_RDONLY);
+    if (wl->fd < 0) {
+        return -1;
+    }
+    if (fstat(wl->fd, &st) != 0) {
+        close(wl->fd);
+        return -1;
+    }
+
+    wl->size = st.st_size;
+    if (wl->size == 0) {
+        return 0;
+    }
+    void *data = mmap(NULL, wl->size, PROT_READ, MAP_PRIVATE, wl->fd, 0);
+    if (data == MAP_FAILED) {
+        close(wl->fd);
+        return -1;
+    }
+    // Cada worker percorre seus chunks em ordem crescente: leitura antecipada agressiva
+    madvise(data, wl->size, MADV_SEQUENTIAL);
+    wl->data = data;
+    return 0;
+}
+
+void wordlist_close(wordlist_t *wl) {
+    if (wl->data != NULL) {
+        munmap((void*)wl->data, wl->size);
+    }
+    close(wl->fd);
+    memset(wl, 0, sizeof(*wl));
+}
+
+/**
+ * Primeiro início de linha em pos ou depois dele
+ */
+static long long wordlist_line_at(const wordlist_t *wl, long long pos) {
+    if (pos <= 0) {
+        return 0;
+    }
+    if (pos >= wl->size) {
+        return wl->size;
+    }
+    if (wl->data[pos - 1] == '\n') {
+        return pos;
+    }
+    const char *nl = memchr(wl->data + pos, '\n', wl->size - pos);
+    return nl != NULL ? nl - wl->data + 1 : wl->size;
+}
+
+void wordlist_align(const wordlist_t *wl, long long start, long long end,
+                    long long *line_start, long long *line_end) {
+    *line_start = wordlist_line_at(wl, start);
+    *line_end = wordlist_line_at(wl, end);
+}
+
+int wordlist_next_batch(const wordlist_t *wl, long long *pos, long long limit,
+                        const char **words, int *lens, int max) {
+    long long p = *pos;
+    int n = 0;
+
+    while (n < max && p < limit) {
+        const char *line = wl->data + p;
+        const char *nl = memchr(line, '\n', limit - p);
+        long long len = nl != NULL ? nl - line : limit - p;
+
+        p += len + 1;
+        if (len > 0 && line[len - 1] == '\r') {
+            len--;
+        }
+        words[n] = line;
+        lens[n] = len > INT32_MAX ? INT32_MAX : (int)len;
+        n++;
+    }
+    *pos = p < limit ? p : limit;
+    return n;
+}
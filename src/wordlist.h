@@ -0,0 +1,59 @@
+#ifndef WORDLIST_H
+#define WORDLIST_H
+
+#include "hash_utils.h"
+
+/**
+ * Wordlist mapeada em memória (--wordlist) - Mini-Projeto 1
+ *
+ * O arquivo inteiro é mapeado com mmap (só leitura) em cada worker: as
+ * páginas vêm do page cache compartilhado, sem read() para buffers próprios
+ * nem cópia por linha. As palavras são entregues como ponteiros para dentro
+ * do mapeamento.
+ *
+ * O "espaço de busca" do escalonador é o intervalo de bytes [0, size): cada
+ * chunk [start, end) fica com as linhas que COMEÇAM dentro dele, então
+ * chunks vizinhos nunca repetem nem perdem uma linha, sem que o coordinator
+ * precise ler o arquivo para achar as quebras de linha.
+ */
+
+typedef struct {
+    int fd;
+    const char *data;       // Mapeamento do arquivo (NULL se vazio)
+    long long size;         // Tamanho em bytes
+} wordlist_t;
+
+/**
+ * Abre e mapeia a wordlist
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro (errno indica a causa)
+ */
+int wordlist_open(wordlist_t *wl, const char *path);
+
+/**
+ * Desfaz o mapeamento e fecha o arquivo
+ */
+void wordlist_close(wordlist_t *wl);
+
+/**
+ * Alinha um chunk de bytes às linhas: devolve o intervalo que cobre
+ * exatamente as linhas que começam em [start, end)
+ *
+ * @param line_start Saída: início da primeira linha do chunk
+ * @param line_end Saída: fim (exclusivo) da última linha, já com o '\n'
+ */
+void wordlist_align(const wordlist_t *wl, long long start, long long end,
+                    long long *line_start, long long *line_end);
+
+/**
+ * Entrega as próximas palavras (até max) a partir de *pos, sem copiar:
+ * words[i] aponta para o mapeamento e lens[i] exclui "\n" e "\r\n"
+ *
+ * @param pos Posição atual (início de linha); avança para depois da última palavra
+ * @param limit Fim do intervalo (wordlist_align)
+ * @return Número de palavras entregues (0 = intervalo esgotado)
+ */
+int wordlist_next_batch(const wordlist_t *wl, long long *pos, long long limit,
+                        const char **words, int *lens, int max);
+
+#endif // WORDLIST_H
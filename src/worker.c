@@ -4,8 +4,17 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/types.h>
-#include <time.h>
 #include "hash_utils.h"
+#include "hash_algo.h"
+#include "candidate_gen.h"
+#include "progress.h"
+#include "shared_state.h"
+#include "search.h"
+#include "keyspace.h"
+#include "wordlist.h"
+#include "rules.h"
+#include "node.h"
+#include "markov.h"
 
 /**
  * PROCESSO TRABALHADOR - Mini-Projeto 1: Quebra de Senhas Paralelo
@@ -13,70 +22,36 @@
  * Este programa verifica um subconjunto do espaço de senhas, usando a biblioteca
  * MD5 FORNECIDA para calcular hashes e comparar com o hash alvo.
  * 
- * Uso: ./worker <hash_alvo> <senha_inicial> <senha_final> <charset> <tamanho> <worker_id>
+ * Uso: ./worker <hash_alvo> <indice_inicial> <quantidade> <charset> <tamanho> <worker_id> [opções]
+ * 
+ * Opções: --shm-fd=N (região compartilhada criada pelo coordinator),
+ * --max-len=M (comprimentos <tamanho>..M num espaço só, ver keyspace.h),
+ * --mask=MASCARA e --charset1=..--charset4= (máscara no lugar do <charset>,
+ * que é ignorado), --wordlist=ARQUIVO e --rules=ARQUIVO (modo wordlist: o
+ * intervalo é de bytes do arquivo e <tamanho>..--max-len filtra os
+ * candidatos), --markov=MODELO (ordem por probabilidade, ver markov.h),
+ * --hash-spec=FORMATO (alvos com sal, "hash:sal", ver hash_utils.h),
+ * --algo=ALGORITMO (md5, md4, ntlm, sha1 ou sha256, ver hash_algo.h),
+ * --trace=ARQUIVO e --perf (instrumentação, ver instrument.h)
+ * e -q|-v|--trace-candidates. Sem --shm-fd (execução manual), o resultado é
+ * gravado direto em password_found.txt. Com <hash_alvo> = "-" (--hash-file
+ * no coordinator), os alvos são os digests gravados na região compartilhada.
+ * 
+ * ./worker --listen <porta> [-q|-v] roda o worker como nó do modo
+ * distribuído (coordinator --nodes, ver node.h): um daemon que recebe o job
+ * e os intervalos por TCP e os percorre com threads.
+ * 
+ * Com --shm-fd, o worker retira chunks do escalonador dinâmico na região
+ * compartilhada (o intervalo da linha de comando é o do job inteiro, já
+ * carregado pelo coordinator). Na execução manual, o intervalo dado pelos
+ * índices numéricos (mesma numeração de keyspace_password) é percorrido
+ * sozinho. O laço de busca fica em search.c (o mesmo das threads).
  * 
  * EXECUTADO AUTOMATICAMENTE pelo coordinator através de fork() + execl()
  * SEU TRABALHO: Implementar os TODOs de busca e comunicação
  */
 
 #define RESULT_FILE "password_found.txt"
-#define PROGRESS_INTERVAL 100000  // Reportar progresso a cada N senhas
-
-/**
- * Incrementa uma senha para a próxima na ordem lexicográfica (aaa -> aab -> aac...)
- * 
- * @param password Senha atual (será modificada)
- * @param charset Conjunto de caracteres permitidos
- * @param charset_len Tamanho do conjunto
- * @param password_len Comprimento da senha
- * @return 1 se incrementou com sucesso, 0 se chegou ao limite (overflow)
- */
-
-
-//funcao auxiliar
-int find_index(char c, const char *charset, int charset_len) {
-    for (int i = 0; i < charset_len; i++) {
-        if (charset[i] == c) {
-            return i;
-        }
-    }
-    return -1;
-}
-
-int increment_password(char *password, const char *charset, int charset_len, int password_len) {
-    for (int i = password_len - 1; i >= 0; i--) {
-        int index = find_index(password[i], charset, charset_len);
-        if (index == -1) return 0; 
-        index++;
-        if (index < charset_len) {
-            password[i] = charset[index];
-            for (int j = i + 1; j < password_len; j++) {
-                password[j] = charset[0];
-            }
-            return 1;
-        } else {
-            password[i] = charset[0];
-        }
-    }
-    return 0;
-}
-
-/**
- * Compara duas senhas lexicograficamente
- * 
- * @return -1 se a < b, 0 se a == b, 1 se a > b
- */
-int password_compare(const char *a, const char *b) {
-    return strcmp(a, b);
-}
-
-/**
- * Verifica se o arquivo de resultado já existe
- * Usado para parada antecipada se outro worker já encontrou a senha
- */
-int check_result_exists() {
-    return access(RESULT_FILE, F_OK) == 0;
-}
 
 /**
  * Salva a senha encontrada no arquivo de resultado
@@ -109,83 +84,223 @@ void save_result(int worker_id, const char *password) {
  * Função principal do worker
  */
 int main(int argc, char *argv[]) {
+    // Início do processo, para a instrumentação (exec + preparação até o primeiro chunk)
+    double main_start = progress_now();
+
+    // Modo nó (daemon TCP): só a porta e a verbosidade
+    if (argc >= 3 && strcmp(argv[1], "--listen") == 0) {
+        for (int i = 3; i < argc; i++) {
+            if (!log_parse_option(argv[i])) {
+                fprintf(stderr, "Uso: %s --listen <porta> [-q|-v]\n", argv[0]);
+                return 1;
+            }
+        }
+        int port = atoi(argv[2]);
+        if (port < 1 || port > 65535) {
+            fprintf(stderr, "Porta inválida: %s\n", argv[2]);
+            return 1;
+        }
+        return node_serve(port);
+    }
 
 
-    // Validar argumentos
-    if (argc != 7) {
-        fprintf(stderr, "Uso interno: %s <hash> <start> <end> <charset> <len> <id>\n", argv[0]);
+    // Validar argumentos (opções, se houver, vêm depois dos posicionais)
+    int shm_fd = -1;
+    int max_len = 0;
+    const char *mask = NULL;
+    const char *wordlist_path = NULL;
+    const char *rules_path = NULL;
+    const char *trace_path = NULL;
+    const char *markov_path = NULL;
+    const char *hash_spec = NULL;
+    const char *algo_name = NULL;
+    int perf = 0;
+    const char *custom[KEYSPACE_CUSTOM_CHARSETS] = {NULL};
+    int bad_option = 0;
+    for (int i = 7; i < argc; i++) {
+        if (strncmp(argv[i], "--shm-fd=", 9) == 0) {
+            shm_fd = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--max-len=", 10) == 0) {
+            max_len = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--wordlist=", 11) == 0) {
+            wordlist_path = argv[i] + 11;
+        } else if (strncmp(argv[i], "--rules=", 8) == 0) {
+            rules_path = argv[i] + 8;
+        } else if (strncmp(argv[i], "--mask=", 7) == 0) {
+            mask = argv[i] + 7;
+        } else if (strncmp(argv[i], "--markov=", 9) == 0) {
+            markov_path = argv[i] + 9;
+        } else if (strncmp(argv[i], "--hash-spec=", 12) == 0) {
+            hash_spec = argv[i] + 12;
+        } else if (strncmp(argv[i], "--algo=", 7) == 0) {
+            algo_name = argv[i] + 7;
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            trace_path = argv[i] + 8;
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            perf = 1;
+        } else if (strncmp(argv[i], "--charset", 9) == 0 && argv[i][9] >= '1' &&
+                   argv[i][9] < '1' + KEYSPACE_CUSTOM_CHARSETS && argv[i][10] == '=') {
+            custom[argv[i][9] - '1'] = argv[i] + 11;
+        } else if (!log_parse_option(argv[i])) {
+            bad_option = 1;
+        }
+    }
+    int spec = hash_spec != NULL ? md5_spec_parse(hash_spec) : MD5_SPEC_PLAIN;
+    int algo = algo_name != NULL ? hash_algo_parse(algo_name) : HASH_MD5;
+    if (argc < 7 || bad_option || spec < 0 || algo < 0 || (algo != HASH_MD5 && spec != MD5_SPEC_PLAIN)) {
+        fprintf(stderr, "Uso interno: %s <hash> <start_index> <count> <charset> <len> <id> [--shm-fd=N] [--max-len=M] [--mask=M [--charsetN=C]] [--wordlist=W [--rules=R]] [--markov=M] [--hash-spec=F] [--algo=A] [--trace=T] [--perf] [-q|-v|--trace-candidates]\n", argv[0]);
+        return 1;
+    }
+    
+    // Execução manual (sem coordinator): região própria, ninguém mais a sinaliza
+    // (o escalonador é carregado mais abaixo, depois de validar o intervalo)
+    int standalone = shm_fd < 0;
+    shared_state_t *shared = standalone ? shared_state_create(1, &shm_fd) : shared_state_attach(shm_fd);
+    if (shared == NULL) {
+        perror("Erro ao mapear estado compartilhado");
         return 1;
     }
     
     // Parse dos argumentos
     const char *target_hash = argv[1];
-    char *start_password = argv[2];
-    const char *end_password = argv[3];
+    keyspace_index_t start_index = -1;      // Índice de 128 bits (base da execução)
+    keyspace_index_parse(argv[2], &start_index);
+    long long count = atoll(argv[3]);
     const char *charset = argv[4];
     int password_len = atoi(argv[5]);
     int worker_id = atoi(argv[6]);
     int charset_len = strlen(charset);
     
-    printf("[Worker %d] Iniciado: %s até %s\n", worker_id, start_password, end_password);
-    
-    // Buffer para a senha atual
-    char current_password[11];
-    strcpy(current_password, start_password);
-    
-    // Buffer para o hash calculado
-    char computed_hash[33];
-    
-    // Contadores para estatísticas
-    long long passwords_checked = 0;
-    time_t start_time = time(NULL);
-    time_t last_progress_time = start_time;
-    
-    // Loop principal de verificação
-    while (1) {
-        // TODO 3: Verificar periodicamente se outro worker já encontrou a senha
-        // DICA: A cada PROGRESS_INTERVAL senhas, verificar se arquivo resultado existe
-        if (passwords_checked % PROGRESS_INTERVAL == 0) {
-            if (check_result_exists()) {
-                break;
-            }
+    // Espaço combinado dos comprimentos password_len..max_len (o mesmo do coordinator),
+    // ou os bytes da wordlist mapeada
+    static keyspace_t keyspace;
+    wordlist_t wordlist;
+    rule_set_t rules;
+    keyspace_index_t space;
+    if (max_len == 0) {
+        max_len = password_len;
+    }
+    if (wordlist_path != NULL) {
+        if (wordlist_open(&wordlist, wordlist_path) != 0) {
+            perror(wordlist_path);
+            return 1;
         }
-        // TODO 4: Calcular o hash MD5 da senha atual
-        // IMPORTANTE: Use a biblioteca MD5 FORNECIDA - md5_string(senha, hash_buffer)
-        printf("[Worker %d]testando senha:%s\n", worker_id, current_password);
-        md5_string(current_password, computed_hash);
-        // TODO 5: Comparar com o hash alvo
-        // Se encontrou: salvar resultado e terminar
-        if (strcmp(computed_hash, target_hash) == 0) {
-        printf("[Worker %d] SENHA ENCONTRADA: %s\n", worker_id, current_password);
-        save_result(worker_id, current_password);
-        break;
+        // (as regras inválidas já foram avisadas pelo coordinator)
+        if (rule_set_load(&rules, rules_path, standalone) < 1) {
+            fprintf(stderr, "[Worker %d] Nenhuma regra válida em %s\n", worker_id, rules_path);
+            return 1;
         }
-        
-        // TODO: Verificar se chegou ao fim do intervalo
-        // Se sim: terminar loop
-        if (password_compare(current_password, end_password) >= 0) {
-            break;
+        space = wordlist.size;
+    } else {
+        int ks_status = mask != NULL
+            ? keyspace_init_mask(&keyspace, mask, custom, password_len, max_len)
+            : keyspace_init(&keyspace, charset, charset_len, password_len, max_len);
+        space = ks_status == 0 ? keyspace.total : 0;
+        // Mesma ordem do coordinator: o modelo já foi validado por ele
+        if (ks_status == 0 && markov_path != NULL) {
+            static markov_model_t model;
+            if (markov_load(&model, markov_path) != 0 || markov_apply(&model, &keyspace) != 0) {
+                fprintf(stderr, "[Worker %d] Modelo Markov inválido: %s\n", worker_id, markov_path);
+                return 1;
+            }
         }
-        // TODO 6: Incrementar para a próxima senha
-        // DICA: Use a função increment_password implementada acima
-        if (!increment_password(current_password, charset, charset_len, password_len)) {
-            break;
+    }
+    if (password_len < 1 || max_len < password_len || max_len > hash_algo_get(algo)->max_len ||
+        start_index < 0 || start_index > space || count < (standalone ? 1 : 0) ||
+        count > keyspace_window(space, start_index)) {
+        fprintf(stderr, "[Worker %d] Intervalo inválido\n", worker_id);
+        return 1;
+    }
+    // Posições do escalonador contadas a partir de start_index (job.base)
+    if (standalone) {
+        scheduler_init(&shared->sched, 0, count, 1);
+    }
+    
+    if (wordlist_path != NULL) {
+        LOG(LOG_NORMAL, "[Worker %d] Iniciado: %s, byte %lld + %lld bytes, %d regras (chunks dinâmicos)\n",
+            worker_id, wordlist_path, (long long)start_index, count, rules.count);
+    } else if (count > 0) {
+        char first_password[MD5_SINGLE_BLOCK_MAX + 1];
+        keyspace_password(&keyspace, start_index, first_password);
+        LOG(LOG_NORMAL, "[Worker %d] Iniciado: %s + %lld senhas (chunks dinâmicos)\n",
+            worker_id, first_password, count);
+    }
+    
+    // O alvo é decodificado para binário uma única vez (e revertido por comprimento)
+    static search_job_t job;
+    md5_target_t target;
+    md5_target_t *targets = &target;
+    int num_targets = 1;
+    int multi = strcmp(target_hash, "-") == 0 && !standalone;
+    if (multi) {
+        // Vários alvos: digests (e sais) já decodificados pelo coordinator
+        num_targets = shared->num_targets;
+        targets = malloc(num_targets * sizeof(md5_target_t));
+        if (targets == NULL) {
+            perror("Erro ao alocar alvos");
+            return 1;
         }
-        
-        
-        passwords_checked++;
+        for (int i = 0; i < num_targets; i++) {
+            shared_state_get_target(shared, i, algo, &targets[i]);
+        }
+    } else if ((spec != MD5_SPEC_PLAIN ? md5_target_parse_salted(target_hash, &target)
+                                       : hash_target_parse(algo, target_hash, &target)) != 0 ||
+               max_len > md5_spec_max_len(spec, target.salt_len)) {
+        fprintf(stderr, "[Worker %d] Hash alvo inválido: %s (nenhuma senha pode corresponder)\n",
+                worker_id, target_hash);
+        return 0;
+    }
+    if (search_job_prepare(&job, password_len, max_len, targets, num_targets, multi, algo, spec,
+                           shared) != 0) {
+        perror("Erro ao montar conjunto de alvos");
+        return 1;
+    }
+    if (wordlist_path != NULL) {
+        job.wordlist = &wordlist;
+        job.rules = &rules;
+    } else {
+        job.keyspace = &keyspace;
+    }
+    job.trace_path = trace_path;
+    job.perf = perf;
+    job.base = start_index;
+    if (multi) {
+        free(targets);
+    }
+    
+    // TODO 3/4/6: laço de busca com parada antecipada (search.c)
+    static search_ctx_t ctx;
+    search_init(&ctx, &job, worker_id);
+    ctx.origin = main_start;
+    LOG(LOG_VERBOSE, "[Worker %d] Modo %s, kernel %s\n", worker_id,
+        wordlist_path != NULL ? "wordlist" :
+        algo == HASH_MD5 && keyspace.radix[max_len - 1] >= md5_kernel_lanes() ? "incremental" : "em lote",
+        md5_kernel_name());
+    search_job_run(&ctx);
+    search_job_free(&job);
+    if (wordlist_path != NULL) {
+        rule_set_free(&rules);
+        wordlist_close(&wordlist);
+    }
+    
+    // TODO 5: Se encontrou: salvar resultado e terminar
+    // (a senha já foi publicada na região compartilhada; o arquivo é só da execução manual)
+    if (standalone && atomic_load(&shared->cracks[0].ready)) {
+        save_result(worker_id, shared->cracks[0].password);
     }
     
     // Estatísticas finais
-    time_t end_time = time(NULL);
-    double total_time = difftime(end_time, start_time);
+    long long passwords_checked = ctx.checked;
+    double total_time = progress_now() - ctx.progress.start;
     
-    printf("[Worker %d] Finalizado. Total: %lld senhas em %.2f segundos", 
-           worker_id, passwords_checked, total_time);
-    if (total_time > 0) {
-        printf(" (%.0f senhas/s)", passwords_checked / total_time);
+    if (log_level >= LOG_NORMAL) {
+        printf("[Worker %d] Finalizado. Total: %lld senhas em %.2f segundos", 
+               worker_id, passwords_checked, total_time);
+        if (total_time > 0) {
+            printf(" (%.0f senhas/s)", passwords_checked / total_time);
+        }
+        printf("\n");
     }
-    printf("\n");
     
     return 0;
 }
\ No newline at end of file